@@ -0,0 +1,148 @@
+#include <traza.h>
+#include <eventos_aplicacion.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Decodificador de la traza de eventos (lib/maquina_estado/traza.h),
+ * para la PC. Convierte un volcado binario de la estructura Traza en
+ * una línea de tiempo, del registro más antiguo al más reciente.
+ *
+ * Compilación:
+ *   gcc -Iinclude -Ilib/maquina_estado herramientas/decodifica_traza.c -o decodifica_traza
+ *
+ * Uso: decodifica_traza volcado.bin [simbolos.txt]
+ *
+ * simbolos.txt es la salida de "nm" del programa que generó la traza
+ * (firmware.elf o el simulador). Con ella las máquinas y los estados se
+ * muestran por nombre; sin ella, por los 16 bits bajos de su dirección.
+ */
+
+typedef struct Simbolo{
+    uint16_t direccion;
+    char nombre[64];
+    char tipo;
+}Simbolo;
+
+static Simbolo *simbolos;
+static size_t numSimbolos;
+
+/**
+ * @brief Diferencia entre las direcciones en ejecución y las de la
+ * tabla de símbolos (no nula en un simulador PIE)
+ */
+static uint16_t desplazamiento;
+
+static void cargaSimbolos(char const *archivo){
+    FILE *const f = fopen(archivo,"r");
+    if (!f){
+        perror(archivo);
+        exit(EXIT_FAILURE);
+    }
+    char linea[256];
+    size_t capacidad = 0;
+    while (fgets(linea,sizeof(linea),f)){
+        unsigned long long direccion;
+        char tipo;
+        char nombre[64];
+        if (sscanf(linea,"%llx %c %63s",&direccion,&tipo,nombre) != 3) continue;
+        if (numSimbolos == capacidad){
+            capacidad = capacidad ? 2*capacidad : 256;
+            simbolos = realloc(simbolos,capacidad*sizeof(*simbolos));
+            if (!simbolos){
+                perror("realloc");
+                exit(EXIT_FAILURE);
+            }
+        }
+        Simbolo *const s = simbolos + numSimbolos++;
+        s->direccion = (uint16_t)direccion;
+        s->tipo = tipo;
+        strcpy(s->nombre,nombre);
+    }
+    fclose(f);
+}
+
+/**
+ * @brief Nombre del símbolo cuyos 16 bits bajos de dirección coinciden.
+ * En Thumb las direcciones de función tienen el bit 0 en 1
+ */
+static char const *nombre(uint16_t direccion, char const *tipos, char *respaldo, size_t tamano){
+    uint16_t const reubicada = (uint16_t)(direccion - desplazamiento);
+    uint16_t const buscada = strchr(tipos,'t') ? (uint16_t)(reubicada & ~1U) : reubicada;
+    for (size_t i=0;i<numSimbolos;++i){
+        if (simbolos[i].direccion == buscada && strchr(tipos,simbolos[i].tipo)) return simbolos[i].nombre;
+    }
+    snprintf(respaldo,tamano,"0x%04x",direccion);
+    return respaldo;
+}
+
+static char const *const nombresEvento[] = {
+    [EV_NULO] = "EV_NULO",
+    [EV_RESET] = "EV_RESET",
+    [EV_BOTON_PULSADO] = "EV_BOTON_PULSADO",
+    [EV_TRIPLE_PULSACION] = "EV_TRIPLE_PULSACION",
+    [EV_TIMEOUT] = "EV_TIMEOUT",
+};
+
+static void imprimeEvento(unsigned evento){
+    size_t const n = sizeof(nombresEvento)/sizeof(nombresEvento[0]);
+    if (evento < n && nombresEvento[evento]) printf("%-20s",nombresEvento[evento]);
+    else printf("%-20u",evento);
+}
+
+int main(int argc, char *argv[]){
+    if (argc < 2 || argc > 3){
+        fprintf(stderr,"Uso: %s volcado.bin [simbolos.txt]\n",argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (argc == 3) cargaSimbolos(argv[2]);
+    FILE *const f = fopen(argv[1],"rb");
+    if (!f){
+        perror(argv[1]);
+        return EXIT_FAILURE;
+    }
+    Traza cabecera;
+    size_t const tamCabecera = offsetof(Traza,registros);
+    if (fread(&cabecera,1,tamCabecera,f) != tamCabecera || cabecera.firma != TRAZA_FIRMA || !cabecera.capacidad){
+        fprintf(stderr,"%s: no es un volcado de traza\n",argv[1]);
+        return EXIT_FAILURE;
+    }
+    RegistroTraza *const registros = calloc(cabecera.capacidad,sizeof(RegistroTraza));
+    if (!registros || fread(registros,sizeof(RegistroTraza),cabecera.capacidad,f) != cabecera.capacidad){
+        fprintf(stderr,"%s: volcado incompleto\n",argv[1]);
+        return EXIT_FAILURE;
+    }
+    fclose(f);
+    for (size_t i=0;i<numSimbolos;++i){
+        if (!strcmp(simbolos[i].nombre,"Traza_registra")){
+            desplazamiento = (uint16_t)((cabecera.referencia & ~1U) - simbolos[i].direccion);
+        }
+    }
+
+    uint32_t const total = cabecera.escrituras;
+    uint32_t const primero = total > cabecera.capacidad ? total - cabecera.capacidad : 0;
+    if (primero) printf("(%lu registros anteriores sobrescritos)\n",(unsigned long)primero);
+    printf("%10s  %-9s %-24s %-20s %s\n","ms","tipo","maquina","evento","estado");
+    uint32_t descartes = 0;
+    for (uint32_t i=primero;i!=total;++i){
+        RegistroTraza const *const r = registros + i % cabecera.capacidad;
+        char m[16],a[16],b[16];
+        static char const *const tipos[] = {[TRAZA_DESPACHO] = "despacho",[TRAZA_DESCARTE] = "DESCARTE",[TRAZA_PROCESO] = "proceso"};
+        printf("%10lu  %-9s %-24s ",(unsigned long)r->tiempo,r->tipo <= TRAZA_PROCESO ? tipos[r->tipo] : "?",
+               nombre(r->maquina,"bBdDsS",m,sizeof(m)));
+        imprimeEvento(r->evento);
+        if (r->tipo == TRAZA_PROCESO){
+            char const *const anterior = nombre(r->estadoAnterior,"tT",a,sizeof(a));
+            if (r->estadoAnterior == r->estadoNuevo) printf(" %s",anterior);
+            else printf(" %s -> %s",anterior,nombre(r->estadoNuevo,"tT",b,sizeof(b)));
+        }
+        if (r->tipo == TRAZA_DESCARTE) ++descartes;
+        printf("\n");
+    }
+    printf("%lu registros, %lu descartes\n",(unsigned long)(total - primero),(unsigned long)descartes);
+    free(registros);
+    free(simbolos);
+    return EXIT_SUCCESS;
+}
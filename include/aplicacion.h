@@ -0,0 +1,73 @@
+#ifndef APLICACION_H
+#define APLICACION_H
+#include <stdbool.h>
+#include <soporte_placa.h>
+
+#define PIN_LUZ SP_PIN_LED
+#define PIN_PULSADOR SP_PB9
+
+#define HISTERESIS_ANTIRREBOTE 5
+
+#define LUZ_ON 0
+
+#define PULSADOR_NIVEL_ACTIVO 0
+
+#define TIEMPO_ON 60000
+
+#define TIEMPO_TRIPLE_PULSACION 1000
+
+/**
+ * @brief Prioridades de las máquinas de estado en el planificador
+ * (mayor número, mayor prioridad)
+ */
+#define PRIORIDAD_CONTROLADOR_LUZ 2
+#define PRIORIDAD_CONTROLADOR_PULSACIONES 1
+
+/**
+ * @brief Con APLICACION_EXPROPIATIVA distinto de cero una máquina de
+ * estado de mayor prioridad expropia a las de menor prioridad en
+ * cuanto recibe un evento (planificador en modo expropiativo, con
+ * PendSV), en lugar de esperar a que terminen
+ */
+#ifndef APLICACION_EXPROPIATIVA
+#define APLICACION_EXPROPIATIVA 0
+#endif
+
+/**
+ * @brief Con APLICACION_REPOSO distinto de cero el lazo principal
+ * duerme entre eventos (ver Aplicacion_tiempoHastaProximoEvento) en
+ * lugar de consultar continuamente las máquinas de estado
+ */
+#ifndef APLICACION_REPOSO
+#define APLICACION_REPOSO 1
+#endif
+
+/**
+ * @brief Inicializa la placa y los objetos del controlador de
+ * luz de escalera
+ * 
+ */
+void Aplicacion_init(void);
+
+/**
+ * @brief Ejecuta una pasada del lazo principal: procesa los
+ * despachos retardados y el pulsador y luego todos los eventos en
+ * cola, por orden de prioridad de las máquinas de estado
+ * 
+ * @return true Alguna máquina procesó un evento
+ * @return false No había eventos pendientes
+ */
+bool Aplicacion_procesa(void);
+
+/**
+ * @brief Calcula cuánto puede dormir el CPU antes de que el lazo
+ * principal tenga trabajo: eventos en cola, el próximo despacho
+ * retardado o la próxima lectura del antirrebote del pulsador
+ * 
+ * @return uint32_t Milisegundos hasta el próximo evento (0 si hay
+ * eventos pendientes) o SP_TIEMPO_INDEFINIDO si solo una interrupción
+ * puede generar trabajo
+ */
+uint32_t Aplicacion_tiempoHastaProximoEvento(void);
+
+#endif
@@ -12,10 +12,20 @@
  * Intermediario entre el pulsador y el controlador de luz
  * 
  */
+/**
+ * @brief Capacidad de la cola de eventos del controlador (potencia
+ * de 2)
+ */
+#ifndef CONTROLADOR_DE_PULSACIONES_CAPACIDAD_COLA
+#define CONTROLADOR_DE_PULSACIONES_CAPACIDAD_COLA 4
+#endif
+
 typedef struct ControladorDePulsaciones {
     Maquina maquina;
+    LugarCola cola[CONTROLADOR_DE_PULSACIONES_CAPACIDAD_COLA];
     Maquina *destino;
     DespachoRetardado *despachoRetardado;
+    DespachoRetardado_HDespacho hTimeout;
     uint32_t tiempoPulsaciones;
     uint32_t contadorPulsaciones;
 }ControladorDePulsaciones;
@@ -25,9 +35,10 @@ typedef struct ControladorDePulsaciones {
  * @brief Inicializador del controlador de pulsaciones
  * 
  * [*] --> ESPERA               : EV_RESET / *
- * ESPERA --> CUENTA            : EV_BOTON_PULSADO / Maquina_despacha(controlador_luz,EV_BOTON_PULSADO); cnt = 1;
+ * ESPERA --> CUENTA            : EV_BOTON_PULSADO / Maquina_despacha(controlador_luz,EV_BOTON_PULSADO); setTimeout(tiempoPulsaciones); cnt = 1;
  * CUENTA --> CUENTA            : EV_BOTON_PULSADO [cnt < 3] / cnt++;
- * CUENTA --> ESPERA            : EV_BOTON_PULSADO [cnt >= 3] / Maquina_despacha(controlador_luz,EV_TRIPLE_PULSACION); 
+ * CUENTA --> ESPERA            : EV_BOTON_PULSADO [cnt >= 3] / Maquina_despacha(controlador_luz,EV_TRIPLE_PULSACION); cancelaTimeout();
+ * CUENTA --> ESPERA            : EV_TIMEOUT / *
  * 
  * @param self     Puntero al controlador de pulsaciones
  * @param contador  Contador de pulsaciones
@@ -3,20 +3,47 @@
 #include <stdint.h>
 #include <soporte_placa.h>
 #include <maquina_estado.h>
+#include <maquina_tabla.h>
+#include <maquina_jerarquica.h>
 #include "despacho_retardado.h"
 #include "eventos_aplicacion.h"
 #include "controlador_de_pulsaciones.h"
 
 
 
+/**
+ * @brief Implementación del controlador
+ *
+ * 1: Máquina de estado por tabla (MaquinaTabla, controlador_luz_tabla.c)
+ * 0: Máquina de estado jerárquica (MaquinaJerarquica, controlador_luz.c)
+ */
+#ifndef CONTROLADOR_LUZ_TABLA
+#define CONTROLADOR_LUZ_TABLA 1
+#endif
+
+/**
+ * @brief Capacidad de la cola de eventos del controlador (potencia
+ * de 2): recibe a lo sumo una pulsación, una triple pulsación y un
+ * timeout entre dos procesamientos
+ */
+#ifndef CONTROLADOR_LUZ_CAPACIDAD_COLA
+#define CONTROLADOR_LUZ_CAPACIDAD_COLA 4
+#endif
+
 /**
  * @brief Controlador de luz de escalera
  * 
  */
 typedef struct ControladorLuz{
-    Maquina maquina;
+#if CONTROLADOR_LUZ_TABLA
+    MaquinaTabla maquina;
+#else
+    MaquinaJerarquica maquina;
+#endif
+    LugarCola cola[CONTROLADOR_LUZ_CAPACIDAD_COLA];
     uint32_t tiempoOn;
     DespachoRetardado *despachoRetardado;
+    DespachoRetardado_HDespacho hTimeout;
     struct{
         SP_HPin pin;
         bool nivelOn;
@@ -30,7 +57,7 @@ typedef struct ControladorLuz{
  *  [*] --> APAGADO       : EV_RESET/ luzOff();
  *  APAGADO --> ENCENDIDO : EV_BOTON_PULSADO / luzOn(); setTimeout(tiempoOn); 
  *  ENCENDIDO --> APAGADO : EV_TIMEOUT / luzOff();
- *  ENCENDIDO --> MUDANZA : EV_TRIPLE_PULSACION / *
+ *  ENCENDIDO --> MUDANZA : EV_TRIPLE_PULSACION / cancelaTimeout();
  *  MUDANZA --> APAGADO   : EV_TRIPLE_PULSACION / luzOff();
  * 
  * @param self Nueva instancia de controlador
@@ -8,51 +8,178 @@
 #define MAX_DESPACHOS_RETARDADOS_ACTIVOS 4
 #endif
 
+/**
+ * @brief Motor de la lista de despachos en espera
+ *
+ * 1: Montículo (min-heap) de vencimientos absolutos con índice hash
+ *    por (destino, evento). Cada procesamiento consulta solo la cima;
+ *    programar y cancelar cuestan O(log n).
+ * 0: Arreglo de cuentas regresivas. Cada procesamiento recorre todos
+ *    los despachos y programar busca duplicados en forma lineal.
+ */
+#ifndef DESPACHO_RETARDADO_MONTICULO
+#define DESPACHO_RETARDADO_MONTICULO 1
+#endif
+
+/**
+ * @brief Handle que identifica un despacho programado. Deja de ser
+ * válido cuando el evento es despachado o el despacho es cancelado
+ */
+typedef uint32_t DespachoRetardado_HDespacho;
+
+/**
+ * @brief Handle que no corresponde a ningún despacho
+ */
+#define DESPACHO_RETARDADO_HANDLE_NULO ((DespachoRetardado_HDespacho)0)
+
+#if DESPACHO_RETARDADO_MONTICULO
+
+#if MAX_DESPACHOS_RETARDADOS_ACTIVOS > 0xFFFF
+#error MAX_DESPACHOS_RETARDADOS_ACTIVOS debe ser menor a 65536
+#endif
+
+/**
+ * @brief Número de cubetas del índice hash: una potencia de
+ * dos mayor o igual a la capacidad
+ */
+#define DESPACHO_RETARDADO_CUBETAS_(n) ((n) <= 4 ? 4 : (n) <= 16 ? 16 : (n) <= 64 ? 64 : (n) <= 256 ? 256 : (n) <= 1024 ? 1024 : (n) <= 4096 ? 4096 : 65536)
+#define DESPACHO_RETARDADO_CUBETAS DESPACHO_RETARDADO_CUBETAS_(MAX_DESPACHOS_RETARDADOS_ACTIVOS)
+
 /**
  * @brief Máquina de estado de control que maneja
  * una lista de despacho retardado. Permite programar
  * el envío de un evento luego de un retardo dado
- * 
+ *
  */
-typedef struct DespachoRetardado{               //Un "DespachoRetardado" contiene: 
+typedef struct DespachoRetardado{
+    struct DespachoEnEspera{                        //Despachos en espera (nodos del montículo)
+        Maquina *destino;                               //Maquina donde se realizara
+        Evento evento;                                  //Evento que se despachara
+        uint32_t vencimiento;                           //Instante (SP_Tiempo_getMilisegundos) del despacho
+        uint16_t posicion;                              //Posición del nodo en el montículo
+        uint16_t siguiente;                             //Siguiente nodo de la cubeta hash o de la lista libre
+        uint16_t generacion;                            //Cambia cada vez que el nodo se libera (invalida handles)
+    }despachosEnEspera[MAX_DESPACHOS_RETARDADOS_ACTIVOS];
+    uint16_t monticulo[MAX_DESPACHOS_RETARDADOS_ACTIVOS];  //Índices de nodos ordenados por vencimiento (cima = próximo)
+    uint16_t cubetas[DESPACHO_RETARDADO_CUBETAS];   //Primer nodo de cada cubeta del índice (destino, evento)
+    uint16_t libres;                                //Primer nodo de la lista libre
+    size_t numDespachosEnEspera;                    //El numero de despachos en espera dentro del montículo
+}DespachoRetardado;
+
+#else
+
+/**
+ * @brief Máquina de estado de control que maneja
+ * una lista de despacho retardado. Permite programar
+ * el envío de un evento luego de un retardo dado
+ *
+ */
+typedef struct DespachoRetardado{               //Un "DespachoRetardado" contiene:
     uint32_t t0;                                    //Tiempo de espera para realizar un despacho
     struct DespachoEnEspera{                        //Un areglo de despachos en espera (4 disponibles)
         Maquina *destino;                                           //Maquina donde se realizara
         Evento evento;                                              //Evento que se despachara
         uint32_t cuenta;                                            //Cuenta que realiza antes de despachar
+        DespachoRetardado_HDespacho handle;                         //Identificador del despacho
     }despachosEnEspera[MAX_DESPACHOS_RETARDADOS_ACTIVOS];
     size_t numDespachosEnEspera;                    //El numero de despachos en espera dentro el arreglo
+    DespachoRetardado_HDespacho ultimoHandle;       //Último handle asignado
 }DespachoRetardado;
 
+#endif
+
 /**
  * @brief Inicializa una instancia de controlador de despacho
  * retardado.
- * 
+ *
  * @param self Puntero a DespachoRetardado
  */
 void DespachoRetardado_init(DespachoRetardado *self);
 
 /**
  * @brief Programa el despacho retardado de un evento luego
- * de transcurrido el tiempo indicado.
+ * de transcurrido el tiempo indicado. Si el mismo evento ya
+ * estaba programado para el mismo destino se reprograma.
  * Si los recursos están agotados despacha el evento
  * inmediatamente. Esta función no bloquea.
- * 
+ *
  * @param self Puntero a DespachoRetardado
  * @param destino Puntero a Maquina de destino
  * @param evento Evento a ejecutar luego del tiempo
  * @param tiempoMilisegundos Tiempo tras el cual efectuar el
- * despacho 
+ * despacho
  */
 void DespachoRetardado_programarDespacho(DespachoRetardado *self, Maquina *const destino, Evento const evento, uint32_t const tiempoMilisegundos);
 
+/**
+ * @brief Igual que DespachoRetardado_programarDespacho, pero devuelve
+ * un handle para cancelar o reprogramar el despacho
+ *
+ * @param self Puntero a DespachoRetardado
+ * @param destino Puntero a Maquina de destino
+ * @param evento Evento a ejecutar luego del tiempo
+ * @param tiempoMilisegundos Tiempo tras el cual efectuar el
+ * despacho
+ * @return DespachoRetardado_HDespacho Handle del despacho, o
+ * DESPACHO_RETARDADO_HANDLE_NULO si los recursos estaban agotados
+ * y el evento fue despachado inmediatamente
+ */
+DespachoRetardado_HDespacho DespachoRetardado_programar(DespachoRetardado *self, Maquina *const destino, Evento const evento, uint32_t const tiempoMilisegundos);
+
+/**
+ * @brief Reinicia la cuenta de un despacho programado: el evento se
+ * despachará luego del tiempo indicado, contado desde ahora
+ *
+ * @param self Puntero a DespachoRetardado
+ * @param hDespacho Handle obtenido con DespachoRetardado_programar
+ * @param tiempoMilisegundos Nuevo tiempo tras el cual efectuar el
+ * despacho
+ * @return true Despacho reprogramado
+ * @return false El handle ya no es válido (el evento fue despachado
+ * o cancelado)
+ */
+bool DespachoRetardado_reprogramar(DespachoRetardado *self, DespachoRetardado_HDespacho hDespacho, uint32_t const tiempoMilisegundos);
+
+/**
+ * @brief Cancela un despacho programado a partir de su handle
+ *
+ * @param self Puntero a DespachoRetardado
+ * @param hDespacho Handle obtenido con DespachoRetardado_programar
+ * @return true Despacho cancelado
+ * @return false El handle ya no es válido (el evento fue despachado
+ * o cancelado)
+ */
+bool DespachoRetardado_cancelarDespacho(DespachoRetardado *self, DespachoRetardado_HDespacho hDespacho);
+
+/**
+ * @brief Cancela el despacho programado de un evento a un destino
+ *
+ * @param self Puntero a DespachoRetardado
+ * @param destino Puntero a Maquina de destino
+ * @param evento Evento programado
+ * @return true Despacho cancelado
+ * @return false No había un despacho programado para ese evento y destino
+ */
+bool DespachoRetardado_cancelar(DespachoRetardado *self, Maquina *const destino, Evento const evento);
+
 /**
  * @brief Actualiza el estado de los despachos retardados en
  * curso. Despacha los eventos cuyo tiempo ha caducado.
  * Esta función no bloquea.
- * 
+ *
  * @param self Este objeto
  */
 void DespachoRetardado_procesarDespacho(DespachoRetardado *self);
 
-#endif
\ No newline at end of file
+/**
+ * @brief Calcula el tiempo que falta para el próximo despacho
+ * programado. Permite dormir hasta ese instante sin llamar a
+ * DespachoRetardado_procesarDespacho cada milisegundo.
+ *
+ * @param self Este objeto
+ * @return uint32_t Milisegundos hasta el próximo despacho (0 si ya
+ * venció) o SP_TIEMPO_INDEFINIDO si no hay despachos en espera
+ */
+uint32_t DespachoRetardado_tiempoHastaProximoDespacho(DespachoRetardado const *self);
+
+#endif
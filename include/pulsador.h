@@ -15,6 +15,7 @@ typedef struct Pulsador{
         bool nivelActivo;                   //Nivel de pulsador cuando esta activo
         SP_HPin pin;                        //Handle del pin donde se conecta            
         uint8_t histeresis;                 //Número de lecturas consecutivas idénticas necesarias para cambiar el estado filtrado
+        bool despertarPorFlanco;            //Un flanco en el pin despierta al CPU (ver Pulsador_habilitaDespertar)
     }parametros;
     uint32_t t0;
     Maquina *destino;                      //Puntero a maquina de estado
@@ -22,6 +23,7 @@ typedef struct Pulsador{
     struct{
         bool nivelAnterior;                
         uint8_t contador;
+        bool volatile flanco;              //Hubo un flanco desde la última lectura
     }estado;
 } Pulsador;
 
@@ -47,10 +49,39 @@ void Pulsador_init(Pulsador *self,
                    uint8_t histeresis);
 /**
  * @brief Lee pulsador, actualiza la máquina de estado y
- * despacha evento si detecta pulsación
+ * despacha evento si detecta pulsación. Con la interrupción por
+ * flanco habilitada (Pulsador_habilitaDespertar) solo lee el pin
+ * desde el primer flanco hasta que el nivel vuelve a ser estable;
+ * el resto del tiempo retorna sin leer. El evento siempre se
+ * despacha desde aquí, nunca desde la interrupción.
  * 
  * @param self 
  */
 void Pulsador_procesa(Pulsador *self);
 
+/**
+ * @brief Configura una interrupción en ambos flancos del pin para
+ * que un cambio en el pulsador despierte al CPU. Mientras el nivel
+ * filtrado está estable el pulsador no necesita lecturas periódicas:
+ * la interrupción solo marca el flanco y Pulsador_procesa inicia
+ * el antirrebote.
+ * 
+ * @param self Este objeto
+ * @return true Interrupción configurada
+ * @return false Línea de interrupción ocupada, el pulsador debe
+ * leerse cada milisegundo
+ */
+bool Pulsador_habilitaDespertar(Pulsador *self);
+
+/**
+ * @brief Calcula el tiempo que falta hasta la próxima lectura que
+ * necesita el antirrebote
+ * 
+ * @param self Este objeto
+ * @return uint32_t Milisegundos hasta la próxima lectura o
+ * SP_TIEMPO_INDEFINIDO si el nivel es estable y un flanco despertará
+ * al CPU
+ */
+uint32_t Pulsador_tiempoHastaProximaLectura(Pulsador const *self);
+
 #endif
\ No newline at end of file
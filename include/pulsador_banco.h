@@ -0,0 +1,81 @@
+#ifndef PULSADOR_BANCO_H
+#define PULSADOR_BANCO_H
+#include <maquina_estado.h>
+#include <soporte_placa.h>
+
+/**
+ * @brief Número de planos de bits de los contadores verticales.
+ * La histéresis máxima es 2^PULSADOR_BANCO_BITS_CONTADOR lecturas
+ */
+#ifndef PULSADOR_BANCO_BITS_CONTADOR
+#define PULSADOR_BANCO_BITS_CONTADOR 3
+#endif
+
+#define PULSADOR_BANCO_MAX_HISTERESIS (1u << PULSADOR_BANCO_BITS_CONTADOR)
+
+/**
+ * @brief Banco de pulsadores conectados a un mismo puerto.
+ * Lee el puerto completo una vez por milisegundo y filtra las 16
+ * líneas a la vez con contadores verticales: el bit n de cada plano
+ * pertenece al contador de la línea n. El costo de cada lectura no
+ * depende del número de pulsadores.
+ *
+ */
+typedef struct PulsadorBanco{
+    struct{
+        SP_HPuerto puerto;                  //Puerto donde se conectan los pulsadores
+        uint16_t lineas;                    //Líneas con pulsador (bit n: línea n)
+        uint16_t nivelesActivos;            //Nivel de cada línea cuando su pulsador está activo
+        uint8_t histeresis;                 //Número de lecturas consecutivas distintas al nivel filtrado necesarias para cambiarlo
+    }parametros;
+    struct{
+        Maquina *destino;                   //Maquina que recibe la pulsación de la línea
+        Evento evento;                      //Evento que despacha la pulsación de la línea
+    }salidas[16];
+    uint32_t t0;
+    struct{
+        uint16_t filtrado;                  //Nivel filtrado de cada línea
+        uint16_t contador[PULSADOR_BANCO_BITS_CONTADOR]; //Planos de bits de los contadores verticales
+    }estado;
+}PulsadorBanco;
+
+/**
+ * @brief Inicializa un banco de pulsadores sin pulsadores
+ *
+ * @param self Este objeto
+ * @param puerto Puerto donde se conectan los pulsadores
+ * @param histeresis Número de lecturas consecutivas distintas al
+ * nivel filtrado necesarias para cambiarlo (1 a
+ * PULSADOR_BANCO_MAX_HISTERESIS)
+ */
+void PulsadorBanco_init(PulsadorBanco *self, SP_HPuerto puerto, uint8_t histeresis);
+
+/**
+ * @brief Agrega un pulsador al banco y configura su pin como entrada
+ * con resistencia de pull-up/pull-dn según el nivel activo
+ *
+ * @param self Este objeto
+ * @param pin Pin donde está conectado el pulsador, del puerto del banco
+ * @param nivelActivo Nivel lógico que toma el pin cuando el
+ * pulsador es presionado
+ * @param destino Puntero a maquina que recibe la pulsación
+ * @param evento Evento a despachar cuando se detecta pulsación
+ * @return true Pulsador agregado
+ * @return false El pin no pertenece al puerto del banco
+ */
+bool PulsadorBanco_agregaPulsador(PulsadorBanco *self,
+                                  SP_HPin pin,
+                                  bool nivelActivo,
+                                  Maquina *destino,
+                                  Evento evento);
+
+/**
+ * @brief Lee el puerto, actualiza el filtro de todas las líneas y
+ * despacha el evento de cada pulsador en el que detecta pulsación.
+ * Lee a lo sumo una vez por milisegundo
+ *
+ * @param self Este objeto
+ */
+void PulsadorBanco_procesa(PulsadorBanco *self);
+
+#endif
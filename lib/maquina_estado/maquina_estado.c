@@ -1,34 +1,428 @@
 #include "maquina_estado_impl.h"
+#include "planificador.h"
+#include "traza.h"
 #include <stddef.h>
+#include <string.h>
 #include <stm32f1xx.h>
+#include <soporte_placa/sp_perfil.h>
 
+#if MAX_EV_COLA
 void Maquina_init(Maquina *self, Estado estadoInicial){
+    Maquina_initConCola(self,estadoInicial,self->colaInterna,MAX_EV_COLA);
+}
+#endif
+
+bool Maquina_initConCola(Maquina *self, Estado estadoInicial, LugarCola *lugares, uint32_t capacidad){
+    bool const valida = lugares && capacidad >= 2 && capacidad <= MAQUINA_MAX_CAPACIDAD_COLA && !(capacidad & (capacidad - 1));
     self->estadoInicial = estadoInicial;                    //Coloca el parámetro "estadoInicial" en el estado inicial de la maquina
     self->estadoActual = (Estado)0;                         //Puntero nulo a funcion (Estado actual no definido) 
+    self->planificador = NULL;                              //Sin planificador hasta Planificador_registra
+    self->prioridad = 0;
+    self->cola.lugares = valida ? lugares : NULL;           //Sin lugares: toda reserva falla
+    self->cola.mascara = valida ? capacidad - 1 : 0;
     self->cola.lecturas = 0;                                //Lecturas al iniciar = 0
     self->cola.escrituras = 0;                              //Escrituras al iniciar = 0
-    Maquina_despacha(self, EV_RESET);                       //Despacho el evento RESET
+    self->cola.aviso = NULL;
+    self->cola.descartados = 0;
+    self->cola.ocupacionMaxima = 0;
+    self->cola.pendientes = 0;
+    self->cola.fusionables = 0;
+    self->cola.politica = MAQUINA_DESBORDE_DESCARTA_NUEVO;
+    self->cola.reservados = 0;
+#if MAQUINA_COLA == MAQUINA_COLA_MPSC
+    for (uint32_t i=0;valida && i<capacidad;++i){
+        lugares[i].secuencia = (SecuenciaCola)i;            //Cada lugar libre para la primera vuelta
+    }
+#endif
+    if (valida) Maquina_despacha(self, EV_RESET);           //Despacho el evento RESET
+    return valida;
 }
 
-static bool Maquina__qEspacioEnCola (Maquina const *self) {
-    return(self->cola.escrituras - self->cola.lecturas) < MAX_EV_COLA;
+/**
+ * @brief Indica si el evento entra en la cola
+ */
+static bool Maquina__qEventoValido(Evento evento){
+#if MAQUINA_EVENTO_8_BITS
+    return (EV_NULO != evento) && (evento <= UINT8_MAX);
+#else
+    return EV_NULO != evento;
+#endif
 }
 
-bool Maquina_despacha(Maquina *self, Evento evento){
-    bool hecho = false;        
-    unsigned const posicion = (self->cola.escrituras) % MAX_EV_COLA;                                             
-    __disable_irq();                                                        
-    if((EV_NULO != evento) && Maquina__qEspacioEnCola(self)){      //Si aun hay espacio en la cola agrego un elemento  
-        self->cola.eventos[posicion] = evento;                                     
-        self->cola.escrituras++;                                                
+/*
+ * Cada despacho reserva un lugar, copia el evento y lo publica.
+ * Solo la reserva y la publicación dependen de MAQUINA_COLA.
+ */
+
+#if MAQUINA_COLA == MAQUINA_COLA_BLOQUEO
+
+static bool Maquina__qEspacioEnCola (Maquina const *self, uint32_t limite) {
+    return self->cola.lugares && (self->cola.escrituras - self->cola.lecturas) < limite;
+}
+
+static bool Maquina__reserva(Maquina *self, uint32_t *escritura, uint32_t limite){
+    bool hecho = false;
+    __disable_irq();                                        //Se habilitan en Maquina__publica
+    if (Maquina__qEspacioEnCola(self,limite)){
+        *escritura = self->cola.escrituras;
         hecho = true;
+    }else{
+        __enable_irq();
     }
-    __enable_irq();
     return hecho;
 }
 
+static void Maquina__publica(Maquina *self, uint32_t escritura){
+    self->cola.escrituras = escritura + 1;
+    __enable_irq();
+}
+
+#elif MAQUINA_COLA == MAQUINA_COLA_SPSC
+
+static bool Maquina__qEspacioEnCola (Maquina const *self, uint32_t limite) {
+    return self->cola.lugares && (self->cola.escrituras - self->cola.lecturas) < limite;
+}
+
+static bool Maquina__reserva(Maquina *self, uint32_t *escritura, uint32_t limite){
+    *escritura = self->cola.escrituras;                     //Solo el productor modifica escrituras
+    return Maquina__qEspacioEnCola(self,limite);
+}
+
+static void Maquina__publica(Maquina *self, uint32_t escritura){
+    __DMB();                                                //El evento queda escrito antes de publicarlo
+    self->cola.escrituras = escritura + 1;
+}
+
+#elif MAQUINA_COLA == MAQUINA_COLA_MPSC
+
+#if MAQUINA_EVENTO_8_BITS
+typedef int8_t DiferenciaSecuencia;
+#else
+typedef int32_t DiferenciaSecuencia;
+#endif
+
+/**
+ * @brief Secuencia del lugar menos n, con signo. Negativa: el lugar
+ * aún contiene la vuelta anterior. Con capacidad de hasta
+ * MAQUINA_MAX_CAPACIDAD_COLA basta con los bits de SecuenciaCola
+ */
+static int32_t Maquina__diferencia(LugarCola const *lugar, uint32_t n){
+    return (DiferenciaSecuencia)(SecuenciaCola)(lugar->secuencia - (SecuenciaCola)n);
+}
+
+static bool Maquina__reserva(Maquina *self, uint32_t *escritura, uint32_t limite){
+    if (!self->cola.lugares) return false;                  //Cola inválida (ver Maquina_initConCola)
+    for (;;){
+        uint32_t const n = __LDREXW(&self->cola.escrituras);
+        int32_t const diferencia = Maquina__diferencia(self->cola.lugares + (n & self->cola.mascara),n);
+        if (diferencia < 0 || n - self->cola.lecturas >= limite){  //El lugar aún contiene la vuelta anterior, o quedan solo los reservados: cola llena
+            __CLREX();
+            return false;
+        }
+        if (diferencia == 0 && !__STREXW(n + 1,&self->cola.escrituras)){
+            *escritura = n;
+            return true;
+        }
+        __CLREX();                                          //Otro productor reservó el lugar: reintentar
+    }
+}
+
+static void Maquina__publica(Maquina *self, uint32_t escritura){
+    __DMB();                                                //El evento queda escrito antes de publicarlo
+    self->cola.lugares[escritura & self->cola.mascara].secuencia = (SecuenciaCola)(escritura + 1);
+}
+
+#else
+#error MAQUINA_COLA desconocido
+#endif
+
 static bool Maquina__qEventosDisponiblesEnCola(Maquina const *self){
+#if MAQUINA_COLA == MAQUINA_COLA_MPSC
+    uint32_t const lectura = self->cola.lecturas;
+    return self->cola.lugares                                                                            //Cola válida
+        && self->cola.lugares[lectura & self->cola.mascara].secuencia == (SecuenciaCola)(lectura + 1);   //El lugar contiene un evento publicado
+#else
     return self->cola.escrituras != self->cola.lecturas;               //Si no hay la misma cantidad de eventos en cola que procesados
+#endif
+}
+
+/**
+ * @brief Bit del evento en el mapa de pendientes, 0 si el evento no es
+ * fusionable
+ */
+static uint32_t Maquina__bitFusionable(Maquina const *self, Evento evento){
+    return (evento < 32) ? self->cola.fusionables & MAQUINA_BIT_EVENTO(evento) : 0;
+}
+
+/**
+ * @brief Cantidad de eventos en cola hasta la que puede encolarse el
+ * evento: la capacidad, menos los lugares reservados a los eventos
+ * fusionables si no lo es (MAQUINA_DESBORDE_RESERVA_FUSIONABLES)
+ */
+static uint32_t Maquina__limite(Maquina const *self, Evento evento){
+    uint32_t const reservados = Maquina__bitFusionable(self,evento) ? 0 : self->cola.reservados;
+    return self->cola.mascara + 1 - reservados;
+}
+
+/**
+ * @brief Marca pendiente un evento fusionable con LDREX/STREX, sin
+ * deshabilitar interrupciones
+ * 
+ * @return true Ya estaba pendiente: el despacho se fusiona con él
+ * @return false Marcado: quien llama debe encolarlo
+ */
+static bool Maquina__marcaPendiente(Maquina *self, uint32_t bit){
+    for (;;){
+        uint32_t const pendientes = __LDREXW(&self->cola.pendientes);
+        if (pendientes & bit){
+            __CLREX();
+            return true;
+        }
+        if (!__STREXW(pendientes | bit,&self->cola.pendientes)) return false;
+    }
+}
+
+static void Maquina__desmarcaPendiente(Maquina *self, uint32_t bit){
+    uint32_t pendientes;
+    do{
+        pendientes = __LDREXW(&self->cola.pendientes);
+    }while (__STREXW(pendientes & ~bit,&self->cola.pendientes));
+}
+
+/**
+ * @brief Avisa al planificador, si lo hay, que la máquina tiene
+ * eventos para procesar
+ */
+static void Maquina__notifica(Maquina *self){
+    if (self->planificador) Planificador_marcaLista(self->planificador,self->prioridad);
+}
+
+#if MAQUINA_TRAZA
+static void Maquina__trazaDespacho(Maquina const *self, Evento evento, bool hecho){
+    if (EV_NULO != evento) Traza_registra(self,evento,hecho ? TRAZA_DESPACHO : TRAZA_DESCARTE,(Estado)0,(Estado)0);
+}
+#endif
+
+/*
+ * Con las interrupciones deshabilitadas ningún otro productor puede
+ * intercalarse: alcanza con ver si el lugar está libre, sin reserva
+ * exclusiva. Una reserva del lazo principal interrumpida entre LDREX y
+ * STREX falla y se reintenta, porque la escritura de "escrituras" (o la
+ * salida de la interrupción) invalida su exclusividad.
+ */
+
+/**
+ * @brief Lugar de la próxima escritura si está libre, con las
+ * interrupciones deshabilitadas por quien llama
+ * 
+ * @param limite Eventos en cola a partir de los cuales está llena
+ * (ver Maquina__limite)
+ * @return LugarCola* Lugar libre, nulo si la cola está llena
+ */
+static LugarCola *Maquina__reservaBloqueado(Maquina *self, uint32_t *escritura, uint32_t limite){
+    uint32_t const n = self->cola.escrituras;
+    LugarCola *const lugar = self->cola.lugares ? self->cola.lugares + (n & self->cola.mascara) : NULL;
+#if MAQUINA_COLA == MAQUINA_COLA_MPSC
+    bool const libre = lugar && Maquina__diferencia(lugar,n) == 0 && (n - self->cola.lecturas) < limite;
+#else
+    bool const libre = lugar && (n - self->cola.lecturas) < limite;
+#endif
+    *escritura = n;
+    return libre ? lugar : NULL;
+}
+
+static void Maquina__publicaBloqueado(Maquina *self, LugarCola *lugar, uint32_t escritura){
+#if MAQUINA_COLA == MAQUINA_COLA_MPSC
+    self->cola.escrituras = escritura + 1;
+    __DMB();                                                //El evento queda escrito antes de publicarlo
+    lugar->secuencia = (SecuenciaCola)(escritura + 1);
+#else
+    (void)lugar;
+    __DMB();
+    self->cola.escrituras = escritura + 1;
+#endif
+}
+
+/**
+ * @brief Quita el evento más antiguo de la cola. Requiere las
+ * interrupciones deshabilitadas y que el consumidor tome los eventos
+ * con las interrupciones deshabilitadas (ver Maquina_siguienteEvento)
+ * 
+ * @return true Evento quitado
+ * @return false No hay un evento publicado para quitar (el más antiguo
+ * es de un productor interrumpido antes de publicarlo)
+ */
+static bool Maquina__descartaViejo(Maquina *self){
+    bool hecho = false;
+    if (Maquina__qEventosDisponiblesEnCola(self)){
+        uint32_t const lectura = self->cola.lecturas;
+        LugarCola *const lugar = self->cola.lugares + (lectura & self->cola.mascara);
+        uint32_t const fusionable = Maquina__bitFusionable(self,lugar->evento);
+        if (fusionable) Maquina__desmarcaPendiente(self,fusionable);       //Ya no está en cola
+#if MAQUINA_TRAZA
+        Traza_registra(self,lugar->evento,TRAZA_DESCARTE,(Estado)0,(Estado)0);
+#endif
+#if MAQUINA_COLA == MAQUINA_COLA_MPSC
+        lugar->secuencia = (SecuenciaCola)(lectura + self->cola.mascara + 1);  //Libre para la próxima vuelta
+#endif
+        self->cola.lecturas = lectura + 1;
+        hecho = true;
+    }
+    return hecho;
+}
+
+/**
+ * @brief Indica si hay un evento igual publicado en la cola
+ */
+static bool Maquina__qEnCola(Maquina const *self, Evento evento){
+    bool hecho = false;
+    uint32_t const escrituras = self->cola.escrituras;
+    for (uint32_t i=self->cola.lecturas;!hecho && i != escrituras;++i){
+        LugarCola const *const lugar = self->cola.lugares + (i & self->cola.mascara);
+#if MAQUINA_COLA == MAQUINA_COLA_MPSC
+        hecho = lugar->secuencia == (SecuenciaCola)(i + 1) && lugar->evento == (EventoCola)evento;
+#else
+        hecho = lugar->evento == (EventoCola)evento;
+#endif
+    }
+    return hecho;
+}
+
+/**
+ * @brief Encola un evento válido con las interrupciones deshabilitadas
+ * por quien llama, aplicando la política de desborde si la cola está
+ * llena
+ * 
+ * @return true Evento encolado o fusionado con uno igual
+ * @return false Evento descartado
+ */
+static bool Maquina__encolaBloqueado(Maquina *self, Evento evento, void const *parametro, size_t tamano){
+    bool hecho = false;
+    uint32_t escritura;
+    uint32_t const limite = Maquina__limite(self,evento);
+    LugarCola *lugar = Maquina__reservaBloqueado(self,&escritura,limite);
+    if (!lugar && self->cola.politica == MAQUINA_DESBORDE_DESCARTA_VIEJO && Maquina__descartaViejo(self)){
+        ++self->cola.descartados;
+        lugar = Maquina__reservaBloqueado(self,&escritura,limite);
+    }
+    if (lugar){
+        lugar->evento = (EventoCola)evento;
+#if MAQUINA_TAM_PARAMETRO
+        if (tamano) memcpy(lugar->parametro.bytes,parametro,tamano);
+#else
+        (void)parametro;
+        (void)tamano;
+#endif
+        Maquina__publicaBloqueado(self,lugar,escritura);
+        hecho = true;
+    }else if (self->cola.politica == MAQUINA_DESBORDE_FUSIONA && Maquina__qEnCola(self,evento)){
+        hecho = true;
+    }else{
+        ++self->cola.descartados;
+    }
+    return hecho;
+}
+
+static void Maquina__avisaDesborde(Maquina *self, Evento evento){
+    if (self->cola.politica == MAQUINA_DESBORDE_AVISA && self->cola.aviso) self->cola.aviso(self,evento);
+}
+
+/**
+ * @brief Camino de Maquina_despacha cuando la reserva sin bloqueo
+ * encuentra la cola llena. Poco frecuente, así que se resuelve con las
+ * interrupciones deshabilitadas, lo que también protege el contador
+ * de descartados
+ */
+static bool Maquina__desborde(Maquina *self, Evento evento, void const *parametro, size_t tamano){
+    __disable_irq();
+    bool const hecho = Maquina__encolaBloqueado(self,evento,parametro,tamano);  //Reintenta: el consumidor pudo liberar lugar
+    __enable_irq();
+    if (!hecho) Maquina__avisaDesborde(self,evento);
+    return hecho;
+}
+
+/**
+ * @brief Encola un evento válido por el camino sin bloqueo, o por el
+ * de desborde si la cola está llena
+ */
+static bool Maquina__encola(Maquina *self, Evento evento, void const *parametro, size_t tamano){
+    bool hecho = false;
+    uint32_t escritura;
+    if (Maquina__reserva(self,&escritura,Maquina__limite(self,evento))){  //Si aun hay espacio en la cola agrego un elemento
+        LugarCola *const lugar = self->cola.lugares + (escritura & self->cola.mascara);
+        lugar->evento = (EventoCola)evento;
+#if MAQUINA_TAM_PARAMETRO
+        if (tamano) memcpy(lugar->parametro.bytes,parametro,tamano);
+#endif
+        Maquina__publica(self,escritura);
+        hecho = true;
+    }else{
+        hecho = Maquina__desborde(self,evento,parametro,tamano);
+    }
+    return hecho;
+}
+
+/**
+ * @brief Despacha un evento válido, o lo fusiona con el mismo evento
+ * pendiente si es fusionable
+ */
+static bool Maquina__despacha(Maquina *self, Evento evento, void const *parametro, size_t tamano){
+    bool hecho = false;
+    uint32_t const fusionable = Maquina__bitFusionable(self,evento);
+    if (fusionable && Maquina__marcaPendiente(self,fusionable)){
+        hecho = true;                                               //Ya está en cola
+    }else{
+        hecho = Maquina__encola(self,evento,parametro,tamano);
+        if (!hecho && fusionable) Maquina__desmarcaPendiente(self,fusionable);
+    }
+    if (hecho) Maquina__notifica(self);
+    return hecho;
+}
+
+bool Maquina_despacha(Maquina *self, Evento evento){
+    bool hecho = false;
+    if(Maquina__qEventoValido(evento)){
+        hecho = Maquina__despacha(self,evento,NULL,0);
+    }
+#if MAQUINA_TRAZA
+    Maquina__trazaDespacho(self,evento,hecho);
+#endif
+    return hecho;
+}
+
+bool Maquina_despachaBloqueado(Maquina *self, Evento evento){
+    bool hecho = false;
+    if (Maquina__qEventoValido(evento)){
+        uint32_t const fusionable = Maquina__bitFusionable(self,evento);
+        if (fusionable && Maquina__marcaPendiente(self,fusionable)){
+            hecho = true;                                           //Ya está en cola
+        }else{
+            hecho = Maquina__encolaBloqueado(self,evento,NULL,0);
+            if (!hecho && fusionable) Maquina__desmarcaPendiente(self,fusionable);
+            if (!hecho) Maquina__avisaDesborde(self,evento);
+        }
+    }
+#if MAQUINA_TRAZA
+    Maquina__trazaDespacho(self,evento,hecho);
+#endif
+    return hecho;
+}
+
+#if MAQUINA_TAM_PARAMETRO
+bool Maquina_despachaConParametro(Maquina *self, Evento evento, void const *parametro, size_t tamano){
+    bool hecho = false;
+    if((tamano <= MAQUINA_TAM_PARAMETRO) && Maquina__qEventoValido(evento)){
+        hecho = Maquina__despacha(self,evento,parametro,tamano);
+    }
+#if MAQUINA_TRAZA
+    Maquina__trazaDespacho(self,evento,hecho);
+#endif
+    return hecho;
+}
+#endif
+
+bool Maquina_hayEventosPendientes(Maquina const *self){
+    return Maquina__qEventosDisponiblesEnCola(self);
 }
 
 /**
@@ -39,30 +433,112 @@ static bool Maquina__qEventosDisponiblesEnCola(Maquina const *self){
  */
 static Evento Maquina_siguienteEvento(Maquina *self){
     Evento evento = EV_NULO;
+    bool const bloquea = self->cola.politica == MAQUINA_DESBORDE_DESCARTA_VIEJO;   //Un productor puede quitar el evento más antiguo
+    if (bloquea) __disable_irq();
     if(Maquina__qEventosDisponiblesEnCola(self)){                           //Hay eventos disponibles para procesar?
-        unsigned const posicion = (self->cola.lecturas) % MAX_EV_COLA;      
-        evento = self->cola.eventos[posicion];
-        self->cola.lecturas++;
+        uint32_t const lectura = self->cola.lecturas;
+        uint32_t const ocupacion = self->cola.escrituras - lectura;         //La ocupación solo baja al procesar: aquí se ve cada máximo
+        if (ocupacion > self->cola.ocupacionMaxima) self->cola.ocupacionMaxima = ocupacion;
+        LugarCola *const lugar = self->cola.lugares + (lectura & self->cola.mascara);
+#if MAQUINA_COLA != MAQUINA_COLA_BLOQUEO
+        __DMB();                                                            //Lee el evento después de verlo publicado
+#endif
+        evento = lugar->evento;
+#if MAQUINA_TAM_PARAMETRO
+        self->parametroActual = lugar->parametro;                          //Copia antes de liberar el lugar en la cola
+#endif
+#if MAQUINA_COLA != MAQUINA_COLA_BLOQUEO
+        __DMB();                                                            //Termina de leer antes de liberar el lugar
+#endif
+#if MAQUINA_COLA == MAQUINA_COLA_MPSC
+        lugar->secuencia = (SecuenciaCola)(lectura + self->cola.mascara + 1);  //Libre para la próxima vuelta
+#endif
+        self->cola.lecturas = lectura + 1;
+        uint32_t const fusionable = Maquina__bitFusionable(self,evento);
+        if (fusionable) Maquina__desmarcaPendiente(self,fusionable);       //Un despacho durante el procesamiento lo vuelve a encolar
     }
+    if (bloquea) __enable_irq();
     return evento;
 }
 
 
 
+/**
+ * @brief Procesa un evento ya tomado de la cola
+ * 
+ * @param self Puntero a maquina
+ * @param estadoActual Estado actual de la máquina
+ * @param evento Evento a procesar
+ * @return Estado Estado actual después de procesar el evento
+ */
+static Estado Maquina__procesaEvento(Maquina *self, Estado estadoActual, Evento evento){
+    if (evento == EV_RESET || !estadoActual){                       //Si el evento es reset o el estado actual no esta definido (Puntero nulo), reinicio la maquina
+        estadoActual = self->estadoInicial;
+    }
+    
+    Estado const estado = estadoActual;
+    Resultado resultado;                                            //"resultado" contiene el código de resultado y el nuevo estado de la máquina que procesa "evento"
+    SP_PERFIL_MIDE(estado,resultado = estado(self,evento));         //Con SP_PERFILADO la duración se registra a nombre del estado
+    
+    if (Resultado_getCodigo(resultado) == RES_TRANSICION){          //Si el evento esta en proceso, seteo el estado actual en el nuevo estado
+        estadoActual = Resultado_getNuevoEstado(resultado);
+    }
+#if MAQUINA_TRAZA
+    Traza_registra(self,evento,TRAZA_PROCESO,estado,estadoActual);
+#endif
+    return estadoActual;
+}
+
 bool Maquina_procesa(Maquina *self){
     Evento const evento = Maquina_siguienteEvento(self);            //"evento" almacena el siguiente evento a procesar
     bool procesado = false;
     if (evento != EV_NULO){
         procesado = true;                                       
-        if (evento == EV_RESET || !self->estadoActual){             //Si el evento es reset o el estado actual no esta definido (Puntero nulo), reinicio la maquina
-            self->estadoActual = self->estadoInicial;               
-        }
-        
-        Resultado resultado = self->estadoActual(self,evento);      //"resultado" contiene el código de resultado y el nuevo estado de la máquina que procesa "evento"
-        
-        if (resultado.codigo == RES_TRANSICION){                 //Si el evento esta en proceso, seteo el estado actual en el nuevo estado
-            self->estadoActual = resultado.nuevoEstado;
-        }
+        self->estadoActual = Maquina__procesaEvento(self,self->estadoActual,evento);
     }
     return procesado;                                               //Devuelvo la variable que me confirma que el evento se proceso
-}
\ No newline at end of file
+}
+
+uint32_t Maquina_procesaLote(Maquina *self, uint32_t maxEventos){
+    uint32_t procesados = 0;
+    Estado estadoActual = self->estadoActual;                       //En un registro durante todo el lote
+    Evento evento;
+    while (procesados < maxEventos && (evento = Maquina_siguienteEvento(self)) != EV_NULO){
+        estadoActual = Maquina__procesaEvento(self,estadoActual,evento);
+        ++procesados;
+    }
+    self->estadoActual = estadoActual;
+    return procesados;
+}
+
+/**
+ * @brief Con MAQUINA_DESBORDE_RESERVA_FUSIONABLES reserva un lugar por
+ * evento fusionable, dejando al menos uno para los demás
+ */
+static void Maquina__actualizaReservados(Maquina *self){
+    uint32_t reservados = 0;
+    if (self->cola.politica == MAQUINA_DESBORDE_RESERVA_FUSIONABLES){
+        for (uint32_t f=self->cola.fusionables;f;f &= f - 1) ++reservados;
+        if (reservados > self->cola.mascara) reservados = self->cola.mascara;
+    }
+    self->cola.reservados = (uint8_t)reservados;
+}
+
+void Maquina_setPoliticaDesborde(Maquina *self, PoliticaDesborde politica, AvisoDesborde aviso){
+    self->cola.politica = (uint8_t)politica;
+    self->cola.aviso = aviso;
+    Maquina__actualizaReservados(self);
+}
+
+void Maquina_setEventosFusionables(Maquina *self, uint32_t eventos){
+    self->cola.fusionables = eventos & ~MAQUINA_BIT_EVENTO(EV_NULO);
+    Maquina__actualizaReservados(self);
+}
+
+uint32_t Maquina_getDescartados(Maquina const *self){
+    return self->cola.descartados;
+}
+
+uint32_t Maquina_getOcupacionMaxima(Maquina const *self){
+    return self->cola.ocupacionMaxima;
+}
@@ -2,7 +2,15 @@
 #define MAQUINA_ESTADO_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
+/**
+ * @brief Capacidad de la cola interna de cada Maquina, la que usa
+ * Maquina_init. Debe ser potencia de 2. Con 0 la máquina no reserva
+ * cola interna y cada una se inicia con Maquina_initConCola y una
+ * cola de la capacidad que necesite
+ */
 #ifndef MAX_EV_COLA
 #define MAX_EV_COLA 16 /* debe ser potencia de 2*/
 #endif
@@ -11,11 +19,75 @@
 #error MAX_EV_COLA debe ser potencia de dos
 #endif
 
+/**
+ * @brief Sincronización de la cola de eventos entre productores
+ * (quienes llaman a Maquina_despacha) y el consumidor (quien llama
+ * a Maquina_procesa)
+ *
+ * MAQUINA_COLA_BLOQUEO: cada despacho deshabilita las interrupciones.
+ * MAQUINA_COLA_SPSC: un solo productor y un solo consumidor, sin
+ *     deshabilitar interrupciones. No admite despachar a la misma
+ *     máquina desde interrupciones y desde el lazo principal.
+ * MAQUINA_COLA_MPSC: varios productores (lazo principal e
+ *     interrupciones) y un solo consumidor, sin deshabilitar
+ *     interrupciones. Reserva el lugar con LDREX/STREX y publica
+ *     cada evento con un número de secuencia por lugar.
+ */
+#define MAQUINA_COLA_BLOQUEO 0
+#define MAQUINA_COLA_SPSC 1
+#define MAQUINA_COLA_MPSC 2
+
+#ifndef MAQUINA_COLA
+#define MAQUINA_COLA MAQUINA_COLA_MPSC
+#endif
+
+/**
+ * @brief Tamaño en bytes del parámetro que puede acompañar a cada
+ * evento en la cola (ver Maquina_despachaConParametro). El parámetro
+ * se copia dentro del espacio de la cola, sin memoria dinámica.
+ * Con 0 (valor por defecto) la cola solo guarda eventos.
+ */
+#ifndef MAQUINA_TAM_PARAMETRO
+#define MAQUINA_TAM_PARAMETRO 0
+#endif
+
+/**
+ * @brief En 1 la cola guarda cada evento en un byte (solo admite
+ * eventos hasta 255) y, con MAQUINA_COLA_MPSC, también su número de
+ * secuencia, lo que limita la capacidad de cada cola a 128. En 0 (por
+ * defecto) usa palabras de 32 bits
+ */
+#ifndef MAQUINA_EVENTO_8_BITS
+#define MAQUINA_EVENTO_8_BITS 0
+#endif
+
 typedef struct Maquina Maquina;
+typedef struct Planificador Planificador;
 typedef unsigned Evento;
 typedef struct Resultado Resultado;
 typedef Resultado (*Estado)(Maquina* contexto, Evento evento);
 
+/**
+ * @brief Qué hace un despacho cuando la cola de la máquina está llena
+ * (ver Maquina_setPoliticaDesborde)
+ */
+typedef enum PoliticaDesborde{
+    MAQUINA_DESBORDE_DESCARTA_NUEVO,    // Descarta el evento despachado (por defecto)
+    MAQUINA_DESBORDE_DESCARTA_VIEJO,    // Descarta el evento más antiguo en cola y encola el despachado
+    MAQUINA_DESBORDE_FUSIONA,           // Si el mismo evento ya está en cola el despacho se fusiona con él; si no, descarta el despachado
+    MAQUINA_DESBORDE_AVISA,             // Descarta el evento despachado y llama al aviso de desborde
+    MAQUINA_DESBORDE_RESERVA_FUSIONABLES // Descarta el evento despachado; los no fusionables dejan libre un lugar por cada evento fusionable
+}PoliticaDesborde;
+
+/**
+ * @brief Aviso de desborde (MAQUINA_DESBORDE_AVISA). Se llama desde el
+ * contexto que despachó, que puede ser una interrupción
+ * 
+ * @param maquina Máquina con la cola llena
+ * @param evento Evento descartado
+ */
+typedef void (*AvisoDesborde)(Maquina *maquina, Evento evento);
+
 
 enum EventoSistema{
     /**
@@ -36,37 +108,130 @@ enum EventoSistema{
 };
 
 
+#if MAQUINA_TAM_PARAMETRO
+/**
+ * @brief Parámetro de un evento, alineado para poder guardar
+ * enteros o punteros
+ */
+typedef union ParametroEvento{
+    unsigned char bytes[MAQUINA_TAM_PARAMETRO];
+    uint32_t alineacion;
+    void *puntero;
+}ParametroEvento;
+#endif
+
+#if MAQUINA_EVENTO_8_BITS
+typedef uint8_t EventoCola;
+typedef uint8_t SecuenciaCola;
+#define MAQUINA_MAX_CAPACIDAD_COLA 128
+#else
+typedef Evento EventoCola;
+typedef uint32_t SecuenciaCola;
+#define MAQUINA_MAX_CAPACIDAD_COLA 0x80000000UL
+#endif
+
+/**
+ * @brief Lugar de la cola de eventos. Para dar a una máquina una cola
+ * propia se declara un arreglo de lugares (ver Maquina_initConCola)
+ */
+typedef struct LugarCola{
+#if MAQUINA_COLA == MAQUINA_COLA_MPSC
+    /**
+     * @brief secuencia == n : el lugar está libre para la escritura n.
+     * secuencia == n + 1 : el lugar contiene el evento de la escritura
+     * n, listo para leer (módulo 256 con MAQUINA_EVENTO_8_BITS)
+     */
+    volatile SecuenciaCola secuencia;
+#endif
+    EventoCola evento;
+#if MAQUINA_TAM_PARAMETRO
+    ParametroEvento parametro;
+#endif
+}LugarCola;
+
 /**
  * @brief Máquina de estado
  */
 struct Maquina{
     struct {
-        Evento eventos[MAX_EV_COLA];
+        LugarCola *lugares;
+        uint32_t mascara;               //Capacidad - 1
         /**
-         * @brief lecturas % MAX_EV_COLA : indice del proximo elemento a leer
+         * @brief lecturas & mascara : indice del proximo elemento a leer
          * SI lecturas != escrituras
          */
-        unsigned lecturas;
+        volatile uint32_t lecturas;
         /**
-         * @brief escrituras % MAX_EV_COLA : indice del proximo espacio libre 
-         * SI (escrituras - lecturas) < MAX_EV_COLA
+         * @brief escrituras & mascara : indice del proximo espacio libre 
+         * SI (escrituras - lecturas) <= mascara
          */
-        unsigned escrituras;
+        volatile uint32_t escrituras;
+        AvisoDesborde aviso;
+        uint32_t descartados;           //Eventos descartados por cola llena
+        uint32_t ocupacionMaxima;       //Mayor cantidad de eventos en cola vista al procesar
+        volatile uint32_t pendientes;   //Bit e: el evento fusionable e está en cola
+        uint32_t fusionables;           //Bit e: el evento e se fusiona (ver Maquina_setEventosFusionables)
+        uint8_t politica;               //PoliticaDesborde
+        uint8_t reservados;             //Lugares que no ocupan los eventos no fusionables (MAQUINA_DESBORDE_RESERVA_FUSIONABLES)
     }cola;
+#if MAX_EV_COLA
+    LugarCola colaInterna[MAX_EV_COLA];
+#endif
     Estado estadoInicial;
     Estado estadoActual;
+    Planificador *planificador;         //Planificador al que se avisa de cada despacho (nulo: ninguno)
+    unsigned prioridad;                 //Prioridad en el planificador
+#if MAQUINA_TAM_PARAMETRO
+    ParametroEvento parametroActual;    //Parámetro del evento en proceso
+#endif
 };
 
 
 /**
- * @brief Despacha un evento para posterior procesamiento
+ * @brief Despacha un evento para posterior procesamiento. Puede
+ * llamarse desde interrupciones salvo con MAQUINA_COLA_SPSC (ver
+ * MAQUINA_COLA)
+ * 
+ * @param self Este objeto
+ * @param evento Evento a despachar
+ * @return true Evento despachado (o fusionado con uno igual en cola,
+ * ver Maquina_setEventosFusionables y MAQUINA_DESBORDE_FUSIONA)
+ * @return false Falla al despachar evento (cola llena o, con
+ * MAQUINA_EVENTO_8_BITS, evento mayor que 255)
+ */
+bool Maquina_despacha(Maquina *self, Evento evento);
+
+/**
+ * @brief Despacha un evento con las interrupciones ya deshabilitadas
+ * por quien llama, sin avisar al planificador. Permite despachar a
+ * varias máquinas en una sola sección crítica (ver
+ * Publicador_publica); quien llama marca luego las máquinas listas.
+ * Con MAQUINA_DESBORDE_AVISA el aviso también se llama con las
+ * interrupciones deshabilitadas
  * 
  * @param self Este objeto
  * @param evento Evento a despachar
  * @return true Evento despachado
  * @return false Falla al despachar evento
  */
-bool Maquina_despacha(Maquina *self, Evento evento);
+bool Maquina_despachaBloqueado(Maquina *self, Evento evento);
+
+#if MAQUINA_TAM_PARAMETRO
+/**
+ * @brief Despacha un evento acompañado de un parámetro. El parámetro
+ * se copia en la cola y el estado lo obtiene durante el procesamiento
+ * con Maquina_getParametro
+ * 
+ * @param self Este objeto
+ * @param evento Evento a despachar
+ * @param parametro Bytes del parámetro
+ * @param tamano Tamaño del parámetro, a lo sumo MAQUINA_TAM_PARAMETRO
+ * @return true Evento despachado
+ * @return false Falla al despachar evento (cola llena o parámetro
+ * demasiado grande)
+ */
+bool Maquina_despachaConParametro(Maquina *self, Evento evento, void const *parametro, size_t tamano);
+#endif
 
 /**
  * @brief Procesa un evento disponible. Este método debe ser llamado
@@ -78,5 +243,95 @@ bool Maquina_despacha(Maquina *self, Evento evento);
  */
 bool Maquina_procesa(Maquina *self);
 
+/**
+ * @brief Procesa los eventos disponibles, hasta maxEventos, en una
+ * sola llamada. El estado actual se mantiene en un registro durante
+ * el lote y se guarda en la máquina al terminar, así que los estados
+ * no deben consultarlo ni reiniciar la máquina durante el lote. Como
+ * Maquina_procesa, debe ser llamado desde un solo punto del programa
+ * 
+ * @param self Este objeto
+ * @param maxEventos Cantidad máxima de eventos a procesar
+ * @return uint32_t Eventos procesados (menos que maxEventos si la cola
+ * se vació)
+ */
+uint32_t Maquina_procesaLote(Maquina *self, uint32_t maxEventos);
+
+/**
+ * @brief Indica si la máquina tiene eventos en cola esperando
+ * ser procesados
+ * 
+ * @param self Este objeto
+ * @return true Hay eventos pendientes
+ * @return false La cola está vacía
+ */
+bool Maquina_hayEventosPendientes(Maquina const *self);
+
+/**
+ * @brief Elige qué hacer cuando un despacho encuentra la cola llena.
+ * Se llama después de iniciar la máquina y antes de despacharle
+ * eventos desde interrupciones. Con MAQUINA_DESBORDE_DESCARTA_VIEJO
+ * los productores pueden quitar eventos de la cola, por lo que
+ * Maquina_procesa toma cada evento con las interrupciones
+ * deshabilitadas. Con MAQUINA_DESBORDE_FUSIONA el evento fusionado
+ * conserva el parámetro del que ya estaba en cola. Con
+ * MAQUINA_DESBORDE_RESERVA_FUSIONABLES un evento no fusionable se
+ * descarta si al encolarlo quedarían menos lugares libres que eventos
+ * fusionables (ver Maquina_setEventosFusionables): como cada uno ocupa
+ * a lo sumo un lugar, un evento fusionable nunca se descarta. Requiere
+ * menos eventos fusionables que lugares en la cola; la reserva se hace
+ * en la reserva del lugar, sin deshabilitar interrupciones
+ * 
+ * @param self Este objeto
+ * @param politica PoliticaDesborde
+ * @param aviso Función a llamar con cada evento descartado con
+ * MAQUINA_DESBORDE_AVISA (nula: ninguna)
+ */
+void Maquina_setPoliticaDesborde(Maquina *self, PoliticaDesborde politica, AvisoDesborde aviso);
+
+/**
+ * @brief Bit de un evento en el conjunto de Maquina_setEventosFusionables
+ */
+#define MAQUINA_BIT_EVENTO(evento) (1UL << (evento))
+
+/**
+ * @brief Declara los eventos idempotentes de la máquina, cuyo
+ * despacho se fusiona con el mismo evento si ya está en cola en lugar
+ * de encolarlo otra vez. Un mapa de bits de eventos pendientes lo
+ * detecta en tiempo constante, así que cada evento fusionable ocupa a
+ * lo sumo un lugar de la cola sin importar cuántas veces se despache
+ * entre dos procesamientos. El evento se procesa en la posición del
+ * primer despacho: solo sirve para eventos cuyo efecto no depende de
+ * los que llegan después. Al tomar el evento de la cola deja de estar
+ * pendiente, de modo que un despacho durante su procesamiento lo
+ * vuelve a encolar. Se llama después de iniciar la máquina y antes de
+ * despacharle eventos desde interrupciones
+ * 
+ * @param self Este objeto
+ * @param eventos Conjunto de eventos fusionables (MAQUINA_BIT_EVENTO(e)
+ * | ...); solo eventos de 1 a 31. 0: ninguno (por defecto)
+ */
+void Maquina_setEventosFusionables(Maquina *self, uint32_t eventos);
+
+/**
+ * @brief Obtiene la cantidad de eventos descartados por cola llena
+ * desde que se inició la máquina, incluidos los más antiguos quitados
+ * con MAQUINA_DESBORDE_DESCARTA_VIEJO
+ * 
+ * @param self Este objeto
+ * @return uint32_t Eventos descartados
+ */
+uint32_t Maquina_getDescartados(Maquina const *self);
+
+/**
+ * @brief Obtiene la mayor cantidad de eventos en cola vista desde que
+ * se inició la máquina, para dimensionar la cola con datos reales.
+ * Se registra al procesar, sin costo en el despacho
+ * 
+ * @param self Este objeto
+ * @return uint32_t Ocupación máxima, a lo sumo la capacidad de la cola
+ */
+uint32_t Maquina_getOcupacionMaxima(Maquina const *self);
+
 
 #endif
\ No newline at end of file
@@ -18,22 +18,91 @@ typedef enum codigoResultado {
 } codigoResultado;
 
 /**
- * @brief Resultado: El resultado de procesaro un evento
- * codigo: Numero que expresa el resultado luego del procesamiento
- * Estado: Variable que almacena el próximo estado a alcanzar por la máquina
+ * @brief Resultado: El resultado de procesaro un evento, en una sola
+ * palabra para que el estado lo devuelva en un registro. valor es
+ * RES_IGNORADO, RES_PROCESADO o, en una transición, la dirección del
+ * nuevo estado (ninguna función está en las direcciones 0 o 1). Se
+ * construye y se lee con las funciones Resultado_xxx
  * 
  */
 struct Resultado{
-    codigoResultado codigo;
-    Estado nuevoEstado; // Valido cuando resultado = RES_TRANSICION
+    uintptr_t valor;
 };
 
 /**
- * @brief Inicializa la máquina de estado
+ * @brief Resultado de un evento ignorado
+ */
+static inline Resultado Resultado_ignorado(void){
+    return (Resultado){RES_IGNORADO};
+}
+
+/**
+ * @brief Resultado de un evento procesado sin cambiar de estado
+ */
+static inline Resultado Resultado_procesado(void){
+    return (Resultado){RES_PROCESADO};
+}
+
+/**
+ * @brief Resultado de un evento que produce una transición
+ * 
+ * @param nuevoEstado Estado siguiente
+ */
+static inline Resultado Resultado_transicion(Estado nuevoEstado){
+    return (Resultado){(uintptr_t)nuevoEstado};
+}
+
+/**
+ * @brief Código del resultado
+ */
+static inline codigoResultado Resultado_getCodigo(Resultado resultado){
+    return (resultado.valor > RES_PROCESADO) ? RES_TRANSICION : (codigoResultado)resultado.valor;
+}
+
+/**
+ * @brief Nuevo estado. Válido cuando el código es RES_TRANSICION
+ */
+static inline Estado Resultado_getNuevoEstado(Resultado resultado){
+    return (Estado)resultado.valor;
+}
+
+#if MAX_EV_COLA
+/**
+ * @brief Inicializa la máquina de estado con su cola interna de
+ * MAX_EV_COLA lugares
  * 
  * @param self Puntero a máquina
  * @param estadoInicial El estado inicial que queremos poner a la maquina
  */
 void Maquina_init(Maquina *self, Estado estadoInicial);
+#endif
+
+/**
+ * @brief Inicializa la máquina de estado con una cola propia
+ * 
+ * @param self Puntero a máquina
+ * @param estadoInicial El estado inicial que queremos poner a la maquina
+ * @param lugares Lugares de la cola, que la máquina usa mientras exista
+ * @param capacidad Cantidad de lugares: potencia de 2, de 2 a
+ * MAQUINA_MAX_CAPACIDAD_COLA
+ * @return true Máquina iniciada
+ * @return false Capacidad inválida o lugares nulo: la máquina queda sin
+ * cola, todo despacho falla y no hay eventos que procesar
+ */
+bool Maquina_initConCola(Maquina *self, Estado estadoInicial, LugarCola *lugares, uint32_t capacidad);
+
+#if MAQUINA_TAM_PARAMETRO
+/**
+ * @brief Obtiene el parámetro del evento en proceso. Solo es válido
+ * dentro del estado que procesa el evento. Si el evento se despachó
+ * con Maquina_despacha su contenido no está definido
+ * 
+ * @param self Este objeto
+ * @return void const* Puntero a MAQUINA_TAM_PARAMETRO bytes
+ */
+static inline void const *Maquina_getParametro(Maquina const *self){
+    return self->parametroActual.bytes;
+}
+#endif
 
 #endif
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include "maquina_jerarquica.h"
+#include "maquina_estado_impl.h"
+
+/**
+ * @brief Cantidad de estados desde el más externo hasta estado, inclusive
+ */
+static unsigned MaquinaJerarquica__profundidad(EstadoJerarquico const *estado){
+    unsigned profundidad = 0;
+    for (;estado;estado = estado->padre) ++profundidad;
+    return profundidad;
+}
+
+/**
+ * @brief Ancestro común más profundo de dos estados, considerando
+ * a cada estado ancestro de sí mismo
+ */
+static EstadoJerarquico const *MaquinaJerarquica__ancestroComun(EstadoJerarquico const *a, EstadoJerarquico const *b){
+    unsigned pa = MaquinaJerarquica__profundidad(a);
+    unsigned pb = MaquinaJerarquica__profundidad(b);
+    for (;pa > pb;--pa) a = a->padre;
+    for (;pb > pa;--pb) b = b->padre;
+    while (a != b){
+        a = a->padre;
+        b = b->padre;
+    }
+    return a;
+}
+
+/**
+ * @brief Sale de los estados desde estado hasta ancestro, sin salir
+ * de ancestro
+ */
+static void MaquinaJerarquica__saleHasta(MaquinaJerarquica *self, EstadoJerarquico const *estado, EstadoJerarquico const *ancestro){
+    for (;estado != ancestro;estado = estado->padre){
+        if (estado->salida) estado->salida(&self->maquina);
+    }
+}
+
+/**
+ * @brief Entra a los estados desde ancestro (sin entrar a él) hasta
+ * destino, empezando por el más externo
+ */
+static void MaquinaJerarquica__entraHasta(MaquinaJerarquica *self, EstadoJerarquico const *ancestro, EstadoJerarquico const *destino){
+    EstadoJerarquico const *camino[MAQUINA_JERARQUICA_PROFUNDIDAD];
+    unsigned n = 0;
+    for (EstadoJerarquico const *e = destino;e != ancestro;e = e->padre){
+        camino[n++] = e;
+    }
+    while (n){
+        EstadoJerarquico const *const e = camino[--n];
+        if (e->entrada) e->entrada(&self->maquina);
+    }
+}
+
+/**
+ * @brief Entra a destino desde ancestro y sigue los subestados iniciales
+ * hasta una hoja, que pasa a ser el estado actual
+ */
+static void MaquinaJerarquica__entra(MaquinaJerarquica *self, EstadoJerarquico const *ancestro, EstadoJerarquico const *destino){
+    MaquinaJerarquica__entraHasta(self,ancestro,destino);
+    while (destino->inicial){
+        MaquinaJerarquica__entraHasta(self,destino,destino->inicial);
+        destino = destino->inicial;
+    }
+    self->estadoActual = destino;
+}
+
+/**
+ * @brief Único estado (en términos de Maquina) de toda máquina
+ * jerárquica: entrega el evento al estado actual y a sus ancestros
+ * y realiza las transiciones
+ */
+static Resultado MaquinaJerarquica__procesa(Maquina *contexto, Evento evento){
+    MaquinaJerarquica *const self = (MaquinaJerarquica*)contexto;
+    Resultado r = Resultado_procesado();
+    if (evento == EV_RESET){
+        MaquinaJerarquica__entra(self,NULL,self->estadoInicial);
+        return r;
+    }
+    EstadoJerarquico const *origen = self->estadoActual;
+    r = Resultado_ignorado();
+    for (;origen;origen = origen->padre){
+        if (origen->procesa) r = origen->procesa(contexto,evento);
+        if (Resultado_getCodigo(r) != RES_IGNORADO) break;
+    }
+    if (Resultado_getCodigo(r) == RES_TRANSICION){
+        EstadoJerarquico const *const destino = self->destino;
+        EstadoJerarquico const *const comun = (origen == destino) ? origen->padre
+                                              : MaquinaJerarquica__ancestroComun(origen,destino);
+        MaquinaJerarquica__saleHasta(self,self->estadoActual,origen);
+        MaquinaJerarquica__saleHasta(self,origen,comun);
+        MaquinaJerarquica__entra(self,comun,destino);
+        r = Resultado_procesado();
+    }
+    return r;
+}
+
+#if MAX_EV_COLA
+void MaquinaJerarquica_init(MaquinaJerarquica *self, EstadoJerarquico const *estadoInicial){
+    MaquinaJerarquica_initConCola(self,estadoInicial,self->maquina.colaInterna,MAX_EV_COLA);
+}
+#endif
+
+bool MaquinaJerarquica_initConCola(MaquinaJerarquica *self, EstadoJerarquico const *estadoInicial, LugarCola *lugares, uint32_t capacidad){
+    self->estadoInicial = estadoInicial;
+    self->estadoActual = NULL;
+    self->destino = NULL;
+    return Maquina_initConCola(&self->maquina,MaquinaJerarquica__procesa,lugares,capacidad);
+}
+
+Maquina *MaquinaJerarquica_asMaquina(MaquinaJerarquica *self){
+    return &self->maquina;
+}
+
+EstadoJerarquico const *MaquinaJerarquica_getEstado(MaquinaJerarquica const *self){
+    return self->estadoActual;
+}
+
+bool MaquinaJerarquica_enEstado(MaquinaJerarquica const *self, EstadoJerarquico const *estado){
+    EstadoJerarquico const *e = self->estadoActual;
+    while (e && e != estado) e = e->padre;
+    return e != NULL;
+}
+
+Resultado MaquinaJerarquica_transicion(Maquina *contexto, EstadoJerarquico const *destino){
+    ((MaquinaJerarquica*)contexto)->destino = destino;
+    return Resultado_transicion(MaquinaJerarquica__procesa);   //MaquinaJerarquica__procesa la convierte en RES_PROCESADO
+}
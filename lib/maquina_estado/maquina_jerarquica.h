@@ -0,0 +1,124 @@
+#ifndef MAQUINA_JERARQUICA_H
+#define MAQUINA_JERARQUICA_H
+
+#include <maquina_estado.h>
+
+/**
+ * @brief Máxima profundidad de anidamiento de estados (cantidad de
+ * estados desde el más externo hasta una hoja, inclusive)
+ */
+#ifndef MAQUINA_JERARQUICA_PROFUNDIDAD
+#define MAQUINA_JERARQUICA_PROFUNDIDAD 4
+#endif
+
+typedef struct EstadoJerarquico EstadoJerarquico;
+
+/**
+ * @brief Acción de entrada o salida de un estado
+ *
+ * @param contexto Máquina que cambia de estado
+ */
+typedef void (*MaquinaJerarquica_Accion)(Maquina *contexto);
+
+/**
+ * @brief Estado de una máquina jerárquica. Se declara constante
+ * (en flash). Todos los campos salvo padre pueden ser nulos
+ */
+struct EstadoJerarquico{
+    EstadoJerarquico const *padre;      //Estado que lo contiene (nulo: estado más externo)
+    /**
+     * @brief Procesa eventos. Si devuelve RES_IGNORADO el evento pasa
+     * al estado padre. Para cambiar de estado devuelve el resultado de
+     * MaquinaJerarquica_transicion
+     */
+    Estado procesa;
+    MaquinaJerarquica_Accion entrada;   //Se ejecuta al entrar al estado
+    MaquinaJerarquica_Accion salida;    //Se ejecuta al salir del estado
+    EstadoJerarquico const *inicial;    //Subestado al que se entra luego de entrar a este (nulo: estado hoja)
+};
+
+/**
+ * @brief Máquina de estado jerárquica. Usa la cola y el procesamiento
+ * de Maquina: se despachan eventos con Maquina_despacha y se procesan
+ * con Maquina_procesa.
+ *
+ * Un evento se entrega primero al estado actual (siempre una hoja) y
+ * luego a sus ancestros mientras lo ignoren. En una transición se
+ * sale desde el estado actual hasta el ancestro común más profundo
+ * del estado que la origina y del destino, se entra desde allí hasta
+ * el destino y se siguen los subestados iniciales. Una transición de
+ * un estado a sí mismo sale y vuelve a entrar a ese estado.
+ *
+ * EV_RESET no se entrega a los estados: pasa a la configuración
+ * inicial ejecutando solo las acciones de entrada, desde el estado
+ * más externo. Las inicializaciones van en la entrada de ese estado.
+ *
+ * No usa recursión ni memoria dinámica.
+ */
+typedef struct MaquinaJerarquica{
+    Maquina maquina;
+    EstadoJerarquico const *estadoInicial;
+    EstadoJerarquico const *estadoActual;
+    EstadoJerarquico const *destino;    //Destino de la transición en curso
+}MaquinaJerarquica;
+
+#if MAX_EV_COLA
+/**
+ * @brief Inicializa una máquina de estado jerárquica con la cola
+ * interna de Maquina
+ *
+ * @param self Este objeto
+ * @param estadoInicial Estado al que se entra con EV_RESET
+ */
+void MaquinaJerarquica_init(MaquinaJerarquica *self, EstadoJerarquico const *estadoInicial);
+#endif
+
+/**
+ * @brief Inicializa una máquina de estado jerárquica con una cola
+ * propia (ver Maquina_initConCola)
+ *
+ * @param self Este objeto
+ * @param estadoInicial Estado al que se entra con EV_RESET
+ * @param lugares Lugares de la cola
+ * @param capacidad Cantidad de lugares, potencia de 2
+ * @return true Máquina iniciada
+ * @return false Capacidad inválida
+ */
+bool MaquinaJerarquica_initConCola(MaquinaJerarquica *self, EstadoJerarquico const *estadoInicial, LugarCola *lugares, uint32_t capacidad);
+
+/**
+ * @brief Máquina de estado jerárquica como Maquina
+ *
+ * @param self Este objeto
+ * @return Maquina* Este objeto como máquina de estado
+ */
+Maquina *MaquinaJerarquica_asMaquina(MaquinaJerarquica *self);
+
+/**
+ * @brief Obtiene el estado actual
+ *
+ * @param self Este objeto
+ * @return EstadoJerarquico const* Estado hoja actual (nulo antes de EV_RESET)
+ */
+EstadoJerarquico const *MaquinaJerarquica_getEstado(MaquinaJerarquica const *self);
+
+/**
+ * @brief Indica si el estado actual está contenido en un estado
+ *
+ * @param self Este objeto
+ * @param estado Estado a consultar
+ * @return true El estado actual es estado o uno de sus subestados
+ * @return false En otro caso
+ */
+bool MaquinaJerarquica_enEstado(MaquinaJerarquica const *self, EstadoJerarquico const *estado);
+
+/**
+ * @brief Resultado a devolver desde procesa para cambiar de estado
+ *
+ * @param contexto Máquina que procesa el evento
+ * @param destino Estado destino
+ * @return Resultado Código RES_TRANSICION
+ */
+Resultado MaquinaJerarquica_transicion(Maquina *contexto, EstadoJerarquico const *destino);
+
+#endif
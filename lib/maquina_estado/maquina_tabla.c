@@ -0,0 +1,42 @@
+#include "maquina_tabla.h"
+#include "maquina_estado_impl.h"
+
+/**
+ * @brief Único estado (en términos de Maquina) de toda máquina por
+ * tabla: resuelve el evento con la tabla de la definición
+ *
+ */
+static Resultado MaquinaTabla__procesa(Maquina *contexto, Evento evento){
+    MaquinaTabla *const self = (MaquinaTabla*)contexto;
+    MaquinaTabla_Definicion const *const definicion = self->definicion;
+    unsigned const columna = MT_EVENTO(evento);
+    Resultado r = Resultado_ignorado();
+    if (evento == EV_RESET) self->estado = definicion->estadoInicial;
+    if (columna < definicion->numEventos){
+        MaquinaTabla_Transicion const t = definicion->transiciones[self->estado * definicion->numEventos + columna];
+        if (t.accion) definicion->acciones[t.accion - 1](contexto,evento);
+        if (t.siguiente) self->estado = t.siguiente - 1;
+        if (t.accion || t.siguiente) r = Resultado_procesado();
+    }
+    return r;
+}
+
+#if MAX_EV_COLA
+void MaquinaTabla_init(MaquinaTabla *self, MaquinaTabla_Definicion const *definicion){
+    MaquinaTabla_initConCola(self,definicion,self->maquina.colaInterna,MAX_EV_COLA);
+}
+#endif
+
+bool MaquinaTabla_initConCola(MaquinaTabla *self, MaquinaTabla_Definicion const *definicion, LugarCola *lugares, uint32_t capacidad){
+    self->definicion = definicion;
+    self->estado = definicion->estadoInicial;
+    return Maquina_initConCola(&self->maquina,MaquinaTabla__procesa,lugares,capacidad);
+}
+
+Maquina *MaquinaTabla_asMaquina(MaquinaTabla *self){
+    return &self->maquina;
+}
+
+uint8_t MaquinaTabla_getEstado(MaquinaTabla const *self){
+    return self->estado;
+}
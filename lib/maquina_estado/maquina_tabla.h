@@ -0,0 +1,117 @@
+#ifndef MAQUINA_TABLA_H
+#define MAQUINA_TABLA_H
+
+#include <maquina_estado.h>
+#include <stdint.h>
+
+/**
+ * @brief Acción de una transición de una máquina de estado por tabla
+ *
+ * @param contexto Máquina que procesa el evento
+ * @param evento Evento procesado
+ */
+typedef void (*MaquinaTabla_Accion)(Maquina *contexto, Evento evento);
+
+/**
+ * @brief Celda de la tabla de transiciones: qué hacer con un evento
+ * en un estado. Una celda en cero significa evento ignorado. Usar las
+ * macros MT_xxx para construirlas
+ */
+typedef struct MaquinaTabla_Transicion{
+    uint8_t accion;     //Índice de la acción + 1 (0: sin acción)
+    uint8_t siguiente;  //Estado siguiente + 1 (0: permanece en el estado)
+}MaquinaTabla_Transicion;
+
+/**
+ * @brief Columna de la tabla correspondiente a un evento
+ */
+#define MT_EVENTO(evento) ((evento) - EV_RESET)
+
+/**
+ * @brief Evento ignorado en el estado
+ */
+#define MT_IGNORADO {0,0}
+
+/**
+ * @brief Ejecuta una acción y permanece en el estado
+ */
+#define MT_ACCION(accion) {(accion) + 1, 0}
+
+/**
+ * @brief Ejecuta una acción y cambia de estado
+ */
+#define MT_TRANSICION(accion, siguiente) {(accion) + 1, (siguiente) + 1}
+
+/**
+ * @brief Cambia de estado sin ejecutar acciones
+ */
+#define MT_SALTO(siguiente) {0, (siguiente) + 1}
+
+/**
+ * @brief Definición constante (en flash) de una máquina de estado
+ * por tabla. La tabla es densa: una fila por estado y una columna
+ * por evento, desde EV_RESET hasta EV_RESET + numEventos - 1
+ */
+typedef struct MaquinaTabla_Definicion{
+    MaquinaTabla_Transicion const *transiciones;    //Tabla de numEstados x numEventos celdas, por filas
+    MaquinaTabla_Accion const *acciones;            //Acciones referidas desde las celdas
+    uint8_t numEventos;                             //Columnas de la tabla
+    uint8_t estadoInicial;                          //Estado al procesar EV_RESET
+}MaquinaTabla_Definicion;
+
+/**
+ * @brief Máquina de estado por tabla. Usa la cola y el procesamiento
+ * de Maquina: se despachan eventos con Maquina_despacha y se procesan
+ * con Maquina_procesa. Cada evento se resuelve con una sola lectura
+ * indexada de la tabla en lugar de una función por estado.
+ *
+ * En EV_RESET la máquina vuelve al estado inicial y luego consulta
+ * la celda [estadoInicial][EV_RESET].
+ */
+typedef struct MaquinaTabla{
+    Maquina maquina;
+    MaquinaTabla_Definicion const *definicion;
+    uint8_t estado;
+}MaquinaTabla;
+
+#if MAX_EV_COLA
+/**
+ * @brief Inicializa una máquina de estado por tabla con la cola
+ * interna de Maquina
+ *
+ * @param self Este objeto
+ * @param definicion Tabla de transiciones y acciones
+ */
+void MaquinaTabla_init(MaquinaTabla *self, MaquinaTabla_Definicion const *definicion);
+#endif
+
+/**
+ * @brief Inicializa una máquina de estado por tabla con una cola
+ * propia (ver Maquina_initConCola)
+ *
+ * @param self Este objeto
+ * @param definicion Tabla de transiciones y acciones
+ * @param lugares Lugares de la cola
+ * @param capacidad Cantidad de lugares, potencia de 2
+ * @return true Máquina iniciada
+ * @return false Capacidad inválida
+ */
+bool MaquinaTabla_initConCola(MaquinaTabla *self, MaquinaTabla_Definicion const *definicion, LugarCola *lugares, uint32_t capacidad);
+
+/**
+ * @brief Máquina de estado por tabla como Maquina
+ *
+ * @param self Este objeto
+ * @return Maquina* Este objeto como máquina de estado
+ */
+Maquina *MaquinaTabla_asMaquina(MaquinaTabla *self);
+
+/**
+ * @brief Obtiene el estado actual
+ *
+ * @param self Este objeto
+ * @return uint8_t Fila de la tabla correspondiente al estado actual
+ */
+uint8_t MaquinaTabla_getEstado(MaquinaTabla const *self);
+
+#endif
@@ -0,0 +1,127 @@
+#include "planificador.h"
+#include <stddef.h>
+#include <stm32f1xx.h>
+
+/*
+ * El mapa de bits se modifica desde el lazo principal y desde las
+ * interrupciones que despachan eventos, por lo que cada cambio es
+ * una lectura-modificación-escritura exclusiva (LDREX/STREX) en
+ * lugar de una sección con interrupciones deshabilitadas.
+ *
+ * En modo expropiativo "activo" es la prioridad + 1 de la máquina en
+ * ejecución (0: ninguna). Cada despacho a una máquina de prioridad
+ * mayor solicita la expropiación; la rutina de expropiación procesa
+ * las máquinas más prioritarias que la activa y al terminar restaura
+ * el nivel anterior, volviendo a solicitar la expropiación si mientras
+ * tanto quedó lista una máquina que supera ese nivel.
+ */
+
+/**
+ * @brief Prioridad + 1 de la máquina lista más prioritaria (0: ninguna)
+ */
+static uint32_t Planificador__nivelListo(Planificador const *self){
+    return 32U - __CLZ(self->listas);
+}
+
+void Planificador_marcaLista(Planificador *self, unsigned prioridad){
+    Planificador_marcaListas(self,1UL << prioridad);
+}
+
+void Planificador_marcaListas(Planificador *self, uint32_t conjunto){
+    uint32_t listas;
+    do{
+        listas = __LDREXW(&self->listas);
+    }while(__STREXW(listas | conjunto,&self->listas));
+    if (self->solicitaExpropiacion && 32U - __CLZ(conjunto) > self->activo) self->solicitaExpropiacion();
+}
+
+static void Planificador__desmarca(Planificador *self, unsigned prioridad){
+    uint32_t const bit = 1UL << prioridad;
+    uint32_t listas;
+    do{
+        listas = __LDREXW(&self->listas);
+    }while(__STREXW(listas & ~bit,&self->listas));
+}
+
+/**
+ * @brief Vuelve al nivel anterior a una ejecución o bloqueo
+ */
+static void Planificador__restaura(Planificador *self, uint32_t anterior){
+    self->activo = anterior;
+    if (self->solicitaExpropiacion && Planificador__nivelListo(self) > anterior) self->solicitaExpropiacion();
+}
+
+void Planificador_init(Planificador *self){
+    Planificador_initExpropiativo(self,NULL);
+}
+
+void Planificador_initExpropiativo(Planificador *self, void (*solicitaExpropiacion)(void)){
+    self->listas = 0;
+    self->activo = 0;
+    self->solicitaExpropiacion = solicitaExpropiacion;
+    for (unsigned i=0;i<PLANIFICADOR_NUM_PRIORIDADES;++i){
+        self->maquinas[i] = NULL;
+    }
+}
+
+bool Planificador_registra(Planificador *self, Maquina *maquina, unsigned prioridad){
+    bool hecho = false;
+    if (prioridad < PLANIFICADOR_NUM_PRIORIDADES && !self->maquinas[prioridad]){
+        self->maquinas[prioridad] = maquina;
+        maquina->prioridad = prioridad;
+        maquina->planificador = self;
+        if (Maquina_hayEventosPendientes(maquina)) Planificador_marcaLista(self,prioridad);
+        hecho = true;
+    }
+    return hecho;
+}
+
+/**
+ * @brief Procesa un evento de la máquina de una prioridad. Desmarca
+ * la máquina si quedó sin eventos
+ */
+static bool Planificador__ejecuta(Planificador *self, unsigned prioridad){
+    Maquina *const maquina = self->maquinas[prioridad];
+    bool const procesado = Maquina_procesa(maquina);
+    if (!Maquina_hayEventosPendientes(maquina)){
+        Planificador__desmarca(self,prioridad);
+        if (Maquina_hayEventosPendientes(maquina)) Planificador_marcaLista(self,prioridad); //Despachado entre la consulta y el desmarcado
+    }
+    return procesado;
+}
+
+bool Planificador_procesa(Planificador *self){
+    bool procesado = false;
+    uint32_t nivel;
+    while (!procesado && (nivel = Planificador__nivelListo(self)) != 0){    //Una máquina lista puede haberse vaciado fuera del planificador
+        uint32_t const anterior = self->activo;
+        self->activo = nivel;
+        procesado = Planificador__ejecuta(self,nivel - 1);
+        Planificador__restaura(self,anterior);
+    }
+    return procesado;
+}
+
+void Planificador_expropia(Planificador *self){
+    uint32_t const anterior = self->activo;
+    uint32_t nivel;
+    while ((nivel = Planificador__nivelListo(self)) > anterior){
+        self->activo = nivel;
+        Planificador__ejecuta(self,nivel - 1);
+    }
+    Planificador__restaura(self,anterior);
+}
+
+uint32_t Planificador_bloquea(Planificador *self, unsigned techo){
+    uint32_t const anterior = self->activo;
+    if (techo >= anterior) self->activo = techo + 1;
+    return anterior;
+}
+
+void Planificador_desbloquea(Planificador *self, uint32_t anterior){
+    Planificador__restaura(self,anterior);
+}
+
+bool Planificador_hayListas(Planificador const *self){
+    return self->listas != 0;
+}
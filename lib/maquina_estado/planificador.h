@@ -0,0 +1,138 @@
+#ifndef PLANIFICADOR_H
+#define PLANIFICADOR_H
+
+#include <maquina_estado.h>
+
+/**
+ * @brief Cantidad de prioridades distintas (una máquina por prioridad)
+ */
+#define PLANIFICADOR_NUM_PRIORIDADES 32
+
+/**
+ * @brief Planificador de máquinas de estado. Cada
+ * máquina registrada tiene una prioridad única; cada despacho marca
+ * la máquina como lista en un mapa de bits y Planificador_procesa
+ * elige la máquina lista de mayor prioridad contando ceros a la
+ * izquierda (CLZ), en tiempo constante. Cada evento se procesa hasta
+ * terminar.
+ *
+ * En modo cooperativo (Planificador_init) las máquinas solo se
+ * ejecutan dentro de Planificador_procesa. En modo expropiativo
+ * (Planificador_initExpropiativo, al estilo del núcleo QK) un despacho
+ * a una máquina de mayor prioridad que la que se está ejecutando
+ * solicita la expropiación, y la rutina de expropiación (que debe
+ * llamar a Planificador_expropia) procesa las máquinas más
+ * prioritarias sobre la misma pila antes de volver a la expropiada.
+ */
+struct Planificador{
+    /**
+     * @brief Bit p en 1: la máquina de prioridad p tiene eventos en cola
+     */
+    volatile uint32_t listas;
+    /**
+     * @brief Prioridad + 1 de la máquina en ejecución o techo de un
+     * bloqueo (0: ninguna)
+     */
+    volatile uint32_t activo;
+    void (*solicitaExpropiacion)(void);     //Nulo: modo cooperativo
+    Maquina *maquinas[PLANIFICADOR_NUM_PRIORIDADES];
+};
+
+/**
+ * @brief Inicializa el planificador sin máquinas registradas
+ *
+ * @param self Este objeto
+ */
+void Planificador_init(Planificador *self);
+
+/**
+ * @brief Inicializa el planificador en modo expropiativo, sin máquinas
+ * registradas
+ *
+ * @param self Este objeto
+ * @param solicitaExpropiacion Solicita la ejecución diferida de la
+ * rutina de expropiación (por ejemplo SP_Expropiacion_solicita, que
+ * pone pendiente PendSV). Puede ser llamada desde interrupciones
+ */
+void Planificador_initExpropiativo(Planificador *self, void (*solicitaExpropiacion)(void));
+
+/**
+ * @brief Registra una máquina de estado. Debe llamarse después de
+ * Maquina_init. Si la máquina ya tiene eventos en cola queda lista
+ *
+ * @param self Este objeto
+ * @param maquina Máquina a registrar
+ * @param prioridad Prioridad, de 0 (menor) a PLANIFICADOR_NUM_PRIORIDADES - 1 (mayor)
+ * @return true Máquina registrada
+ * @return false Prioridad fuera de rango u ocupada por otra máquina
+ */
+bool Planificador_registra(Planificador *self, Maquina *maquina, unsigned prioridad);
+
+/**
+ * @brief Procesa un evento de la máquina lista de mayor prioridad
+ *
+ * @param self Este objeto
+ * @return true Se procesó un evento
+ * @return false Ninguna máquina tenía eventos
+ */
+bool Planificador_procesa(Planificador *self);
+
+/**
+ * @brief Procesa, hasta vaciar sus colas, las máquinas listas de
+ * prioridad mayor que la activa. Debe llamarse desde la rutina de
+ * expropiación (modo expropiativo)
+ *
+ * @param self Este objeto
+ */
+void Planificador_expropia(Planificador *self);
+
+/**
+ * @brief Impide que las máquinas de prioridad menor o igual a techo
+ * expropien al código que llama, para proteger datos compartidos con
+ * ellas (techo de prioridad). Sin efecto en modo cooperativo
+ *
+ * @param self Este objeto
+ * @param techo Mayor prioridad de las máquinas que comparten los datos
+ * @return uint32_t Nivel anterior, para Planificador_desbloquea
+ */
+uint32_t Planificador_bloquea(Planificador *self, unsigned techo);
+
+/**
+ * @brief Termina un bloqueo. Si mientras tanto quedaron listas
+ * máquinas de mayor prioridad, se ejecutan
+ *
+ * @param self Este objeto
+ * @param anterior Valor devuelto por Planificador_bloquea
+ */
+void Planificador_desbloquea(Planificador *self, uint32_t anterior);
+
+/**
+ * @brief Indica si alguna máquina registrada tiene eventos en cola
+ *
+ * @param self Este objeto
+ * @return true Hay máquinas listas
+ * @return false Todas las colas están vacías
+ */
+bool Planificador_hayListas(Planificador const *self);
+
+/**
+ * @brief Marca como lista la máquina de una prioridad y en modo
+ * expropiativo solicita la expropiación si supera a la activa. Lo
+ * llama Maquina_despacha; puede llamarse desde interrupciones
+ *
+ * @param self Este objeto
+ * @param prioridad Prioridad de la máquina
+ */
+void Planificador_marcaLista(Planificador *self, unsigned prioridad);
+
+/**
+ * @brief Marca como listas varias máquinas con una sola escritura del
+ * mapa de bits y en modo expropiativo solicita la expropiación si
+ * alguna supera a la activa. Puede llamarse desde interrupciones
+ *
+ * @param self Este objeto
+ * @param conjunto Máquinas a marcar (bit p: máquina de prioridad p)
+ */
+void Planificador_marcaListas(Planificador *self, uint32_t conjunto);
+
+#endif
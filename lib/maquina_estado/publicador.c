@@ -0,0 +1,67 @@
+#include "publicador.h"
+#include <stddef.h>
+#include <stm32f1xx.h>
+
+/*
+ * Las suscripciones se hacen al iniciar, antes de publicar, por lo que
+ * la tabla no se protege. Cada publicación encola con
+ * Maquina_despachaBloqueado dentro de su propia sección crítica, lo
+ * que también la ordena con los despachos de las interrupciones.
+ */
+
+void Publicador_init(Publicador *self, Planificador *planificador){
+    self->planificador = planificador;
+    for (unsigned i=0;i<PUBLICADOR_NUM_EVENTOS;++i){
+        self->suscriptores[i] = 0;
+    }
+}
+
+/**
+ * @brief Indica si la máquina está registrada en el planificador del
+ * publicador
+ */
+static bool Publicador__qRegistrada(Publicador const *self, Maquina const *maquina){
+    return maquina->planificador == self->planificador
+        && maquina->prioridad < PLANIFICADOR_NUM_PRIORIDADES
+        && self->planificador->maquinas[maquina->prioridad] == maquina;
+}
+
+bool Publicador_suscribe(Publicador *self, Evento evento, Maquina const *maquina){
+    bool hecho = false;
+    if (evento < PUBLICADOR_NUM_EVENTOS && EV_NULO != evento && Publicador__qRegistrada(self,maquina)){
+        self->suscriptores[evento] |= 1UL << maquina->prioridad;
+        hecho = true;
+    }
+    return hecho;
+}
+
+bool Publicador_desuscribe(Publicador *self, Evento evento, Maquina const *maquina){
+    bool hecho = false;
+    if (evento < PUBLICADOR_NUM_EVENTOS && Publicador__qRegistrada(self,maquina)){
+        uint32_t const bit = 1UL << maquina->prioridad;
+        hecho = (self->suscriptores[evento] & bit) != 0;
+        self->suscriptores[evento] &= ~bit;
+    }
+    return hecho;
+}
+
+uint32_t Publicador_publica(Publicador *self, Evento evento){
+    uint32_t entregados = 0;
+    uint32_t pendientes = Publicador_getSuscriptores(self,evento);
+    if (pendientes){
+        __disable_irq();
+        do{
+            unsigned const prioridad = 31U - __CLZ(pendientes);
+            uint32_t const bit = 1UL << prioridad;
+            pendientes &= ~bit;
+            if (Maquina_despachaBloqueado(self->planificador->maquinas[prioridad],evento)) entregados |= bit;
+        }while (pendientes);
+        if (entregados) Planificador_marcaListas(self->planificador,entregados);
+        __enable_irq();                                 //En modo expropiativo la expropiación corre al habilitar
+    }
+    return entregados;
+}
+
+uint32_t Publicador_getSuscriptores(Publicador const *self, Evento evento){
+    return (evento < PUBLICADOR_NUM_EVENTOS) ? self->suscriptores[evento] : 0;
+}
@@ -0,0 +1,85 @@
+#ifndef PUBLICADOR_H
+#define PUBLICADOR_H
+
+#include <maquina_estado.h>
+#include <planificador.h>
+
+/**
+ * @brief Cantidad de eventos que pueden publicarse (de 0 a
+ * PUBLICADOR_NUM_EVENTOS - 1)
+ */
+#ifndef PUBLICADOR_NUM_EVENTOS
+#define PUBLICADOR_NUM_EVENTOS 32
+#endif
+
+/**
+ * @brief Tabla de suscripciones por evento. Los suscriptores son las
+ * máquinas registradas en un planificador y cada conjunto es un mapa
+ * de bits en el que el bit p es la máquina de prioridad p, de modo
+ * que una publicación recorre solo los suscriptores y escribe en
+ * todas sus colas en una sola sección con interrupciones
+ * deshabilitadas
+ */
+typedef struct Publicador{
+    Planificador *planificador;
+    uint32_t suscriptores[PUBLICADOR_NUM_EVENTOS];
+}Publicador;
+
+/**
+ * @brief Inicializa el publicador sin suscripciones
+ *
+ * @param self Este objeto
+ * @param planificador Planificador donde están registradas las
+ * máquinas suscriptoras
+ */
+void Publicador_init(Publicador *self, Planificador *planificador);
+
+/**
+ * @brief Suscribe una máquina a un evento
+ *
+ * @param self Este objeto
+ * @param evento Evento
+ * @param maquina Máquina registrada en el planificador del publicador
+ * @return true Máquina suscripta
+ * @return false Evento fuera de rango o máquina no registrada en el
+ * planificador
+ */
+bool Publicador_suscribe(Publicador *self, Evento evento, Maquina const *maquina);
+
+/**
+ * @brief Quita la suscripción de una máquina a un evento
+ *
+ * @param self Este objeto
+ * @param evento Evento
+ * @param maquina Máquina suscripta
+ * @return true Suscripción quitada
+ * @return false La máquina no estaba suscripta al evento
+ */
+bool Publicador_desuscribe(Publicador *self, Evento evento, Maquina const *maquina);
+
+/**
+ * @brief Despacha un evento a todas las máquinas suscriptas, de mayor
+ * a menor prioridad, con las interrupciones deshabilitadas una sola
+ * vez, y las marca listas en el planificador con una sola escritura.
+ * Puede llamarse desde interrupciones salvo con MAQUINA_COLA_SPSC
+ * (ver MAQUINA_COLA)
+ *
+ * @param self Este objeto
+ * @param evento Evento a publicar
+ * @return uint32_t Conjunto de suscriptores que recibieron el evento
+ * (bit p: máquina de prioridad p). Falta el bit de las máquinas con la
+ * cola llena
+ */
+uint32_t Publicador_publica(Publicador *self, Evento evento);
+
+/**
+ * @brief Obtiene los suscriptores de un evento
+ *
+ * @param self Este objeto
+ * @param evento Evento
+ * @return uint32_t Conjunto de suscriptores (bit p: máquina de
+ * prioridad p), 0 si el evento está fuera de rango
+ */
+uint32_t Publicador_getSuscriptores(Publicador const *self, Evento evento);
+
+#endif
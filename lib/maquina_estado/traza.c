@@ -0,0 +1,53 @@
+#include "traza.h"
+#include <soporte_placa.h>
+#include <stdint.h>
+#include <stm32f1xx.h>
+
+#if MAQUINA_TRAZA
+
+#if TRAZA_CAPACIDAD & (TRAZA_CAPACIDAD - 1)
+#error TRAZA_CAPACIDAD debe ser potencia de 2
+#endif
+
+/*
+ * Los productores (lazo principal, máquinas expropiativas e
+ * interrupciones) reservan el registro incrementando "escrituras" con
+ * LDREX/STREX y luego lo completan. Un volcado hecho mientras un
+ * productor escribe puede mostrar ese último registro incompleto.
+ */
+
+static Traza traza = {.firma = TRAZA_FIRMA, .capacidad = TRAZA_CAPACIDAD};
+
+static uint16_t Traza__identificador(void const *direccion){
+    return (uint16_t)(uintptr_t)direccion;
+}
+
+static uint16_t Traza__estado(Estado estado){
+    return (uint16_t)(uintptr_t)estado;
+}
+
+void Traza_registra(Maquina const *maquina, Evento evento, unsigned tipo, Estado estadoAnterior, Estado estadoNuevo){
+    uint32_t n;
+    do{
+        n = __LDREXW(&traza.escrituras);
+    }while(__STREXW(n + 1,&traza.escrituras));
+    if (!n) traza.referencia = (uint32_t)(uintptr_t)Traza_registra;
+    traza.registros[n % TRAZA_CAPACIDAD] = (RegistroTraza){
+        .tiempo = SP_Tiempo_getMilisegundos(),
+        .maquina = Traza__identificador(maquina),
+        .estadoAnterior = Traza__estado(estadoAnterior),
+        .estadoNuevo = Traza__estado(estadoNuevo),
+        .evento = (uint8_t)evento,
+        .tipo = (uint8_t)tipo
+    };
+}
+
+void Traza_reinicia(void){
+    traza.escrituras = 0;
+}
+
+Traza const *Traza_get(void){
+    return &traza;
+}
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef TRAZA_H
+#define TRAZA_H
+
+#include <maquina_estado.h>
+#include <stdint.h>
+
+/**
+ * @brief En 1 Maquina_despacha y Maquina_procesa escriben cada despacho
+ * (aceptado o descartado por cola llena) y cada evento procesado en la
+ * traza. En 0 (por defecto) la traza no se compila ni ocupa RAM
+ */
+#ifndef MAQUINA_TRAZA
+#define MAQUINA_TRAZA 0
+#endif
+
+/**
+ * @brief Cantidad de registros de la traza. Debe ser potencia de 2.
+ * Al llenarse se sobrescriben los más antiguos
+ */
+#ifndef TRAZA_CAPACIDAD
+#define TRAZA_CAPACIDAD 64
+#endif
+
+/**
+ * @brief Valor de Traza.firma, para que el decodificador reconozca un
+ * volcado ("TRZ1")
+ */
+#define TRAZA_FIRMA 0x315A5254UL
+
+/**
+ * @brief Tipos de registro
+ */
+enum TipoTraza{
+    TRAZA_DESPACHO,         // Evento aceptado en la cola
+    TRAZA_DESCARTE,         // Evento descartado: cola llena
+    TRAZA_PROCESO           // Evento procesado; estadoAnterior y estadoNuevo válidos
+};
+
+/**
+ * @brief Registro de la traza, 12 bytes. Máquinas y estados se
+ * identifican por los 16 bits bajos de su dirección, que el
+ * decodificador traduce con la tabla de símbolos del programa
+ */
+typedef struct RegistroTraza{
+    uint32_t tiempo;            // SP_Tiempo_getMilisegundos
+    uint16_t maquina;
+    uint16_t estadoAnterior;
+    uint16_t estadoNuevo;
+    uint8_t evento;
+    uint8_t tipo;               // TipoTraza
+}RegistroTraza;
+
+/**
+ * @brief Traza en RAM. Se vuelca a la PC tal como está (por ejemplo con
+ * "dump binary value traza.bin *Traza_get()" en gdb) y se decodifica con
+ * herramientas/decodifica_traza.c
+ */
+typedef struct Traza{
+    uint32_t firma;
+    uint32_t capacidad;
+    uint32_t escrituras;        // Registros escritos desde Traza_reinicia (el último en (escrituras - 1) % capacidad)
+    uint32_t referencia;        // Dirección de Traza_registra, para corregir programas reubicados (PIE)
+    RegistroTraza registros[TRAZA_CAPACIDAD];
+}Traza;
+
+/**
+ * @brief Escribe un registro. Reserva el lugar con LDREX/STREX, sin
+ * deshabilitar interrupciones; puede llamarse desde interrupciones
+ *
+ * @param maquina Máquina destino del evento
+ * @param evento Evento
+ * @param tipo TipoTraza
+ * @param estadoAnterior Estado antes de procesar (TRAZA_PROCESO)
+ * @param estadoNuevo Estado después de procesar (TRAZA_PROCESO)
+ */
+void Traza_registra(Maquina const *maquina, Evento evento, unsigned tipo, Estado estadoAnterior, Estado estadoNuevo);
+
+/**
+ * @brief Vacía la traza
+ */
+void Traza_reinicia(void);
+
+/**
+ * @brief Obtiene la traza, para volcarla
+ *
+ * @return Traza const* Traza
+ */
+Traza const *Traza_get(void);
+
+#endif
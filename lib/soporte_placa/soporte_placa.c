@@ -8,4 +8,7 @@
 
 void SP_init(void){
     SP_Tiempo_init(); 
+#if SP_PERFILADO
+    SP_Perfil_init();
+#endif
 }
\ No newline at end of file
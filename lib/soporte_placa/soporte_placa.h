@@ -4,7 +4,11 @@
 // Espacio de nombres: SP_
 
 #include <soporte_placa/sp_pin.h>
+#include <soporte_placa/sp_puerto.h>
 #include <soporte_placa/sp_tiempo.h>
+#include <soporte_placa/sp_expropiacion.h>
+#include <soporte_placa/sp_perfil.h>
+#include <soporte_placa/sp_serie.h>
 
 // Declaraciones
 
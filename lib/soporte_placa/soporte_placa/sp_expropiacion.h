@@ -0,0 +1,39 @@
+#ifndef SP_EXPROPIACION_H
+#define SP_EXPROPIACION_H
+
+/**
+ * @brief Rutina de expropiación. Se ejecuta en modo hilo (no dentro
+ * de una interrupción), sobre la misma pila y con las interrupciones
+ * habilitadas, interrumpiendo al código del lazo principal o a otra
+ * ejecución de la propia rutina
+ */
+typedef void (*SP_RutinaExpropiacion)(void);
+
+/**
+ * @brief Rutinas de servicio de PendSV y SVCall, usadas para pasar
+ * a la rutina de expropiación y volver de ella
+ * 
+ */
+void PendSV_Handler(void);
+void SVC_Handler(void);
+
+/**
+ * @brief Configura la expropiación: PendSV con la menor prioridad de
+ * interrupción y SVCall con la mayor, para que la rutina corra solo
+ * cuando terminan todas las interrupciones en curso
+ * 
+ * @param rutina Rutina a ejecutar en cada solicitud
+ */
+void SP_Expropiacion_init(SP_RutinaExpropiacion rutina);
+
+/**
+ * @brief Solicita la ejecución de la rutina de expropiación (pone
+ * pendiente PendSV). Si se llama desde una interrupción la rutina
+ * corre al terminar la interrupción; si se llama desde el modo hilo
+ * corre de inmediato. Varias solicitudes antes de que corra la
+ * rutina producen una sola ejecución
+ * 
+ */
+void SP_Expropiacion_solicita(void);
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef SP_PERFIL_H
+#define SP_PERFIL_H
+#include <stdint.h> // uint32_t, uint64_t
+
+/**
+ * @brief En 1 habilita la medición de duración de los estados de las
+ * máquinas (Maquina_procesa) y de los subsistemas instrumentados con
+ * SP_PERFIL_MIDE. En 0 (por defecto) las mediciones no se compilan
+ *
+ */
+#ifndef SP_PERFILADO
+#define SP_PERFILADO 0
+#endif
+
+/**
+ * @brief Cantidad de funciones distintas que puede medir el perfil.
+ * Las mediciones de funciones que no entran se cuentan como descartadas
+ *
+ */
+#ifndef SP_PERFIL_MAX_FUNCIONES
+#define SP_PERFIL_MAX_FUNCIONES 16
+#endif
+
+/**
+ * @brief Cantidad de intervalos del histograma. El intervalo 0 cuenta
+ * las duraciones nulas, el intervalo i (i > 0) las duraciones de 2^(i-1)
+ * a 2^i - 1 cuentas y el último todas las mayores
+ *
+ */
+#define SP_PERFIL_NUM_INTERVALOS 16
+
+/**
+ * @brief Identifica a la función medida (un estado, el procesamiento
+ * de un subsistema, una rutina de interrupción)
+ *
+ */
+typedef void (*SP_PerfilFuncion)(void);
+
+/**
+ * @brief Estadística de duración de una función, en cuentas del
+ * contador de ciclos
+ *
+ */
+typedef struct SP_PerfilEstadistica{
+    SP_PerfilFuncion funcion;
+    uint32_t llamadas;
+    uint32_t minimo;
+    uint32_t maximo;
+    uint64_t total;
+    uint32_t histograma[SP_PERFIL_NUM_INTERVALOS];
+}SP_PerfilEstadistica;
+
+/**
+ * @brief Tabla de estadísticas, en RAM de tamaño fijo. Puede leerse
+ * desde la PC con el depurador o copiarse por un puerto serie
+ *
+ */
+typedef struct SP_Perfil{
+    uint32_t cuentasPorMicrosegundo;    // Ciclos de CPU por microsegundo en la placa, 1000 en la simulación (ns)
+    uint32_t numFunciones;              // Entradas usadas de funciones
+    uint32_t descartadas;               // Mediciones sin lugar en la tabla
+    SP_PerfilEstadistica funciones[SP_PERFIL_MAX_FUNCIONES];
+}SP_Perfil;
+
+/**
+ * @brief Vacía la tabla y pone en marcha el contador de ciclos (DWT
+ * CYCCNT en la placa, reloj monotónico en la simulación). SP_init la
+ * llama si SP_PERFILADO está habilitado
+ *
+ */
+void SP_Perfil_init(void);
+
+/**
+ * @brief Lee el contador de ciclos. Su diferencia entre dos lecturas
+ * (módulo 2^32) es la duración en cuentas
+ *
+ * @return uint32_t Valor actual del contador
+ */
+uint32_t SP_Perfil_getCuenta(void);
+
+/**
+ * @brief Registra una medición de la función indicada, desde el valor
+ * del contador inicio hasta ahora. No deshabilita interrupciones: si
+ * interrumpe a otro registro en curso la medición se descarta. Puede
+ * llamarse desde interrupciones
+ *
+ * @param funcion Función medida
+ * @param inicio Valor de SP_Perfil_getCuenta al comenzar
+ */
+void SP_Perfil_registra(SP_PerfilFuncion funcion, uint32_t inicio);
+
+/**
+ * @brief Obtiene la tabla de estadísticas
+ *
+ * @return SP_Perfil const* Tabla
+ */
+SP_Perfil const *SP_Perfil_get(void);
+
+/**
+ * @brief Busca la estadística de una función
+ *
+ * @param funcion Función medida
+ * @return SP_PerfilEstadistica const* Estadística o NULL si la función
+ * no tiene mediciones
+ */
+SP_PerfilEstadistica const *SP_Perfil_busca(SP_PerfilFuncion funcion);
+
+/**
+ * @brief Duración media de una función
+ *
+ * @param estadistica Estadística de la función
+ * @return uint32_t Duración media en cuentas (0 sin llamadas)
+ */
+uint32_t SP_Perfil_getMedia(SP_PerfilEstadistica const *estadistica);
+
+/**
+ * @brief Ejecuta la sentencia y, con SP_PERFILADO habilitado, registra
+ * su duración a nombre de la función indicada
+ *
+ */
+#if SP_PERFILADO
+#define SP_PERFIL_MIDE(funcion,sentencia) do{ \
+    uint32_t const inicioPerfil__ = SP_Perfil_getCuenta(); \
+    sentencia; \
+    SP_Perfil_registra((SP_PerfilFuncion)(funcion),inicioPerfil__); \
+}while(0)
+#else
+#define SP_PERFIL_MIDE(funcion,sentencia) do{ sentencia; }while(0)
+#endif
+
+#endif
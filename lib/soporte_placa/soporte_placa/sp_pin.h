@@ -2,6 +2,17 @@
 #define SP_PIN_H
 #include <stdbool.h>
 
+/**
+ * @brief En 1 sp_pin.c accede a los pines por la región bit-band del
+ * Cortex-M3: cada lectura o escritura es una sola carga o almacenamiento
+ * en la dirección alias del bit, y SP_Pin_setModo cambia los bits de
+ * CRL/CRH uno por uno sin deshabilitar interrupciones. En 0 (por
+ * defecto) usa IDR, BSRR y una sección crítica. La simulación lo ignora
+ */
+#ifndef SP_PIN_BITBAND
+#define SP_PIN_BITBAND 0
+#endif
+
 /**
  * @brief Handles correspondientes a los pines de entrada/salida, para 
  * usar en el parámetro hPin (primer parámetro) de las funciones SP_Pin_xxx
@@ -141,4 +152,70 @@ bool SP_Pin_setInterrupcion(SP_HPin hPin,SP_Pin_IntFlanco flanco,SP_Pin_IntHandl
  */
 bool SP_Pin_resetInterrupcion(SP_HPin hPin);
 
+/* Camino rápido para handles constantes (solo placa) */
+
+#if !defined(SP_SIMULADO) && defined(__GNUC__)
+#include <stddef.h> // offsetof
+#include <stm32f1xx.h>
+
+/**
+ * @brief Dirección alias en la región bit-band de un bit de un registro
+ * periférico (manual de programación PM0056, sec. 2.2.5)
+ */
+#define SP_PIN__ALIAS_BB(direccion,bit) \
+    ((uint32_t volatile *)(PERIPH_BB_BASE + ((direccion) - PERIPH_BASE)*32u + (bit)*4u))
+
+/**
+ * @brief Dirección base del puerto GPIO de un pin, como expresión
+ * constante si hPin lo es. Mantener en sincronía con la tabla pines de
+ * sp_pin.c
+ */
+#define SP_PIN__BASE(hPin) ((hPin) < SP_PB0 ? GPIOA_BASE : (hPin) < SP_PC13 ? GPIOB_BASE : GPIOC_BASE)
+
+#define SP_PIN__PUERTO(hPin) ((GPIO_TypeDef *)SP_PIN__BASE(hPin))
+
+/**
+ * @brief Número de línea de un pin dentro de su puerto, como expresión
+ * constante si hPin lo es. Mantener en sincronía con la tabla pines de
+ * sp_pin.c (PA13, PA14 y PB2 no tienen handle; PB9 precede a PB8)
+ */
+#define SP_PIN__LINEA(hPin) ( (hPin) <= SP_PA12 ? (hPin)                 \
+                            : (hPin) == SP_PA15 ? 15u                    \
+                            : (hPin) <= SP_PB1  ? (hPin) - SP_PB0        \
+                            : (hPin) <= SP_PB7  ? (hPin) - SP_PB3 + 3u   \
+                            : (hPin) == SP_PB9  ? 9u                     \
+                            : (hPin) == SP_PB8  ? 8u                     \
+                            : (hPin) <= SP_PB15 ? (hPin) - SP_PB10 + 10u \
+                            :                     (hPin) - SP_PC13 + 13u )
+
+static inline bool SP_Pin__readConstante(SP_HPin hPin){
+#if SP_PIN_BITBAND
+    return *SP_PIN__ALIAS_BB(SP_PIN__BASE(hPin) + offsetof(GPIO_TypeDef,IDR),SP_PIN__LINEA(hPin));
+#else
+    return (SP_PIN__PUERTO(hPin)->IDR >> SP_PIN__LINEA(hPin)) & 1u;
+#endif
+}
+
+static inline void SP_Pin__writeConstante(SP_HPin hPin, bool valor){
+    enum {PIN_SET = 0,PIN_RESET = 16};
+    SP_PIN__PUERTO(hPin)->BSRR = 1u << (SP_PIN__LINEA(hPin) + (valor ? PIN_SET : PIN_RESET));
+}
+
+/**
+ * @brief Con un handle constante (por ejemplo SP_Pin_write(SP_PIN_LED,1))
+ * el compilador resuelve puerto y máscara y la escritura queda en un
+ * solo almacenamiento en BSRR (la lectura, en una carga de IDR), sin
+ * llamada ni acceso a la tabla de pines. Con un handle en variable
+ * llaman a la función de sp_pin.c. El ahorro requiere optimización
+ * (-O1, como en platformio.ini) para que las funciones se expandan en
+ * línea
+ */
+#define SP_Pin_read(hPin) \
+    (__builtin_constant_p(hPin) && (SP_HPin)(hPin) < SP_NUM_PINES ? SP_Pin__readConstante(hPin) : (SP_Pin_read)(hPin))
+
+#define SP_Pin_write(hPin,valor) \
+    (__builtin_constant_p(hPin) && (SP_HPin)(hPin) < SP_NUM_PINES ? SP_Pin__writeConstante((hPin),(valor)) : (SP_Pin_write)((hPin),(valor)))
+
+#endif
+
 #endif
\ No newline at end of file
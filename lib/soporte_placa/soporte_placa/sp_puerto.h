@@ -0,0 +1,104 @@
+#ifndef SP_PUERTO_H
+#define SP_PUERTO_H
+#include <stdint.h>
+#include <stdbool.h>
+#include <soporte_placa/sp_pin.h>
+
+/**
+ * @brief Handles correspondientes a los puertos de entrada/salida,
+ * para usar en el parámetro hPuerto de las funciones SP_Puerto_xxx
+ * 
+ */
+enum SP_Puertos{
+    SP_PUERTO_A,
+    SP_PUERTO_B,
+    SP_PUERTO_C,
+    SP_NUM_PUERTOS
+};
+
+/**
+ * @brief Handle que representa un puerto de entrada/salida.
+ * Toma valores de las constantes SP_Puertos
+ */
+typedef unsigned SP_HPuerto;
+
+/**
+ * @brief Lee el buffer de entrada completo de un puerto (IDR) en un
+ * solo acceso
+ * 
+ * @param hPuerto Handle al puerto
+ * @return uint16_t Nivel de las 16 líneas del puerto (bit n: línea n)
+ */
+uint16_t SP_Puerto_read(SP_HPuerto hPuerto);
+
+/**
+ * @brief Obtiene el puerto al que pertenece un pin
+ * 
+ * @param hPin Handle al objeto Pin
+ * @return SP_HPuerto Handle del puerto
+ */
+SP_HPuerto SP_Pin_getPuerto(SP_HPin hPin);
+
+/**
+ * @brief Obtiene el número de línea de un pin dentro de su puerto
+ * 
+ * @param hPin Handle al objeto Pin
+ * @return unsigned Número de línea (0-15)
+ */
+unsigned SP_Pin_getLinea(SP_HPin hPin);
+
+/**
+ * @brief Escribe a la vez un conjunto arbitrario de líneas de un
+ * puerto con un solo almacenamiento en BSRR (atómico, sin
+ * deshabilitar interrupciones). Las líneas fuera de la máscara no
+ * cambian
+ * 
+ * @param hPuerto Handle al puerto
+ * @param mascara Líneas a escribir (bit n: línea n)
+ * @param valores Nivel de cada línea de la máscara (bit n: línea n)
+ */
+void SP_Puerto_writeMascara(SP_HPuerto hPuerto, uint16_t mascara, uint16_t valores);
+
+/**
+ * @brief Cantidad máxima de pines de un grupo
+ * 
+ */
+#define SP_GRUPO_MAX_PINES 16
+
+/**
+ * @brief Grupo de pines que se escriben juntos (por ejemplo las zonas
+ * de iluminación o un panel de indicadores). Lo completa SP_Pines_init
+ * con la ubicación de cada pin y la máscara de cada puerto
+ * 
+ */
+typedef struct SP_GrupoPines{
+    uint16_t mascaras[SP_NUM_PUERTOS];      // Líneas del grupo en cada puerto
+    uint8_t numPines;
+    uint8_t puertos[SP_GRUPO_MAX_PINES];
+    uint8_t lineas[SP_GRUPO_MAX_PINES];
+}SP_GrupoPines;
+
+/**
+ * @brief Inicializa un grupo de pines. Los pines deben estar
+ * configurados como salida con SP_Pin_setModo
+ * 
+ * @param grupo Grupo a inicializar
+ * @param pines Pines del grupo; el pin i corresponde al bit i de los
+ * valores de SP_Pines_write
+ * @param numPines Cantidad de pines (hasta SP_GRUPO_MAX_PINES)
+ * @return true Grupo inicializado
+ * @return false Demasiados pines
+ */
+bool SP_Pines_init(SP_GrupoPines *grupo, SP_HPin const pines[], unsigned numPines);
+
+/**
+ * @brief Escribe todos los pines de un grupo con un solo
+ * almacenamiento por puerto: los pines de un mismo puerto cambian a
+ * la vez
+ * 
+ * @param grupo Grupo de pines
+ * @param valores Nivel de cada pin (bit i: pin i del grupo)
+ */
+void SP_Pines_write(SP_GrupoPines const *grupo, uint32_t valores);
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef SP_SERIE_H
+#define SP_SERIE_H
+#include <stdint.h> // uint32_t
+#include <stddef.h> // size_t
+#include <stdbool.h> // bool
+
+/**
+ * @brief Tamaño del buffer de transmisión en bytes. Debe ser potencia
+ * de 2
+ *
+ */
+#ifndef SP_SERIE_TAM_BUFFER
+#define SP_SERIE_TAM_BUFFER 256
+#endif
+
+/**
+ * @brief Rutina de servicio de interrupción del canal 4 de DMA1
+ *
+ */
+void DMA1_Channel4_IRQHandler(void);
+
+/**
+ * @brief Configura USART1 (TX en PA9; asincrónico, 8 bits de datos,
+ * sin paridad, 1 bit de parada) para transmitir desde un buffer
+ * circular con el canal 4 de DMA1. Vacía el buffer
+ *
+ * @param baudios Velocidad de transmisión
+ */
+void SP_Serie_init(uint32_t baudios);
+
+/**
+ * @brief Copia datos al buffer de transmisión sin esperar: el DMA los
+ * transmite mientras el programa sigue. Si no entran todos se copian
+ * los que entran y el resto se descarta. Un solo productor: llamar
+ * siempre desde el mismo contexto (por ejemplo el lazo principal)
+ *
+ * @param datos Datos a transmitir
+ * @param tamano Cantidad de bytes
+ * @return size_t Bytes aceptados
+ */
+size_t SP_Serie_escribe(void const *datos, size_t tamano);
+
+/**
+ * @brief Lugar libre en el buffer de transmisión
+ *
+ * @return size_t Bytes que SP_Serie_escribe aceptaría ahora
+ */
+size_t SP_Serie_getLibre(void);
+
+/**
+ * @brief Indica si quedan datos por transmitir
+ *
+ * @return true Hay datos en el buffer o en transmisión
+ * @return false Todo lo escrito fue entregado al USART
+ */
+bool SP_Serie_qOcupado(void);
+
+/**
+ * @brief Bytes entregados al USART desde SP_Serie_init
+ *
+ * @return uint32_t Bytes transmitidos
+ */
+uint32_t SP_Serie_getTransmitidos(void);
+
+/**
+ * @brief Bytes descartados por buffer lleno desde SP_Serie_init
+ *
+ * @return uint32_t Bytes descartados
+ */
+uint32_t SP_Serie_getDescartados(void);
+
+#endif
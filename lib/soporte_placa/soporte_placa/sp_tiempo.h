@@ -3,6 +3,36 @@
 #include <stdint.h> // uint32_t
 #include <stdbool.h> // bool
 
+/**
+ * @brief Valor de tiempo que indica "sin límite" (por ejemplo, no hay
+ * eventos programados)
+ * 
+ */
+#define SP_TIEMPO_INDEFINIDO UINT32_MAX
+
+/**
+ * @brief Interrupciones de SysTick por milisegundo: 1 (por defecto), 2,
+ * 4 u 8. Con más de una, los timeouts y SP_Tiempo_delay se cuentan en
+ * ticks de 1000/SP_TIEMPO_TICKS_POR_MILISEGUNDO microsegundos, lo que
+ * reduce el error del milisegundo en curso al programarlos, a cambio de
+ * más interrupciones
+ * 
+ */
+#ifndef SP_TIEMPO_TICKS_POR_MILISEGUNDO
+#define SP_TIEMPO_TICKS_POR_MILISEGUNDO 1
+#endif
+
+#if SP_TIEMPO_TICKS_POR_MILISEGUNDO != 1 && SP_TIEMPO_TICKS_POR_MILISEGUNDO != 2 \
+ && SP_TIEMPO_TICKS_POR_MILISEGUNDO != 4 && SP_TIEMPO_TICKS_POR_MILISEGUNDO != 8
+#error SP_TIEMPO_TICKS_POR_MILISEGUNDO debe ser 1, 2, 4 u 8
+#endif
+
+/**
+ * @brief Duración de un tick de SysTick en microsegundos
+ * 
+ */
+#define SP_TIEMPO_MICROSEGUNDOS_POR_TICK (1000u/SP_TIEMPO_TICKS_POR_MILISEGUNDO)
+
 /**
  * @brief Rutina de servicio de interrupción de timer SysTick
  * 
@@ -18,30 +48,136 @@ void SP_Tiempo_delay(uint32_t tiempo);
 
 typedef void (*SP_TimeoutHandler)(void volatile *param);
 
+/**
+ * @brief Handle de un timeout programado, para cancelarlo. Vale
+ * SP_TIMEOUT_NINGUNO si la programación falló
+ * 
+ */
+typedef uint32_t SP_HTimeout;
+
+#define SP_TIMEOUT_NINGUNO 0u
+
 /**
  * @brief Programa un evento de timeout. Al cumplirse el tiempo 
  * especificado la rutina de servicio de interrupción de SysTick 
  * hará un llamado al handler especificado (EL LLAMADO OCURRE EN
  * MODO HANDLER)
  * 
+ * Los timeouts se guardan en una lista ordenada por vencimiento en la
+ * que cada uno cuenta desde el anterior: SysTick_Handler solo descuenta
+ * el primero, sin importar cuántos haya programados. Programar y
+ * cancelar recorren la lista con interrupciones deshabilitadas
+ * 
  * @param tiempo Tiempo en milisegundos a partir del cual hacer
  * el llamado. Mayor que cero.
  * @param handler Puntero a función handler, que no retorna valor
  * y recibe un parámetro puntero sin tipo (void *)
  * @param param Parámetro puntero sin tipo que será utilizado en
  * el llamado al handler
- * @return true Evento programado
- * @return false Falló la programación del evento (posiblemente por
- * falta de recursos)
+ * @return SP_HTimeout Handle del evento programado (distinto de cero),
+ * o SP_TIMEOUT_NINGUNO si falló la programación (tiempo nulo o falta
+ * de recursos, ver SP_MAX_TIMEOUTS)
+ */
+SP_HTimeout SP_Tiempo_addTimeout(uint32_t tiempo,SP_TimeoutHandler handler,void volatile *param);
+
+/**
+ * @brief Programa un timeout periódico: el handler se llama por primera
+ * vez a los tiempo milisegundos y luego cada periodo milisegundos, sin
+ * acumular atraso, hasta cancelarlo con SP_Tiempo_cancelaTimeout (que
+ * puede llamarse desde el mismo handler)
+ * 
+ * @param tiempo Milisegundos hasta el primer llamado. Mayor que cero
+ * @param periodo Milisegundos entre llamados. Mayor que cero
+ * @param handler Función handler (llamada en modo HANDLER)
+ * @param param Parámetro del handler
+ * @return SP_HTimeout Handle del evento, o SP_TIMEOUT_NINGUNO si falló
+ */
+SP_HTimeout SP_Tiempo_addTimeoutPeriodico(uint32_t tiempo,uint32_t periodo,SP_TimeoutHandler handler,void volatile *param);
+
+/**
+ * @brief Cancela un timeout programado. El recurso queda libre de
+ * inmediato; un handle viejo (de un timeout ya vencido o cancelado) no
+ * afecta a los timeouts programados después
+ * 
+ * @param hTimeout Handle retornado por SP_Tiempo_addTimeout o
+ * SP_Tiempo_addTimeoutPeriodico
+ * @return true Timeout cancelado
+ * @return false El timeout ya venció (si no era periódico) o ya fue
+ * cancelado
  */
-bool SP_Tiempo_addTimeout(uint32_t tiempo,SP_TimeoutHandler handler,void volatile *param);
+bool SP_Tiempo_cancelaTimeout(SP_HTimeout hTimeout);
 
 void SP_Tiempo_init(void);
 
 /**
- * @brief Obtiene el valor actual del contador de milisegundos
+ * @brief Obtiene el valor actual del contador de milisegundos. Da la
+ * vuelta cada 2^32 ms (unos 49 días): comparar siempre diferencias
  * 
  * @return uint32_t Valor actual del contador de milisegundos
  */
 uint32_t SP_Tiempo_getMilisegundos(void);
+
+/**
+ * @brief Obtiene el contador de milisegundos completo, de 64 bits, que
+ * no da la vuelta en la vida útil del equipo
+ * 
+ * @return uint64_t Milisegundos desde SP_init
+ */
+uint64_t SP_Tiempo_getMilisegundos64(void);
+
+/**
+ * @brief Obtiene el tiempo desde SP_init en microsegundos, combinando
+ * el contador de ticks con la cuenta en curso del SysTick (SysTick->VAL).
+ * No deshabilita interrupciones y puede llamarse desde rutinas de
+ * servicio de interrupción; es monótono mientras las interrupciones no
+ * estén deshabilitadas por más de un tick. Desde una interrupción que
+ * interrumpe a SysTick_Handler antes de que sume el tick, el resultado
+ * puede atrasar un tick
+ * 
+ * @return uint64_t Microsegundos desde SP_init
+ */
+uint64_t SP_Tiempo_getMicrosegundos64(void);
+
+/**
+ * @brief Contabilidad del tiempo que el CPU pasó en reposo con
+ * SP_Tiempo_duerme. Permite estimar la fracción de tiempo ociosa
+ * (y con ello el consumo) del programa
+ * 
+ */
+typedef struct SP_Tiempo_Reposo{
+    uint32_t despertares;           // Veces que el CPU salió de reposo
+    uint32_t milisegundosEnReposo;  // Tiempo total con el CPU detenido
+}SP_Tiempo_Reposo;
+
+/**
+ * @brief Detiene el CPU (WFI) hasta la próxima interrupción o hasta
+ * que transcurra el tiempo indicado, lo que ocurra primero. Mientras
+ * tanto el SysTick se reprograma para no interrumpir cada milisegundo;
+ * el contador de milisegundos y los timeouts se actualizan al despertar.
+ * Nunca duerme más allá del próximo timeout programado.
+ * 
+ * Retorna de inmediato si se llamó a SP_Tiempo_despierta desde la
+ * llamada anterior (por ejemplo, una interrupción de pin ocurrida
+ * mientras se procesaban eventos).
+ * 
+ * @param tiempoMaximo Tiempo máximo de reposo en milisegundos, o
+ * SP_TIEMPO_INDEFINIDO para esperar la próxima interrupción
+ */
+void SP_Tiempo_duerme(uint32_t tiempoMaximo);
+
+/**
+ * @brief Indica que hay trabajo pendiente para el lazo principal: la
+ * siguiente llamada a SP_Tiempo_duerme retorna sin detener el CPU.
+ * Puede llamarse desde una rutina de servicio de interrupción. Las
+ * interrupciones de pin y los timeouts la llaman automáticamente.
+ * 
+ */
+void SP_Tiempo_despierta(void);
+
+/**
+ * @brief Obtiene la contabilidad de reposo acumulada desde SP_init
+ * 
+ * @return SP_Tiempo_Reposo Despertares y tiempo en reposo
+ */
+SP_Tiempo_Reposo SP_Tiempo_getReposo(void);
 #endif
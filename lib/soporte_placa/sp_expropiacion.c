@@ -0,0 +1,62 @@
+#include <soporte_placa/sp_expropiacion.h>
+#include <stddef.h>
+#include <stm32f1xx.h>
+
+/* Expropiación con PendSV, al estilo del núcleo QK */
+
+/*
+ * PendSV tiene la menor prioridad, por lo que solo se atiende al
+ * volver al modo hilo. En lugar de ejecutar la rutina dentro del
+ * handler, PendSV_Handler apila un marco de excepción falso cuyo PC
+ * es SP_Expropiacion__ejecuta y retorna: el procesador continúa en
+ * modo hilo con la rutina, que puede ser a su vez interrumpida y
+ * expropiada. Al terminar, la rutina vuelve a SP_Expropiacion__fin
+ * (LR del marco falso), que ejecuta SVC; SVC_Handler descarta el
+ * marco de esa llamada y retorna al marco apilado al entrar en
+ * PendSV, es decir, al código expropiado. Todo corre sobre la pila
+ * principal (MSP).
+ */
+
+static SP_RutinaExpropiacion rutina;
+
+void SP_Expropiacion_init(SP_RutinaExpropiacion const nuevaRutina){
+    rutina = nuevaRutina;
+    NVIC_SetPriority(PendSV_IRQn,(1UL << __NVIC_PRIO_BITS) - 1UL);
+    NVIC_SetPriority(SVCall_IRQn,0);
+}
+
+void SP_Expropiacion_solicita(void){
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+}
+
+__attribute__((used)) static void SP_Expropiacion__ejecuta(void){
+    if (rutina) rutina();
+}
+
+__attribute__((used, naked)) static void SP_Expropiacion__fin(void){
+    __asm volatile(
+        "   svc   #0                        \n"
+        "   b     .                         \n"
+    );
+}
+
+__attribute__((naked)) void PendSV_Handler(void){
+    __asm volatile(
+        "   sub   sp, sp, #32               \n" // Marco falso: r0-r3, r12, lr, pc, xpsr
+        "   ldr   r0, =SP_Expropiacion__fin \n"
+        "   str   r0, [sp, #20]             \n" // lr: retorno de la rutina (bit 0 en 1, thumb)
+        "   ldr   r0, =SP_Expropiacion__ejecuta \n"
+        "   bic   r0, r0, #1                \n"
+        "   str   r0, [sp, #24]             \n" // pc
+        "   mov   r0, #0x01000000           \n"
+        "   str   r0, [sp, #28]             \n" // xpsr: solo el bit T
+        "   bx    lr                        \n" // EXC_RETURN: a modo hilo con el marco falso
+    );
+}
+
+__attribute__((naked)) void SVC_Handler(void){
+    __asm volatile(
+        "   add   sp, sp, #32               \n" // Descarta el marco de SP_Expropiacion__fin
+        "   bx    lr                        \n" // Retorna al código expropiado
+    );
+}
@@ -1,4 +1,5 @@
 #include <soporte_placa/sp_pin.h>
+#include <soporte_placa/sp_puerto.h>
 #include <stm32f1xx.h>
 
 /* GPIO */
@@ -15,55 +16,77 @@ typedef struct Pin{
     GPIO_TypeDef * puerto;
     int nrPin;
     void (*init_especial)(void);
+#if SP_PIN_BITBAND
+    uint32_t volatile *idr; // Alias bit-band del bit del pin en IDR
+    uint32_t volatile *odr; // Alias bit-band del bit del pin en ODR
+    uint32_t volatile *cr;  // Alias de los 4 bits de configuración en CRL/CRH: MODE0, MODE1, CNF0, CNF1
+#endif
 }Pin;
 
+#if SP_PIN_BITBAND
+#define ALIAS(P,n) .idr = SP_PIN__ALIAS_BB(GPIO##P##_BASE + offsetof(GPIO_TypeDef,IDR),n),  \
+                   .odr = SP_PIN__ALIAS_BB(GPIO##P##_BASE + offsetof(GPIO_TypeDef,ODR),n),  \
+                   .cr  = SP_PIN__ALIAS_BB(GPIO##P##_BASE + ((n) < 8 ? offsetof(GPIO_TypeDef,CRL) \
+                                                                   : offsetof(GPIO_TypeDef,CRH)),((n) % 8)*4)
+#else
+#define ALIAS(P,n)
+#endif
+
 // Inicialización especial luego de reset para poder usar PA15 y PB3/7
 static void desactivarJtag(void);
 
 /**
  * @brief pines es un arreglo de 32 elementos, donde cada uno es tipo Pin (Con su puntero a puerto y numero)
+ * SP_PIN__PUERTO y SP_PIN__LINEA (sp_pin.h) repiten esta tabla para los handles constantes
  * 
  */
 
 static Pin const pines[SP_NUM_PINES] = {
-    [SP_PA0 ] = {.puerto = GPIOA, .nrPin = 0 },
-    [SP_PA1 ] = {.puerto = GPIOA, .nrPin = 1 },
-    [SP_PA2 ] = {.puerto = GPIOA, .nrPin = 2 },
-    [SP_PA3 ] = {.puerto = GPIOA, .nrPin = 3 },
-    [SP_PA4 ] = {.puerto = GPIOA, .nrPin = 4 },
-    [SP_PA5 ] = {.puerto = GPIOA, .nrPin = 5 },
-    [SP_PA6 ] = {.puerto = GPIOA, .nrPin = 6 },
-    [SP_PA7 ] = {.puerto = GPIOA, .nrPin = 7 },
-    [SP_PA8 ] = {.puerto = GPIOA, .nrPin = 8 },
-    [SP_PA9 ] = {.puerto = GPIOA, .nrPin = 9 },
-    [SP_PA10] = {.puerto = GPIOA, .nrPin = 10},
-    [SP_PA11] = {.puerto = GPIOA, .nrPin = 11},
-    [SP_PA12] = {.puerto = GPIOA, .nrPin = 12},
-    [SP_PA15] = {.puerto = GPIOA, .nrPin = 15, .init_especial = desactivarJtag},
-    [SP_PB0 ] = {.puerto = GPIOB, .nrPin = 0 },
-    [SP_PB1 ] = {.puerto = GPIOB, .nrPin = 1 },
-    [SP_PB3 ] = {.puerto = GPIOB, .nrPin = 3 , .init_especial = desactivarJtag},
-    [SP_PB4 ] = {.puerto = GPIOB, .nrPin = 4 , .init_especial = desactivarJtag},
-    [SP_PB5 ] = {.puerto = GPIOB, .nrPin = 5 },
-    [SP_PB6 ] = {.puerto = GPIOB, .nrPin = 6 },
-    [SP_PB7 ] = {.puerto = GPIOB, .nrPin = 7 },
-    [SP_PB9 ] = {.puerto = GPIOB, .nrPin = 9 },
-    [SP_PB8 ] = {.puerto = GPIOB, .nrPin = 8 },
-    [SP_PB10] = {.puerto = GPIOB, .nrPin = 10},
-    [SP_PB11] = {.puerto = GPIOB, .nrPin = 11},
-    [SP_PB12] = {.puerto = GPIOB, .nrPin = 12},
-    [SP_PB13] = {.puerto = GPIOB, .nrPin = 13},
-    [SP_PB14] = {.puerto = GPIOB, .nrPin = 14},
-    [SP_PB15] = {.puerto = GPIOB, .nrPin = 15},
-    [SP_PC13] = {.puerto = GPIOC, .nrPin = 13},
-    [SP_PC14] = {.puerto = GPIOC, .nrPin = 14},
-    [SP_PC15] = {.puerto = GPIOC, .nrPin = 15},
+    [SP_PA0 ] = {.puerto = GPIOA, .nrPin = 0 , ALIAS(A,0)},
+    [SP_PA1 ] = {.puerto = GPIOA, .nrPin = 1 , ALIAS(A,1)},
+    [SP_PA2 ] = {.puerto = GPIOA, .nrPin = 2 , ALIAS(A,2)},
+    [SP_PA3 ] = {.puerto = GPIOA, .nrPin = 3 , ALIAS(A,3)},
+    [SP_PA4 ] = {.puerto = GPIOA, .nrPin = 4 , ALIAS(A,4)},
+    [SP_PA5 ] = {.puerto = GPIOA, .nrPin = 5 , ALIAS(A,5)},
+    [SP_PA6 ] = {.puerto = GPIOA, .nrPin = 6 , ALIAS(A,6)},
+    [SP_PA7 ] = {.puerto = GPIOA, .nrPin = 7 , ALIAS(A,7)},
+    [SP_PA8 ] = {.puerto = GPIOA, .nrPin = 8 , ALIAS(A,8)},
+    [SP_PA9 ] = {.puerto = GPIOA, .nrPin = 9 , ALIAS(A,9)},
+    [SP_PA10] = {.puerto = GPIOA, .nrPin = 10, ALIAS(A,10)},
+    [SP_PA11] = {.puerto = GPIOA, .nrPin = 11, ALIAS(A,11)},
+    [SP_PA12] = {.puerto = GPIOA, .nrPin = 12, ALIAS(A,12)},
+    [SP_PA15] = {.puerto = GPIOA, .nrPin = 15, .init_especial = desactivarJtag, ALIAS(A,15)},
+    [SP_PB0 ] = {.puerto = GPIOB, .nrPin = 0 , ALIAS(B,0)},
+    [SP_PB1 ] = {.puerto = GPIOB, .nrPin = 1 , ALIAS(B,1)},
+    [SP_PB3 ] = {.puerto = GPIOB, .nrPin = 3 , .init_especial = desactivarJtag, ALIAS(B,3)},
+    [SP_PB4 ] = {.puerto = GPIOB, .nrPin = 4 , .init_especial = desactivarJtag, ALIAS(B,4)},
+    [SP_PB5 ] = {.puerto = GPIOB, .nrPin = 5 , ALIAS(B,5)},
+    [SP_PB6 ] = {.puerto = GPIOB, .nrPin = 6 , ALIAS(B,6)},
+    [SP_PB7 ] = {.puerto = GPIOB, .nrPin = 7 , ALIAS(B,7)},
+    [SP_PB9 ] = {.puerto = GPIOB, .nrPin = 9 , ALIAS(B,9)},
+    [SP_PB8 ] = {.puerto = GPIOB, .nrPin = 8 , ALIAS(B,8)},
+    [SP_PB10] = {.puerto = GPIOB, .nrPin = 10, ALIAS(B,10)},
+    [SP_PB11] = {.puerto = GPIOB, .nrPin = 11, ALIAS(B,11)},
+    [SP_PB12] = {.puerto = GPIOB, .nrPin = 12, ALIAS(B,12)},
+    [SP_PB13] = {.puerto = GPIOB, .nrPin = 13, ALIAS(B,13)},
+    [SP_PB14] = {.puerto = GPIOB, .nrPin = 14, ALIAS(B,14)},
+    [SP_PB15] = {.puerto = GPIOB, .nrPin = 15, ALIAS(B,15)},
+    [SP_PC13] = {.puerto = GPIOC, .nrPin = 13, ALIAS(C,13)},
+    [SP_PC14] = {.puerto = GPIOC, .nrPin = 14, ALIAS(C,14)},
+    [SP_PC15] = {.puerto = GPIOC, .nrPin = 15, ALIAS(C,15)},
 };
 
 static void desactivarJtag(void){
+#if SP_PIN_BITBAND
+    // SWJ_CFG es de solo escritura y se escribe como campo completo: no admite bit-band
+    __disable_irq();
+#endif
     RCC->APB2ENR |= RCC_APB2ENR_AFIOEN;
     AFIO->MAPR = (AFIO->MAPR & ~(AFIO_MAPR_SWJ_CFG_Msk)) | AFIO_MAPR_SWJ_CFG_JTAGDISABLE;
     RCC->APB2ENR &= ~RCC_APB2ENR_AFIOEN;
+#if SP_PIN_BITBAND
+    __enable_irq();
+#endif
 }
 
 /**
@@ -87,13 +110,45 @@ static Pin const * pinDeHandle(SP_HPin hPin){
  */
 static void habilitaRelojPuerto(GPIO_TypeDef const *puerto){
     int const offset_habilitacion = (((uint32_t)(puerto) >> 10) & 0xF);
+#if SP_PIN_BITBAND
+    *SP_PIN__ALIAS_BB(RCC_BASE + offsetof(RCC_TypeDef,APB2ENR),offset_habilitacion) = 1;
+#else
     RCC->APB2ENR |= 1 << offset_habilitacion;
+#endif
 }
 // ... continúa implementación
 
 //CRL: Registro que me permite configurar el modo y la velocidad de los pines 0 a 7 del puerto x
 //CRH: Registro que me permite configurar el modo y la velocidad de los pines 8 a 15 del puerto x
 
+#if SP_PIN_BITBAND
+/**
+ * @brief Escribe los bits de modo de a uno por sus alias bit-band. Cada
+ * almacenamiento es una lectura-modificación-escritura indivisible del
+ * bus, así que una interrupción que configure otro pin del mismo
+ * registro no pierde su cambio. Al pasar a salida se escribe CNF antes
+ * que MODE y al pasar a entrada MODE antes que CNF, para que el pin no
+ * conduzca con una configuración intermedia
+ *
+ * @param pin Puntero a una variable tipo Pin
+ * @param bits_modo Bits de configuración (CNF1 CNF0 MODE1 MODE0)
+ */
+static void config_modo(Pin const *pin, int bits_modo){
+    enum {MODE0,MODE1,CNF0,CNF1};
+    uint32_t volatile *const bits = pin->cr;
+    if (bits_modo & 0b0011){
+        bits[CNF0]  = (bits_modo >> CNF0)  & 1;
+        bits[CNF1]  = (bits_modo >> CNF1)  & 1;
+        bits[MODE0] = (bits_modo >> MODE0) & 1;
+        bits[MODE1] = (bits_modo >> MODE1) & 1;
+    }else{
+        bits[MODE0] = 0;
+        bits[MODE1] = 0;
+        bits[CNF0]  = (bits_modo >> CNF0)  & 1;
+        bits[CNF1]  = (bits_modo >> CNF1)  & 1;
+    }
+}
+#else
 /**
  * @brief Escribe los bits de modo en la posición adecuada
  * de CRL o CRH según el pin
@@ -113,6 +168,7 @@ static void config_modo(Pin const *pin, int bits_modo){
                           | ((bits_modo & mascara)<<offset); //Y les pongo el valor de bits modo
     }
 }
+#endif
 
 void SP_Pin_setModo(SP_HPin hPin,SP_Pin_Modo modo){
     // Ver Manual de referencia de la familia sec. 9.2.1/.
@@ -148,8 +204,10 @@ void SP_Pin_setModo(SP_HPin hPin,SP_Pin_Modo modo){
                                           // que corresponde al pin identificado por hPin. la funcion
                                           // pinDeHandle se encarga de devolver el puntero a dicha estructura.
 
+#if !SP_PIN_BITBAND
     __disable_irq(); // deshabilita las interrupciones durante la ejecucion de la funcion
                     // esto evita que las interrupciones afecten la config. del pin.
+#endif
     
     habilitaRelojPuerto(self->puerto); // la funcion habilitaRelojPuerto habilita el reloj del puerto al que esta
                                        // conectado el pin.
@@ -173,16 +231,22 @@ void SP_Pin_setModo(SP_HPin hPin,SP_Pin_Modo modo){
     // Debiera generar un error
     break;
     }
+#if !SP_PIN_BITBAND
     __enable_irq();
+#endif
 }
 /*
 SP_Pin_read recibe un parametro hPin que debe ser un puntero
 a una estructura de datos que representa un pin de hadware. esta
 funcion debe leer el valor actual del pin y devolverlo como boleano
 */
-bool SP_Pin_read(SP_HPin hPin){
+bool (SP_Pin_read)(SP_HPin hPin){
     Pin const *const pin = pinDeHandle(hPin); 
+#if SP_PIN_BITBAND
+    return *pin->idr; //Alias del bit en IDR: vale 0 o 1
+#else
     return pin->puerto->IDR & (1 << pin->nrPin); //Accedo al registro IDR  del pin, y leo el nrPin-ésimo bit
+#endif
 }
 
 /*
@@ -192,8 +256,67 @@ boleano que representa el valor que se debe escribir en el pin.
 esta funcion debe escribir el valor "valor" en el pin especificado
 por hPin.
 */
-void SP_Pin_write(SP_HPin hPin, bool valor){
+void (SP_Pin_write)(SP_HPin hPin, bool valor){
     enum {PIN_SET = 0,PIN_RESET = 16}; 
     Pin const *const pin = pinDeHandle(hPin);  
+#if SP_PIN_BITBAND
+    *pin->odr = valor; //Alias del bit en ODR
+#else
     pin->puerto->BSRR = 1 << (pin->nrPin + ((valor)? PIN_SET:PIN_RESET)); 
+#endif
+}
+
+
+/* Puertos */
+
+static GPIO_TypeDef * const puertos[SP_NUM_PUERTOS] = {
+    [SP_PUERTO_A] = GPIOA,
+    [SP_PUERTO_B] = GPIOB,
+    [SP_PUERTO_C] = GPIOC,
+};
+
+uint16_t SP_Puerto_read(SP_HPuerto hPuerto){
+    return puertos[hPuerto]->IDR;
+}
+
+SP_HPuerto SP_Pin_getPuerto(SP_HPin hPin){
+    GPIO_TypeDef const *const puerto = pinDeHandle(hPin)->puerto;
+    SP_HPuerto hPuerto = SP_PUERTO_A;
+    while (hPuerto < SP_NUM_PUERTOS - 1 && puertos[hPuerto] != puerto) ++hPuerto;
+    return hPuerto;
+}
+
+unsigned SP_Pin_getLinea(SP_HPin hPin){
+    return pinDeHandle(hPin)->nrPin;
+}
+
+void SP_Puerto_writeMascara(SP_HPuerto hPuerto, uint16_t mascara, uint16_t valores){
+    enum {PIN_RESET = 16};
+    puertos[hPuerto]->BSRR = (uint32_t)(mascara & valores) | ((uint32_t)(mascara & ~valores) << PIN_RESET);
+}
+
+bool SP_Pines_init(SP_GrupoPines *const grupo, SP_HPin const pines[], unsigned const numPines){
+    bool hecho = false;
+    if (numPines <= SP_GRUPO_MAX_PINES){
+        *grupo = (SP_GrupoPines){.numPines = (uint8_t)numPines};
+        for (unsigned i=0;i<numPines;++i){
+            SP_HPuerto const hPuerto = SP_Pin_getPuerto(pines[i]);
+            unsigned const linea = SP_Pin_getLinea(pines[i]);
+            grupo->puertos[i] = (uint8_t)hPuerto;
+            grupo->lineas[i] = (uint8_t)linea;
+            grupo->mascaras[hPuerto] |= 1U << linea;
+        }
+        hecho = true;
+    }
+    return hecho;
+}
+
+void SP_Pines_write(SP_GrupoPines const *const grupo, uint32_t const valores){
+    uint16_t altos[SP_NUM_PUERTOS] = {0};
+    for (unsigned i=0;i<grupo->numPines;++i){
+        if (valores & (1UL << i)) altos[grupo->puertos[i]] |= 1U << grupo->lineas[i];
+    }
+    for (SP_HPuerto hPuerto=0;hPuerto<SP_NUM_PUERTOS;++hPuerto){
+        if (grupo->mascaras[hPuerto]) SP_Puerto_writeMascara(hPuerto,grupo->mascaras[hPuerto],altos[hPuerto]);
+    }
 }
@@ -1,4 +1,5 @@
 #include <soporte_placa/sp_pin.h>
+#include <soporte_placa/sp_tiempo.h>
 #include <stddef.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -303,6 +304,7 @@ static void procesa_exti(SP_LineaExti const linea){
     if (EXTI->PR & mascara){
         SP_DescriptorExti const *const d = descriptores + linea;
         EXTI->PR = mascara; // Limpia bandera
+        SP_Tiempo_despierta();
         if (d->handler) d->handler(d->param);
     }
 }
@@ -0,0 +1,75 @@
+#include <soporte_placa/sp_serie.h>
+#include <stdbool.h> // bool, true, false
+#include <stdint.h>  // uint32_t, uint8_t
+#include <stddef.h>  // size_t
+#include <stm32f1xx.h> // USART1, DMA1, DMA1_Channel4, NVIC_EnableIRQ
+#include <sp_serie_buffer.h>
+
+/* Transmisión serie por DMA */
+
+/*
+ * El DMA consume el buffer circular de sp_serie_buffer.c. Cada
+ * transferencia cubre un tramo contiguo (SP_SerieBuffer_tramo); al
+ * terminar, la interrupción del canal libera el tramo e inicia el
+ * siguiente. El productor solo inicia una transferencia cuando el
+ * canal está detenido, con las interrupciones deshabilitadas para no
+ * competir con la interrupción.
+ */
+
+static uint32_t volatile enCurso;       // Bytes de la transferencia en curso (0: canal detenido)
+
+static void SP_Serie__inicia(void){
+    uint32_t n;
+    uint8_t const *const tramo = SP_SerieBuffer_tramo(&n);
+    enCurso = n;
+    if (n){
+        DMA1_Channel4->CCR &= ~DMA_CCR_EN;
+        DMA1_Channel4->CMAR = (uint32_t)tramo;
+        DMA1_Channel4->CNDTR = n;
+        DMA1_Channel4->CCR |= DMA_CCR_EN;
+    }
+}
+
+void DMA1_Channel4_IRQHandler(void){
+    if (DMA1->ISR & DMA_ISR_TCIF4){
+        DMA1->IFCR = DMA_IFCR_CGIF4;
+        SP_SerieBuffer_libera(enCurso);
+        SP_Serie__inicia();
+    }
+}
+
+void SP_Serie_init(uint32_t const baudios){
+    SystemCoreClockUpdate();
+    RCC->APB2ENR |= RCC_APB2ENR_IOPAEN | RCC_APB2ENR_USART1EN;
+    RCC->AHBENR |= RCC_AHBENR_DMA1EN;
+    GPIOA->CRH = (GPIOA->CRH & ~(0xFUL << GPIO_CRH_MODE9_Pos)) | (0b1011UL << GPIO_CRH_MODE9_Pos); // PA9: función alternativa, push-pull, 50 MHz
+
+    NVIC_DisableIRQ(DMA1_Channel4_IRQn);
+    DMA1_Channel4->CCR = 0;
+    DMA1->IFCR = DMA_IFCR_CGIF4;
+    SP_SerieBuffer_reinicia();
+    enCurso = 0;
+
+    USART1->BRR = (SystemCoreClock + baudios/2) / baudios;
+    USART1->CR3 |= USART_CR3_DMAT;
+    USART1->CR1 |= USART_CR1_TE | USART_CR1_UE;
+
+    DMA1_Channel4->CPAR = (uint32_t)&USART1->DR;
+    DMA1_Channel4->CCR = DMA_CCR_MINC | DMA_CCR_DIR | DMA_CCR_TCIE;   // Memoria a periférico, bytes, sin circular
+    NVIC_EnableIRQ(DMA1_Channel4_IRQn);
+}
+
+size_t SP_Serie_escribe(void const *const datos, size_t const tamano){
+    size_t const n = SP_SerieBuffer_escribe(datos,tamano);
+    if (!enCurso){
+        uint32_t const primask = __get_PRIMASK();           // Puede llamarse con interrupciones ya deshabilitadas
+        __disable_irq();
+        if (!enCurso) SP_Serie__inicia();
+        __set_PRIMASK(primask);
+    }
+    return n;
+}
+
+bool SP_Serie_qOcupado(void){
+    return SP_SerieBuffer_qPendientes() || !(USART1->SR & USART_SR_TC);
+}
@@ -1,18 +1,32 @@
 #include <soporte_placa/sp_tiempo.h>
 #include <stdbool.h> // bool, true, false
 #include <stdint.h>  // uint32_t
-#include <stddef.h>  // size_t
 #include <stm32f1xx.h> // __WFI
+#include <soporte_placa/sp_perfil.h>
+#include <sp_timeouts.h>
 
 /* Temporización */
 
 /**
- * @brief Variable actualizada una vez por milisegundo en el handler
- * de interrupción del timer del sistema (SysTick)
+ * @brief Variable actualizada una vez por tick (SP_TIEMPO_TICKS_POR_MILISEGUNDO
+ * veces por milisegundo) en el handler de interrupción del timer del
+ * sistema (SysTick). Con 64 bits no da la vuelta
  * 
  */
-static uint32_t volatile ticks;
+static uint64_t volatile ticks;
 static uint32_t limiteRedondeo;
+static uint32_t cuentasPorTick;
+static uint32_t cuentasPorMicrosegundo;
+
+/**
+ * @brief Ticks que representa la próxima interrupción de SysTick.
+ * Vale 1 salvo durante un reposo prolongado (ver SP_Tiempo_duerme)
+ * 
+ */
+static uint32_t volatile ticksPorInterrupcion = 1;
+static bool volatile despertarPendiente;
+static uint32_t despertares;
+static uint64_t ciclosEnReposo;
 
 void SP_Tiempo_init(void){
     // Ver documentación CMSIS
@@ -20,71 +34,173 @@ void SP_Tiempo_init(void){
     SystemCoreClockUpdate();
     
     uint32_t const frecuencia_hertz = SystemCoreClock;
-    uint32_t const cuentas_por_milisgundo = frecuencia_hertz/1000;
+    uint32_t const cuentas_por_tick = frecuencia_hertz/(1000*SP_TIEMPO_TICKS_POR_MILISEGUNDO);
 
     // https://arm-software.github.io/CMSIS_5/Core/html/group__SysTick__gr.html#gabe47de40e9b0ad465b752297a9d9f427
-    SysTick_Config(cuentas_por_milisgundo); // Configura SysTick y la interrupción
+    SysTick_Config(cuentas_por_tick); // Configura SysTick y la interrupción
     limiteRedondeo = (SysTick->LOAD+1)/2;
+    cuentasPorTick = cuentas_por_tick;
+    cuentasPorMicrosegundo = frecuencia_hertz/1000000;
+}
+
+/**
+ * @brief Lee el contador de ticks sin deshabilitar interrupciones. La
+ * lectura de 64 bits son dos accesos: si SysTick_Handler lo modificó
+ * entre medio, repite
+ * 
+ * @return uint64_t Ticks desde SP_init
+ */
+static uint64_t leeTicks(void){
+    uint64_t t;
+    do{
+        t = ticks;
+    }while(t != ticks);
+    return t;
 }
 
 void SP_Tiempo_delay(uint32_t tiempo){
-    uint32_t const ticks_inicial = ticks;
-    uint32_t tiempo_transcurrido = ticks - ticks_inicial;
-    if (tiempo < UINT32_MAX && SysTick->VAL < limiteRedondeo) ++tiempo; // Redondeo
-    while(tiempo_transcurrido < tiempo){
+    uint32_t const ticks_inicial = (uint32_t)leeTicks();
+    uint32_t tiempo_transcurrido = 0;
+    uint32_t espera = SP_Timeouts_ticksDeMilisegundos(tiempo);
+    if (espera < UINT32_MAX && SysTick->VAL < limiteRedondeo) ++espera; // Redondeo
+    while(tiempo_transcurrido < espera){
         // https://arm-software.github.io/CMSIS_5/Core/html/group__intrinsic__CPU__gr.html#gaed91dfbf3d7d7b7fba8d912fcbeaad88
         __WFI();
-        tiempo_transcurrido = ticks - ticks_inicial;
+        tiempo_transcurrido = (uint32_t)leeTicks() - ticks_inicial;
     }
 
 }
 
-#ifndef SP_MAX_TIMEOUTS
-#define SP_MAX_TIMEOUTS 4
-#endif
+/**
+ * @brief Vuelve el SysTick al período de un tick luego de un
+ * reposo. Las cuentas entre el vencimiento y la escritura de VAL se
+ * pierden (unos pocos ciclos por reposo)
+ * 
+ */
+static void restablecePeriodo(void){
+    SysTick->LOAD = cuentasPorTick - 1;
+    SysTick->VAL = 0;
+    ticksPorInterrupcion = 1;
+}
+
+void SysTick_Handler(void){
+    uint32_t const transcurrido = ticksPorInterrupcion;
+    if (SysTick->LOAD != cuentasPorTick - 1){ // Fin de un reposo o de su período de ajuste
+        restablecePeriodo();
+    }
+    ticks += transcurrido;
+    uint32_t vencidos;
+    SP_PERFIL_MIDE(SysTick_Handler,vencidos = SP_Timeouts_procesa(transcurrido));
+    if (vencidos) despertarPendiente = true;
+}
+
+uint32_t SP_Tiempo_getMilisegundos(void){
+    return (uint32_t)SP_Tiempo_getMilisegundos64();
+}
 
-typedef struct SP_TimeoutDescriptor{
-    uint32_t volatile tiempo;
-    SP_TimeoutHandler volatile handler;
-    void volatile *volatile  param;
-} SP_TimeoutDescriptor;
+uint64_t SP_Tiempo_getMilisegundos64(void){
+    return leeTicks() / SP_TIEMPO_TICKS_POR_MILISEGUNDO;
+}
 
-SP_TimeoutDescriptor timeoutDescriptors[SP_MAX_TIMEOUTS];
+uint64_t SP_Tiempo_getMicrosegundos64(void){
+    // La interrupción en curso de SysTick termina en el tick
+    // ticks + ticksPorInterrupcion, cuando VAL llega a 0; VAL es la
+    // cantidad de cuentas que faltan. Si el contador ya llegó a 0 y la
+    // interrupción está pendiente (se llamó con interrupciones
+    // deshabilitadas o desde una de mayor prioridad), VAL ya recargó y
+    // cuenta desde ese tick
+    uint64_t t;
+    uint32_t fin, val, recarga;
+    bool pendiente;
+    do{
+        t = ticks;
+        fin = ticksPorInterrupcion;
+        val = SysTick->VAL;
+        pendiente = SCB->ICSR & SCB_ICSR_PENDSTSET_Msk;
+        if (pendiente) val = SysTick->VAL; // Leído después del vencimiento
+        recarga = SysTick->LOAD;
+    }while(t != ticks);
+    uint64_t const microsegundosFin = (t + fin) * SP_TIEMPO_MICROSEGUNDOS_POR_TICK;
+    uint64_t microsegundos;
+    if (!pendiente){
+        microsegundos = microsegundosFin - (val + cuentasPorMicrosegundo - 1) / cuentasPorMicrosegundo;
+    }else{
+        uint32_t const desdeFin = val ? recarga + 1 - val : 0;
+        microsegundos = microsegundosFin + desdeFin / cuentasPorMicrosegundo;
+    }
+    return microsegundos;
+}
 
+void SP_Tiempo_despierta(void){
+    despertarPendiente = true;
+}
 
-bool SP_Tiempo_addTimeout(uint32_t const tiempo,SP_TimeoutHandler const handler,void volatile *const param){
-    bool hecho = false;
+SP_Tiempo_Reposo SP_Tiempo_getReposo(void){
     __disable_irq();
-    for(size_t i=0;i<SP_MAX_TIMEOUTS;++i){
-        SP_TimeoutDescriptor * const td = timeoutDescriptors + i;
-        if (td->tiempo) continue;
-        td->tiempo = tiempo;
-        td->handler = handler;
-        td->param = param;
-        hecho = true;
-        break;
-    }
+    SP_Tiempo_Reposo const reposo = {
+        .despertares = despertares,
+        .milisegundosEnReposo = cuentasPorTick ? ciclosEnReposo / (cuentasPorTick * SP_TIEMPO_TICKS_POR_MILISEGUNDO) : 0
+    };
     __enable_irq();
-    return hecho;
+    return reposo;
 }
 
-static void procesaTimeouts(void){
-    for (size_t i=0;i<SP_MAX_TIMEOUTS;++i){
-        SP_TimeoutDescriptor *const td = timeoutDescriptors + i;
-        if (td->tiempo){
-            const uint32_t tiempo_restante = --td->tiempo;
-            if(!tiempo_restante && td->handler){
-                td->handler(td->param);
-            }
-        } 
-    }
+static uint32_t minimo(uint32_t a, uint32_t b){
+    return (a < b) ? a : b;
 }
 
-void SysTick_Handler(void){
-    ++ticks;
-    procesaTimeouts();
-}
+void SP_Tiempo_duerme(uint32_t const tiempoMaximo){
+    // SysTick es un contador de 24 bits a la frecuencia del CPU. Los
+    // tiempos se cuentan en ticks
+    uint32_t const maximoPorPeriodo = (SysTick_LOAD_RELOAD_Msk + 1) / cuentasPorTick;
+    __disable_irq();
+    uint32_t const tiempo = minimo(minimo(SP_Timeouts_ticksDeMilisegundos(tiempoMaximo),SP_Timeouts_ticksHastaProximo()),maximoPorPeriodo);
+    bool const tickPendiente = SCB->ICSR & SCB_ICSR_PENDSTSET_Msk;
+    if (despertarPendiente || tickPendiente || !tiempo){
+        despertarPendiente = false;
+        __enable_irq();
+        return;
+    }
+    // Un solo período de SysTick cubre lo que falta del tick en curso
+    // más (tiempo-1) ticks completos
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    uint32_t const restante = SysTick->VAL ? SysTick->VAL : 1;
+    uint32_t const periodo = restante + (tiempo - 1) * cuentasPorTick;
+    SysTick->LOAD = periodo - 1;
+    SysTick->VAL = 0;
+    ticksPorInterrupcion = tiempo;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
 
-uint32_t SP_Tiempo_getMilisegundos(void){
-    return ticks;
+    __DSB();
+    __WFI(); // Con PRIMASK activo despierta ante una interrupción pendiente sin atenderla
+
+    uint32_t const ctrl = SysTick->CTRL; // La lectura borra COUNTFLAG
+    SysTick->CTRL = ctrl & ~SysTick_CTRL_ENABLE_Msk;
+    if ((ctrl & SysTick_CTRL_COUNTFLAG_Msk) || (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)){
+        // Se cumplió el período: SysTick_Handler suma los ticks y restablece el período
+        ciclosEnReposo += periodo;
+    }else{
+        // Despertó otra interrupción: contabiliza los ticks completos
+        // y programa un período de ajuste hasta el próximo tick
+        uint32_t const cuentas = (periodo - 1) - SysTick->VAL;
+        uint32_t completos = 0;
+        uint32_t parcial = restante - cuentas;
+        if (cuentas >= restante){
+            uint32_t const exceso = cuentas - restante;
+            completos = 1 + exceso / cuentasPorTick;
+            parcial = cuentasPorTick - exceso % cuentasPorTick;
+        }
+        ciclosEnReposo += cuentas;
+        SysTick->LOAD = (parcial > 1) ? parcial - 1 : 1;
+        SysTick->VAL = 0;
+        ticksPorInterrupcion = 1;
+        if (completos){
+            ticks += completos;
+            if (SP_Timeouts_procesa(completos)) despertarPendiente = true;
+        }
+    }
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    ++despertares;
+    despertarPendiente = false;
+    __enable_irq();
 }
\ No newline at end of file
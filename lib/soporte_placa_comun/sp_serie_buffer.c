@@ -0,0 +1,69 @@
+#include "sp_serie_buffer.h"
+#include <stdbool.h> // bool
+#include <stdint.h>  // uint32_t, uint8_t
+#include <stddef.h>  // size_t
+#include <string.h>  // memcpy
+#include <stm32f1xx.h> // __DMB
+
+#if SP_SERIE_TAM_BUFFER & (SP_SERIE_TAM_BUFFER - 1)
+#error SP_SERIE_TAM_BUFFER debe ser potencia de 2
+#endif
+
+/*
+ * Un productor modifica solo "escrituras" y el consumidor solo
+ * "lecturas": ninguno necesita deshabilitar interrupciones. Los
+ * contadores no se reducen al tamaño del buffer, así su diferencia es
+ * la cantidad de bytes pendientes aun después de dar la vuelta
+ */
+
+static uint8_t buffer[SP_SERIE_TAM_BUFFER];
+static uint32_t volatile escrituras;
+static uint32_t volatile lecturas;
+static uint32_t descartados;
+
+size_t SP_Serie_getLibre(void){
+    return SP_SERIE_TAM_BUFFER - (escrituras - lecturas);
+}
+
+size_t SP_SerieBuffer_escribe(void const *const datos, size_t const tamano){
+    size_t const libre = SP_Serie_getLibre();
+    size_t const n = tamano < libre ? tamano : libre;
+    uint32_t const inicio = escrituras % SP_SERIE_TAM_BUFFER;
+    size_t const primerTramo = (SP_SERIE_TAM_BUFFER - inicio) < n ? (SP_SERIE_TAM_BUFFER - inicio) : n;
+    memcpy(buffer + inicio,datos,primerTramo);
+    memcpy(buffer,(uint8_t const *)datos + primerTramo,n - primerTramo);
+    descartados += tamano - n;
+    __DMB();                                                // Datos escritos antes de publicarlos
+    escrituras += n;
+    return n;
+}
+
+uint8_t const *SP_SerieBuffer_tramo(uint32_t *const tamano){
+    uint32_t const pendientes = escrituras - lecturas;
+    uint32_t const inicio = lecturas % SP_SERIE_TAM_BUFFER;
+    uint32_t const hastaFinal = SP_SERIE_TAM_BUFFER - inicio;
+    *tamano = pendientes < hastaFinal ? pendientes : hastaFinal;
+    return buffer + inicio;
+}
+
+void SP_SerieBuffer_libera(uint32_t const tamano){
+    lecturas += tamano;
+}
+
+bool SP_SerieBuffer_qPendientes(void){
+    return escrituras != lecturas;
+}
+
+void SP_SerieBuffer_reinicia(void){
+    escrituras = 0;
+    lecturas = 0;
+    descartados = 0;
+}
+
+uint32_t SP_Serie_getTransmitidos(void){
+    return lecturas;
+}
+
+uint32_t SP_Serie_getDescartados(void){
+    return descartados;
+}
@@ -0,0 +1,54 @@
+#ifndef SP_SERIE_BUFFER_H
+#define SP_SERIE_BUFFER_H
+#include <soporte_placa/sp_serie.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Buffer circular de transmisión serie, independiente del hardware.
+ * Lo comparten el soporte de la placa (lib/soporte_placa, consumido
+ * por el DMA) y la placa simulada (lib/soporte_placa_sim): un
+ * productor (SP_Serie_escribe) y un consumidor que toma tramos
+ * contiguos. Implementa SP_Serie_getLibre, SP_Serie_getTransmitidos y
+ * SP_Serie_getDescartados
+ */
+
+/**
+ * @brief Copia al buffer los datos que entran y los publica; cuenta el
+ * excedente como descartado
+ *
+ * @param datos Datos a copiar
+ * @param tamano Bytes a copiar
+ * @return size_t Bytes copiados
+ */
+size_t SP_SerieBuffer_escribe(void const *datos, size_t tamano);
+
+/**
+ * @brief Próximo tramo contiguo a transmitir: desde el primer byte
+ * pendiente hasta el último escrito o hasta el final del buffer
+ *
+ * @param tamano Salida: bytes del tramo (0 si no hay pendientes)
+ * @return uint8_t const* Comienzo del tramo
+ */
+uint8_t const *SP_SerieBuffer_tramo(uint32_t *tamano);
+
+/**
+ * @brief Libera los primeros bytes pendientes, ya transmitidos
+ *
+ * @param tamano Bytes transmitidos, a lo sumo los del tramo
+ */
+void SP_SerieBuffer_libera(uint32_t tamano);
+
+/**
+ * @brief Indica si quedan bytes por transmitir
+ */
+bool SP_SerieBuffer_qPendientes(void);
+
+/**
+ * @brief Vacía el buffer y pone en cero los contadores
+ *
+ */
+void SP_SerieBuffer_reinicia(void);
+
+#endif
@@ -0,0 +1,245 @@
+#include "sp_timeouts.h"
+#include <stdbool.h> // bool, true, false
+#include <stdint.h>  // uint32_t, uint16_t
+#include <stddef.h>  // size_t
+#include <stm32f1xx.h> // __get_PRIMASK, __set_PRIMASK, __disable_irq
+
+#ifndef SP_MAX_TIMEOUTS
+#define SP_MAX_TIMEOUTS 4
+#endif
+
+#if SP_MAX_TIMEOUTS > 0xFFFE
+#error SP_MAX_TIMEOUTS debe ser menor a 65535
+#endif
+
+enum {NINGUNO = UINT16_MAX}; // Índice nulo de las listas de timeouts
+
+/**
+ * @brief Timeout programado. Los activos forman una lista ordenada por
+ * vencimiento en la que cada uno guarda los ticks que faltan desde el
+ * vencimiento del anterior (lista delta), así SysTick_Handler solo
+ * descuenta el primero. Los libres se encadenan por siguiente
+ * 
+ */
+typedef struct SP_TimeoutDescriptor{
+    uint32_t delta;             // Ticks desde el vencimiento del anterior de la lista
+    uint32_t periodo;           // Ticks entre vencimientos; 0 si vence una sola vez
+    SP_TimeoutHandler handler;
+    void volatile *param;
+    uint16_t siguiente;
+    uint16_t anterior;
+    uint16_t generacion;        // Cambia en cada programación: invalida los handles viejos
+    bool activo;
+} SP_TimeoutDescriptor;
+
+static SP_TimeoutDescriptor timeoutDescriptors[SP_MAX_TIMEOUTS];
+static uint16_t primero = NINGUNO;  // Próximo a vencer
+static uint16_t ultimo = NINGUNO;   // Último en vencer
+static uint32_t total;              // Suma de los delta: ticks hasta el vencimiento del último
+static uint16_t libres = NINGUNO;   // Descriptores liberados
+static uint16_t sinUsar;            // Descriptores nunca usados: de sinUsar a SP_MAX_TIMEOUTS-1
+
+/**
+ * @brief Ticks transcurridos que aún no se descontaron del primero de la
+ * lista. Solo es distinto de cero mientras SP_Timeouts_procesa llama a los
+ * handlers, que pueden programar nuevos timeouts
+ * 
+ */
+static uint32_t atraso;
+
+/**
+ * @brief Deshabilita interrupciones y retorna el estado anterior, para
+ * poder usarse con interrupciones ya deshabilitadas (SP_Tiempo_duerme)
+ */
+static uint32_t bloquea(void){
+    uint32_t const primask = __get_PRIMASK();
+    __disable_irq();
+    return primask;
+}
+
+static void desbloquea(uint32_t const primask){
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Inserta un descriptor en la lista ordenada, detrás de los que
+ * vencen al mismo tiempo. Si vence después que todos (el caso usual de
+ * un periódico reinsertado) se agrega al final sin recorrer la lista;
+ * si no, recorre desde el extremo más cercano. Llamar con
+ * interrupciones deshabilitadas
+ * 
+ * @param indice Descriptor
+ * @param tiempo Ticks desde el vencimiento del primero de la lista
+ * (o desde el tick actual si se le suma atraso)
+ */
+static void inserta(uint16_t const indice, uint32_t const tiempo){
+    uint16_t anterior = ultimo;
+    uint16_t siguiente = NINGUNO;
+    uint32_t hastaAnterior = total;
+    if (tiempo < total){
+        if (tiempo >= total/2){
+            while (anterior != NINGUNO && hastaAnterior > tiempo){
+                siguiente = anterior;
+                hastaAnterior -= timeoutDescriptors[anterior].delta;
+                anterior = timeoutDescriptors[anterior].anterior;
+            }
+        }else{
+            anterior = NINGUNO;
+            siguiente = primero;
+            hastaAnterior = 0;
+            while (hastaAnterior + timeoutDescriptors[siguiente].delta <= tiempo){
+                hastaAnterior += timeoutDescriptors[siguiente].delta;
+                anterior = siguiente;
+                siguiente = timeoutDescriptors[siguiente].siguiente;
+            }
+        }
+    }
+    SP_TimeoutDescriptor *const td = timeoutDescriptors + indice;
+    td->delta = tiempo - hastaAnterior;
+    td->anterior = anterior;
+    td->siguiente = siguiente;
+    if (siguiente != NINGUNO){
+        timeoutDescriptors[siguiente].delta -= td->delta;
+        timeoutDescriptors[siguiente].anterior = indice;
+    }else{
+        ultimo = indice;
+        total = tiempo;
+    }
+    if (anterior != NINGUNO){
+        timeoutDescriptors[anterior].siguiente = indice;
+    }else{
+        primero = indice;
+    }
+}
+
+/**
+ * @brief Quita un descriptor de la lista ordenada; su delta pasa al
+ * siguiente. Llamar con interrupciones deshabilitadas
+ * 
+ * @param indice Descriptor
+ */
+static void quita(uint16_t const indice){
+    SP_TimeoutDescriptor const *const td = timeoutDescriptors + indice;
+    if (td->siguiente != NINGUNO){
+        timeoutDescriptors[td->siguiente].delta += td->delta;
+        timeoutDescriptors[td->siguiente].anterior = td->anterior;
+    }else{
+        ultimo = td->anterior;
+        total -= td->delta;
+    }
+    if (td->anterior != NINGUNO){
+        timeoutDescriptors[td->anterior].siguiente = td->siguiente;
+    }else{
+        primero = td->siguiente;
+    }
+}
+
+static void libera(uint16_t const indice){
+    timeoutDescriptors[indice].activo = false;
+    timeoutDescriptors[indice].siguiente = libres;
+    libres = indice;
+}
+
+static SP_HTimeout programaTimeout(uint32_t const tiempo, uint32_t const periodo,
+                                   SP_TimeoutHandler const handler, void volatile *const param){
+    SP_HTimeout hTimeout = SP_TIMEOUT_NINGUNO;
+    if (tiempo){
+        uint32_t const estado = bloquea();
+        uint16_t indice = libres;
+        if (indice != NINGUNO){
+            libres = timeoutDescriptors[indice].siguiente;
+        }else if (sinUsar < SP_MAX_TIMEOUTS){
+            indice = sinUsar++;
+        }
+        if (indice != NINGUNO){
+            SP_TimeoutDescriptor *const td = timeoutDescriptors + indice;
+            td->periodo = periodo;
+            td->handler = handler;
+            td->param = param;
+            td->activo = true;
+            ++td->generacion;
+            inserta(indice,(tiempo < UINT32_MAX - atraso) ? tiempo + atraso : UINT32_MAX);
+            hTimeout = ((SP_HTimeout)td->generacion << 16) | (indice + 1u);
+        }
+        desbloquea(estado);
+    }
+    return hTimeout;
+}
+
+SP_HTimeout SP_Tiempo_addTimeout(uint32_t const tiempo,SP_TimeoutHandler const handler,void volatile *const param){
+    return programaTimeout(SP_Timeouts_ticksDeMilisegundos(tiempo),0,handler,param);
+}
+
+SP_HTimeout SP_Tiempo_addTimeoutPeriodico(uint32_t const tiempo,uint32_t const periodo,SP_TimeoutHandler const handler,void volatile *const param){
+    SP_HTimeout hTimeout = SP_TIMEOUT_NINGUNO;
+    if (periodo){
+        hTimeout = programaTimeout(SP_Timeouts_ticksDeMilisegundos(tiempo),SP_Timeouts_ticksDeMilisegundos(periodo),handler,param);
+    }
+    return hTimeout;
+}
+
+bool SP_Tiempo_cancelaTimeout(SP_HTimeout const hTimeout){
+    bool hecho = false;
+    uint32_t const indice = (hTimeout & 0xFFFFu) - 1u;
+    if (indice < SP_MAX_TIMEOUTS){
+        uint32_t const estado = bloquea();
+        SP_TimeoutDescriptor const *const td = timeoutDescriptors + indice;
+        if (td->activo && td->generacion == (uint16_t)(hTimeout >> 16)){
+            quita(indice);
+            libera(indice);
+            hecho = true;
+        }
+        desbloquea(estado);
+    }
+    return hecho;
+}
+
+uint32_t SP_Timeouts_procesa(uint32_t const transcurrido){
+    uint32_t vencidos = 0;
+    uint32_t estado = bloquea();
+    atraso = transcurrido;
+    while (primero != NINGUNO && timeoutDescriptors[primero].delta <= atraso){
+        uint16_t const indice = primero;
+        SP_TimeoutDescriptor *const td = timeoutDescriptors + indice;
+        atraso -= td->delta;
+        total -= td->delta;
+        td->delta = 0;              // Los siguientes ya cuentan desde este vencimiento
+        quita(indice);
+        SP_TimeoutHandler const handler = td->handler;
+        void volatile *const param = td->param;
+        if (td->periodo){
+            inserta(indice,td->periodo);
+        }else{
+            libera(indice);
+        }
+        ++vencidos;
+        desbloquea(estado);
+        if (handler) handler(param);
+        estado = bloquea();
+    }
+    if (primero != NINGUNO){
+        timeoutDescriptors[primero].delta -= atraso;
+        total -= atraso;
+    }
+    atraso = 0;
+    desbloquea(estado);
+    return vencidos;
+}
+
+uint32_t SP_Timeouts_ticksHastaProximo(void){
+    return (primero != NINGUNO) ? timeoutDescriptors[primero].delta : SP_TIEMPO_INDEFINIDO;
+}
+
+void SP_Timeouts_reinicia(void){
+    uint32_t const estado = bloquea();
+    for(size_t i=0;i<SP_MAX_TIMEOUTS;++i){
+        timeoutDescriptors[i] = (SP_TimeoutDescriptor){0};
+    }
+    primero = NINGUNO;
+    ultimo = NINGUNO;
+    total = 0;
+    libres = NINGUNO;
+    sinUsar = 0;
+    atraso = 0;
+    desbloquea(estado);
+}
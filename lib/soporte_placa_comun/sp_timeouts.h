@@ -0,0 +1,51 @@
+#ifndef SP_TIMEOUTS_H
+#define SP_TIMEOUTS_H
+#include <soporte_placa/sp_tiempo.h>
+#include <stdint.h>
+
+/*
+ * Lista de timeouts programados, independiente del hardware. La
+ * comparten el soporte de la placa (lib/soporte_placa) y la placa
+ * simulada (lib/soporte_placa_sim): cada uno implementa el SysTick y
+ * el reposo, y le informa los ticks transcurridos. Implementa
+ * SP_Tiempo_addTimeout, SP_Tiempo_addTimeoutPeriodico y
+ * SP_Tiempo_cancelaTimeout. Las secciones críticas usan
+ * __get_PRIMASK/__set_PRIMASK, así pueden llamarse con interrupciones
+ * ya deshabilitadas
+ */
+
+/**
+ * @brief Convierte milisegundos a ticks, saturando en SP_TIEMPO_INDEFINIDO
+ */
+static inline uint32_t SP_Timeouts_ticksDeMilisegundos(uint32_t milisegundos){
+    return (milisegundos < SP_TIEMPO_INDEFINIDO/SP_TIEMPO_TICKS_POR_MILISEGUNDO) ?
+           milisegundos * SP_TIEMPO_TICKS_POR_MILISEGUNDO : SP_TIEMPO_INDEFINIDO;
+}
+
+/**
+ * @brief Descuenta los ticks transcurridos del primero de la lista y
+ * atiende los vencidos, en orden. Cada handler se llama fuera de la
+ * sección crítica; los periódicos se reinsertan antes del llamado,
+ * contando desde su vencimiento
+ *
+ * @param transcurrido Ticks desde el último llamado
+ * @return uint32_t Cantidad de timeouts vencidos
+ */
+uint32_t SP_Timeouts_procesa(uint32_t transcurrido);
+
+/**
+ * @brief Ticks hasta el vencimiento del próximo timeout
+ *
+ * @return uint32_t Ticks, o SP_TIEMPO_INDEFINIDO si no hay timeouts
+ * programados
+ */
+uint32_t SP_Timeouts_ticksHastaProximo(void);
+
+/**
+ * @brief Descarta todos los timeouts y los handles emitidos (para la
+ * placa simulada, entre pruebas)
+ *
+ */
+void SP_Timeouts_reinicia(void);
+
+#endif
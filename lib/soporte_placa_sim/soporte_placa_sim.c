@@ -0,0 +1,110 @@
+#include "sp_sim_impl.h"
+#include <stm32f1xx.h>
+#include <stddef.h>
+#include <time.h>
+
+// Implementación de la placa simulada
+
+static bool interrupcionesHabilitadas = true;
+static struct timespec inicioBloqueo;
+static SP_Sim_Bloqueos bloqueos;
+
+void __disable_irq(void){
+    if (interrupcionesHabilitadas){
+        clock_gettime(CLOCK_MONOTONIC,&inicioBloqueo);
+    }
+    interrupcionesHabilitadas = false;
+}
+
+void __enable_irq(void){
+    if (!interrupcionesHabilitadas){
+        struct timespec fin;
+        clock_gettime(CLOCK_MONOTONIC,&fin);
+        int64_t const ns = (int64_t)(fin.tv_sec - inicioBloqueo.tv_sec)*1000000000 + (fin.tv_nsec - inicioBloqueo.tv_nsec);
+        ++bloqueos.secciones;
+        bloqueos.nanosegundosTotal += ns;
+        if ((uint64_t)ns > bloqueos.nanosegundosMaximo) bloqueos.nanosegundosMaximo = (uint32_t)ns;
+    }
+    interrupcionesHabilitadas = true;
+    SP_Sim_Expropiacion_atiende();
+}
+
+uint32_t __get_PRIMASK(void){
+    return !interrupcionesHabilitadas;
+}
+
+void __set_PRIMASK(uint32_t const primask){
+    if (primask){
+        __disable_irq();
+    }else{
+        __enable_irq();
+    }
+}
+
+SP_Sim_Bloqueos SP_Sim_getBloqueos(void){
+    return bloqueos;
+}
+
+void SP_Sim_reiniciaBloqueos(void){
+    bloqueos = (SP_Sim_Bloqueos){0};
+}
+
+/*
+ * Las pruebas pueden usar hilos como productores concurrentes: la
+ * reserva exclusiva es por hilo y __STREXW se implementa con una
+ * comparación e intercambio atómicos.
+ */
+static _Thread_local struct{
+    volatile uint32_t *direccion;
+    uint32_t valor;
+}reserva;
+
+uint32_t __LDREXW(volatile uint32_t *direccion){
+    reserva.direccion = direccion;
+    reserva.valor = __atomic_load_n(direccion,__ATOMIC_ACQUIRE);
+    return reserva.valor;
+}
+
+uint32_t __STREXW(uint32_t valor, volatile uint32_t *direccion){
+    uint32_t esperado = reserva.valor;
+    bool const hecho = (reserva.direccion == direccion)
+                    && __atomic_compare_exchange_n(direccion,&esperado,valor,false,__ATOMIC_SEQ_CST,__ATOMIC_SEQ_CST);
+    reserva.direccion = NULL;
+    return hecho ? 0 : 1;
+}
+
+void __CLREX(void){
+    reserva.direccion = NULL;
+}
+
+void __DMB(void){
+    __atomic_thread_fence(__ATOMIC_ACQ_REL);
+}
+
+void __WFI(void){
+    SP_Sim_Tiempo_avanza(1);
+}
+
+bool SP_Sim_qInterrupcionesHabilitadas(void){
+    return interrupcionesHabilitadas;
+}
+
+void SP_Sim_reset(void){
+    interrupcionesHabilitadas = true;
+    SP_Sim_reiniciaBloqueos();
+    SP_Sim_Exti_reset();
+    SP_Sim_Pin_reset();
+    SP_Sim_Tiempo_reset();
+    SP_Sim_Expropiacion_reset();
+    SP_Sim_Perfil_reset();
+    SP_Sim_Serie_reset();
+}
+
+/* Inicialización general */
+
+void SP_init(void){
+    SP_Tiempo_init(); 
+#if SP_PERFILADO
+    SP_Perfil_init();
+#endif
+}
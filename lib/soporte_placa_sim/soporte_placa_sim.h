@@ -0,0 +1,158 @@
+#ifndef SOPORTE_PLACA_SIM_H
+#define SOPORTE_PLACA_SIM_H
+
+// Espacio de nombres: SP_Sim_
+
+#include <soporte_placa.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Vuelve la placa simulada al estado de reset: puertos
+ * sin configurar, reloj virtual en cero, sin timeouts ni
+ * interrupciones configuradas
+ * 
+ */
+void SP_Sim_reset(void);
+
+/**
+ * @brief Impone un nivel externo en un pin, como lo haría un
+ * pulsador o un generador conectado a la placa. Si el pin está
+ * configurado como entrada y el nivel leído cambia se disparan
+ * las interrupciones configuradas para el pin.
+ * 
+ * @param hPin Handle al objeto Pin
+ * @param nivel Nivel impuesto
+ */
+void SP_Sim_Pin_setEntrada(SP_HPin hPin, bool nivel);
+
+/**
+ * @brief Quita el nivel externo impuesto con SP_Sim_Pin_setEntrada.
+ * El pin vuelve a tomar el nivel de su resistencia de pull-up/pull-dn
+ * 
+ * @param hPin Handle al objeto Pin
+ */
+void SP_Sim_Pin_liberaEntrada(SP_HPin hPin);
+
+/**
+ * @brief Lee el buffer de salida (ODR) de un pin
+ * 
+ * @param hPin Handle al objeto Pin
+ * @return true Salida ALTA
+ * @return false Salida BAJA
+ */
+bool SP_Sim_Pin_getSalida(SP_HPin hPin);
+
+/**
+ * @brief Cuenta las llamadas a SP_Pin_read desde el último
+ * SP_Sim_reset. Permite verificar que un módulo no lee pines
+ * innecesariamente
+ * 
+ * @return uint32_t Número de lecturas
+ */
+uint32_t SP_Sim_Pin_getLecturas(void);
+
+/**
+ * @brief Cuenta los almacenamientos en el buffer de salida de un
+ * puerto (uno por SP_Pin_write o SP_Puerto_writeMascara) desde el
+ * último SP_Sim_reset
+ * 
+ * @param hPuerto Handle al puerto
+ * @return uint32_t Número de almacenamientos
+ */
+uint32_t SP_Sim_Puerto_getEscrituras(SP_HPuerto hPuerto);
+
+/**
+ * @brief Avanza el reloj virtual. Por cada milisegundo ejecuta
+ * SP_TIEMPO_TICKS_POR_MILISEGUNDO veces el handler de SysTick (y por
+ * lo tanto los timeouts vencidos)
+ * 
+ * @param milisegundos Tiempo a avanzar
+ */
+void SP_Sim_Tiempo_avanza(uint32_t milisegundos);
+
+/**
+ * @brief Fija el reloj virtual sin ejecutar el handler de SysTick, por
+ * ejemplo para probar el paso de los 2^32 ms. Los timeouts programados
+ * no cambian
+ * 
+ * @param milisegundos Nuevo valor del reloj virtual
+ */
+void SP_Sim_Tiempo_setMilisegundos(uint64_t milisegundos);
+
+/**
+ * @brief Función que modela el mundo exterior a la placa. Es llamada
+ * por el reloj virtual luego de cada milisegundo simulado y puede
+ * cambiar niveles de entrada con SP_Sim_Pin_setEntrada
+ * 
+ * @param milisegundos Valor actual del reloj virtual
+ * @param param Parámetro registrado con SP_Sim_setEstimulo
+ */
+typedef void (*SP_Sim_Estimulo)(uint32_t milisegundos, void *param);
+
+/**
+ * @brief Registra el estímulo exterior de la simulación. Con estímulo
+ * registrado, SP_Tiempo_duerme avanza el reloj de a un milisegundo y
+ * despierta en cuanto el estímulo provoca una interrupción
+ * 
+ * @param estimulo Función de estímulo o NULL para quitarlo
+ * @param param Parámetro enviado a la función de estímulo
+ */
+void SP_Sim_setEstimulo(SP_Sim_Estimulo estimulo, void *param);
+
+/**
+ * @brief Indica si las interrupciones simuladas están habilitadas
+ * (ver __disable_irq/__enable_irq)
+ * 
+ * @return true Interrupciones habilitadas
+ * @return false Interrupciones deshabilitadas
+ */
+bool SP_Sim_qInterrupcionesHabilitadas(void);
+
+/**
+ * @brief Cuenta las ejecuciones de la rutina de expropiación
+ * (ver SP_Expropiacion_solicita) desde el último SP_Sim_reset
+ * 
+ * @return uint32_t Número de ejecuciones
+ */
+uint32_t SP_Sim_Expropiacion_getEjecuciones(void);
+
+/**
+ * @brief Lee (y consume) los bytes que el USART simulado ya transmitió
+ * desde el buffer de SP_Serie. El canal entrega baudios/10 bytes por
+ * milisegundo de reloj virtual
+ * 
+ * @param destino Buffer para los bytes
+ * @param tamano Tamaño del buffer
+ * @return size_t Bytes leídos
+ */
+size_t SP_Sim_Serie_leeTransmitidos(void *destino, size_t tamano);
+
+/**
+ * @brief Estadística de las secciones con interrupciones
+ * deshabilitadas (de __disable_irq a __enable_irq)
+ */
+typedef struct SP_Sim_Bloqueos{
+    uint32_t secciones;             //Cantidad de secciones
+    uint32_t nanosegundosMaximo;    //Duración de la sección más larga (tiempo real del host)
+    uint64_t nanosegundosTotal;     //Suma de las duraciones
+}SP_Sim_Bloqueos;
+
+/**
+ * @brief Obtiene la estadística de secciones con interrupciones
+ * deshabilitadas desde el último SP_Sim_reset o
+ * SP_Sim_reiniciaBloqueos
+ * 
+ * @return SP_Sim_Bloqueos Estadística
+ */
+SP_Sim_Bloqueos SP_Sim_getBloqueos(void);
+
+/**
+ * @brief Pone en cero la estadística de secciones con interrupciones
+ * deshabilitadas
+ * 
+ */
+void SP_Sim_reiniciaBloqueos(void);
+
+#endif
@@ -0,0 +1,56 @@
+#include "sp_sim_impl.h"
+#include <stddef.h>
+
+/* Expropiación simulada */
+
+/*
+ * Modela PendSV: la rutina corre en cuanto no hay interrupciones
+ * simuladas en curso (SysTick, EXTI) y las interrupciones están
+ * habilitadas. Una solicitud desde el modo hilo ejecuta la rutina
+ * dentro de la misma llamada, sobre la misma pila, igual que en la
+ * placa; una solicitud desde una interrupción o con interrupciones
+ * deshabilitadas queda pendiente hasta que esas condiciones cesan.
+ */
+
+static SP_RutinaExpropiacion rutina;
+static bool pendiente;
+static unsigned interrupcionesEnCurso;
+static uint32_t ejecuciones;
+
+void SP_Sim_Expropiacion_reset(void){
+    rutina = NULL;
+    pendiente = false;
+    interrupcionesEnCurso = 0;
+    ejecuciones = 0;
+}
+
+void SP_Sim_Expropiacion_atiende(void){
+    while (pendiente && rutina && !interrupcionesEnCurso && SP_Sim_qInterrupcionesHabilitadas()){
+        pendiente = false;
+        ++ejecuciones;
+        rutina();
+    }
+}
+
+void SP_Sim_Interrupcion_entra(void){
+    ++interrupcionesEnCurso;
+}
+
+void SP_Sim_Interrupcion_sale(void){
+    --interrupcionesEnCurso;
+    SP_Sim_Expropiacion_atiende();
+}
+
+void SP_Expropiacion_init(SP_RutinaExpropiacion const nuevaRutina){
+    rutina = nuevaRutina;
+    pendiente = false;
+}
+
+void SP_Expropiacion_solicita(void){
+    pendiente = true;
+    SP_Sim_Expropiacion_atiende();
+}
+
+uint32_t SP_Sim_Expropiacion_getEjecuciones(void){
+    return ejecuciones;
+}
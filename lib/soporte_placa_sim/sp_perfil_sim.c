@@ -0,0 +1,113 @@
+#include "sp_sim_impl.h"
+#include <stm32f1xx.h> // __LDREXW, __STREXW, __CLZ
+#include <stddef.h>    // NULL
+#include <stdbool.h>   // bool
+#include <time.h>      // clock_gettime
+
+/* Perfil de duración simulado */
+
+/*
+ * En la PC no hay DWT: el contador de ciclos es el reloj monotónico
+ * en nanosegundos, truncado a 32 bits igual que CYCCNT. Las duraciones
+ * son las del programa nativo, no las de la placa.
+ */
+
+static SP_Perfil perfil;
+
+/*
+ * La tabla se actualiza desde el lazo principal, desde máquinas
+ * expropiativas y desde interrupciones sin deshabilitarlas: quien
+ * registra toma la tabla con LDREX/STREX. Si una interrupción o una
+ * expropiación llega mientras otro código la tiene tomada, su
+ * medición se cuenta como descartada.
+ */
+static uint32_t volatile ocupado;
+
+static bool SP_Perfil__toma(void){
+    bool tomado = false;
+    do{
+        if (__LDREXW(&ocupado)){
+            __CLREX();
+            break;
+        }
+        tomado = !__STREXW(1,&ocupado);
+    }while(!tomado);
+    __DMB();
+    return tomado;
+}
+
+static void SP_Perfil__suelta(void){
+    __DMB();
+    ocupado = 0;
+}
+
+static void SP_Perfil__descarta(void){
+    uint32_t volatile *const descartadas = &perfil.descartadas;
+    uint32_t valor;
+    do{
+        valor = __LDREXW(descartadas);
+    }while(__STREXW(valor + 1,descartadas));
+}
+
+void SP_Perfil_init(void){
+    perfil = (SP_Perfil){.cuentasPorMicrosegundo = 1000};
+    ocupado = 0;
+}
+
+void SP_Sim_Perfil_reset(void){
+    SP_Perfil_init();
+}
+
+uint32_t SP_Perfil_getCuenta(void){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC,&t);
+    return (uint32_t)((uint64_t)t.tv_sec*1000000000ULL + (uint64_t)t.tv_nsec);
+}
+
+/**
+ * @brief Busca la entrada de la función; si no existe y hay lugar la crea
+ */
+static SP_PerfilEstadistica *SP_Perfil__entrada(SP_PerfilFuncion funcion){
+    for (uint32_t i=0;i<perfil.numFunciones;++i){
+        if (perfil.funciones[i].funcion == funcion) return perfil.funciones + i;
+    }
+    if (perfil.numFunciones == SP_PERFIL_MAX_FUNCIONES) return NULL;
+    SP_PerfilEstadistica *const e = perfil.funciones + perfil.numFunciones++;
+    *e = (SP_PerfilEstadistica){.funcion = funcion, .minimo = UINT32_MAX};
+    return e;
+}
+
+void SP_Perfil_registra(SP_PerfilFuncion funcion, uint32_t inicio){
+    uint32_t const duracion = SP_Perfil_getCuenta() - inicio;
+    uint32_t const intervalo = 32U - __CLZ(duracion);
+    if (SP_Perfil__toma()){
+        SP_PerfilEstadistica *const e = SP_Perfil__entrada(funcion);
+        if (e){
+            ++e->llamadas;
+            e->total += duracion;
+            if (duracion < e->minimo) e->minimo = duracion;
+            if (duracion > e->maximo) e->maximo = duracion;
+            ++e->histograma[intervalo < SP_PERFIL_NUM_INTERVALOS ? intervalo : SP_PERFIL_NUM_INTERVALOS - 1];
+        }else{
+            SP_Perfil__descarta();      //Tabla llena
+        }
+        SP_Perfil__suelta();
+    }else{
+        SP_Perfil__descarta();
+    }
+}
+
+SP_Perfil const *SP_Perfil_get(void){
+    return &perfil;
+}
+
+SP_PerfilEstadistica const *SP_Perfil_busca(SP_PerfilFuncion funcion){
+    for (uint32_t i=0;i<perfil.numFunciones;++i){
+        if (perfil.funciones[i].funcion == funcion) return perfil.funciones + i;
+    }
+    return NULL;
+}
+
+uint32_t SP_Perfil_getMedia(SP_PerfilEstadistica const *estadistica){
+    return estadistica->llamadas ? (uint32_t)(estadistica->total / estadistica->llamadas) : 0;
+}
@@ -0,0 +1,76 @@
+#include "sp_sim_impl.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stm32f1xx.h>
+
+/* EXTI simulado */
+
+enum {SP_SIM_NUM_LINEAS_EXTI = 16};
+
+typedef struct SP_DescriptorExti{
+    SP_Pin_IntHandler handler;
+    void volatile *param;
+    unsigned puerto;
+    uint16_t flancosAscendentes;    // Máscara de la línea si es sensible al flanco ascendente
+    uint16_t flancosDescendentes;   // Máscara de la línea si es sensible al flanco descendente
+}SP_DescriptorExti;
+
+static SP_DescriptorExti descriptores[SP_SIM_NUM_LINEAS_EXTI];
+
+void SP_Sim_Exti_reset(void){
+    for (size_t i=0;i<SP_SIM_NUM_LINEAS_EXTI;++i){
+        descriptores[i] = (SP_DescriptorExti){0};
+    }
+}
+
+bool SP_Pin_setInterrupcion(SP_HPin hPin,SP_Pin_IntFlanco flanco,SP_Pin_IntHandler handler, void volatile *param){
+    bool configurado = false;
+    __disable_irq();
+    if (hPin < SP_NUM_PINES){
+        unsigned puerto,linea;
+        SP_Sim_Pin_ubicacion(hPin,&puerto,&linea);
+        SP_DescriptorExti *const desc = descriptores + linea;
+        if (!desc->handler){
+            uint16_t const mascara = 1U << linea;
+            configurado = true;
+            desc->handler = handler;
+            desc->param = param;
+            desc->puerto = puerto;
+            desc->flancosAscendentes  = (flanco != SP_PIN_INT_FLANCO_DESCENDENTE) ? mascara : 0;
+            desc->flancosDescendentes = (flanco != SP_PIN_INT_FLANCO_ASCENDENTE)  ? mascara : 0;
+        }
+    }
+    __enable_irq();
+    return configurado;
+}
+
+bool SP_Pin_resetInterrupcion(SP_HPin hPin){
+    bool liberado = false;
+    __disable_irq();
+    if (hPin < SP_NUM_PINES){
+        unsigned puerto,linea;
+        SP_Sim_Pin_ubicacion(hPin,&puerto,&linea);
+        SP_DescriptorExti *const desc = descriptores + linea;
+        if (desc->handler && desc->puerto == puerto){
+            liberado = true;
+            *desc = (SP_DescriptorExti){0};
+        }
+    }
+    __enable_irq();
+    return liberado;
+}
+
+void SP_Sim_Exti_procesaCambio(unsigned puerto, uint16_t idrAnterior, uint16_t idrNuevo){
+    uint16_t const ascendentes  =  idrNuevo & ~idrAnterior;
+    uint16_t const descendentes = ~idrNuevo &  idrAnterior;
+    for (size_t i=0;i<SP_SIM_NUM_LINEAS_EXTI;++i){
+        SP_DescriptorExti const *const d = descriptores + i;
+        if (!d->handler || d->puerto != puerto) continue;
+        if ((d->flancosAscendentes & ascendentes) || (d->flancosDescendentes & descendentes)){
+            SP_Tiempo_despierta();
+            SP_Sim_Interrupcion_entra();
+            d->handler(d->param);
+            SP_Sim_Interrupcion_sale();
+        }
+    }
+}
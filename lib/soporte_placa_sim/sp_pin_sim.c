@@ -0,0 +1,224 @@
+#include "sp_sim_impl.h"
+#include <stdint.h>
+#include <stm32f1xx.h>
+
+/* GPIO simulado */
+
+/**
+ * @brief Estado de un puerto simulado. Cada campo tiene un bit por
+ * línea del puerto
+ * 
+ */
+typedef struct PuertoSim{
+    uint16_t odr;               // Buffer de salida (también selecciona pull-up/pull-dn)
+    uint16_t idr;               // Buffer de entrada, recalculado en cada cambio
+    uint16_t salidas;           // Líneas configuradas como salida
+    uint16_t pulls;             // Líneas configuradas como entrada con pull-up/pull-dn
+    uint16_t externas;          // Líneas con nivel impuesto desde fuera de la placa
+    uint16_t nivelesExternos;   // Nivel impuesto en las líneas externas
+    uint32_t escrituras;        // Almacenamientos en el buffer de salida (BSRR)
+}PuertoSim;
+
+typedef struct Pin{
+    uint8_t puerto;
+    uint8_t nrPin;
+}Pin;
+
+static PuertoSim puertos[SP_SIM_NUM_PUERTOS];
+static uint32_t lecturas;
+
+static Pin const pines[SP_NUM_PINES] = {
+    [SP_PA0 ] = {.puerto = SP_SIM_PUERTO_A, .nrPin = 0 },
+    [SP_PA1 ] = {.puerto = SP_SIM_PUERTO_A, .nrPin = 1 },
+    [SP_PA2 ] = {.puerto = SP_SIM_PUERTO_A, .nrPin = 2 },
+    [SP_PA3 ] = {.puerto = SP_SIM_PUERTO_A, .nrPin = 3 },
+    [SP_PA4 ] = {.puerto = SP_SIM_PUERTO_A, .nrPin = 4 },
+    [SP_PA5 ] = {.puerto = SP_SIM_PUERTO_A, .nrPin = 5 },
+    [SP_PA6 ] = {.puerto = SP_SIM_PUERTO_A, .nrPin = 6 },
+    [SP_PA7 ] = {.puerto = SP_SIM_PUERTO_A, .nrPin = 7 },
+    [SP_PA8 ] = {.puerto = SP_SIM_PUERTO_A, .nrPin = 8 },
+    [SP_PA9 ] = {.puerto = SP_SIM_PUERTO_A, .nrPin = 9 },
+    [SP_PA10] = {.puerto = SP_SIM_PUERTO_A, .nrPin = 10},
+    [SP_PA11] = {.puerto = SP_SIM_PUERTO_A, .nrPin = 11},
+    [SP_PA12] = {.puerto = SP_SIM_PUERTO_A, .nrPin = 12},
+    [SP_PA15] = {.puerto = SP_SIM_PUERTO_A, .nrPin = 15},
+    [SP_PB0 ] = {.puerto = SP_SIM_PUERTO_B, .nrPin = 0 },
+    [SP_PB1 ] = {.puerto = SP_SIM_PUERTO_B, .nrPin = 1 },
+    [SP_PB3 ] = {.puerto = SP_SIM_PUERTO_B, .nrPin = 3 },
+    [SP_PB4 ] = {.puerto = SP_SIM_PUERTO_B, .nrPin = 4 },
+    [SP_PB5 ] = {.puerto = SP_SIM_PUERTO_B, .nrPin = 5 },
+    [SP_PB6 ] = {.puerto = SP_SIM_PUERTO_B, .nrPin = 6 },
+    [SP_PB7 ] = {.puerto = SP_SIM_PUERTO_B, .nrPin = 7 },
+    [SP_PB9 ] = {.puerto = SP_SIM_PUERTO_B, .nrPin = 9 },
+    [SP_PB8 ] = {.puerto = SP_SIM_PUERTO_B, .nrPin = 8 },
+    [SP_PB10] = {.puerto = SP_SIM_PUERTO_B, .nrPin = 10},
+    [SP_PB11] = {.puerto = SP_SIM_PUERTO_B, .nrPin = 11},
+    [SP_PB12] = {.puerto = SP_SIM_PUERTO_B, .nrPin = 12},
+    [SP_PB13] = {.puerto = SP_SIM_PUERTO_B, .nrPin = 13},
+    [SP_PB14] = {.puerto = SP_SIM_PUERTO_B, .nrPin = 14},
+    [SP_PB15] = {.puerto = SP_SIM_PUERTO_B, .nrPin = 15},
+    [SP_PC13] = {.puerto = SP_SIM_PUERTO_C, .nrPin = 13},
+    [SP_PC14] = {.puerto = SP_SIM_PUERTO_C, .nrPin = 14},
+    [SP_PC15] = {.puerto = SP_SIM_PUERTO_C, .nrPin = 15},
+};
+
+static Pin const * pinDeHandle(SP_HPin hPin){
+    return &pines[hPin];
+}
+
+void SP_Sim_Pin_ubicacion(SP_HPin hPin, unsigned *puerto, unsigned *linea){
+    Pin const *const pin = pinDeHandle(hPin);
+    *puerto = pin->puerto;
+    *linea = pin->nrPin;
+}
+
+void SP_Sim_Pin_reset(void){
+    for (unsigned i=0;i<SP_SIM_NUM_PUERTOS;++i){
+        puertos[i] = (PuertoSim){0};
+    }
+    lecturas = 0;
+}
+
+/**
+ * @brief Recalcula el buffer de entrada de un puerto luego de un
+ * cambio de configuración, de salida o de nivel externo, y avisa
+ * al EXTI simulado si hubo flancos
+ * 
+ * Salidas: leen el buffer de salida.
+ * Entradas con nivel externo: leen el nivel impuesto.
+ * Entradas con pull: leen el buffer de salida (1 pull-up, 0 pull-dn).
+ * Entradas flotantes sin nivel externo: leen 0.
+ * 
+ * @param nrPuerto Puerto a actualizar
+ */
+static void actualizaEntradas(unsigned nrPuerto){
+    PuertoSim *const p = puertos + nrPuerto;
+    uint16_t const entradas = ~p->salidas;
+    uint16_t const idr =  (p->salidas & p->odr)
+                        | (entradas & p->externas & p->nivelesExternos)
+                        | (entradas & ~p->externas & p->pulls & p->odr);
+    uint16_t const anterior = p->idr;
+    p->idr = idr;
+    if (idr != anterior) SP_Sim_Exti_procesaCambio(nrPuerto,anterior,idr);
+}
+
+static void modificaLinea(uint16_t *registro, unsigned linea, bool valor){
+    uint16_t const mascara = 1U << linea;
+    *registro = valor ? (*registro | mascara) : (*registro & ~mascara);
+}
+
+void SP_Pin_setModo(SP_HPin hPin,SP_Pin_Modo modo){
+    if(hPin >= SP_NUM_PINES) return;
+    Pin const *const self = pinDeHandle(hPin);
+    PuertoSim *const p = puertos + self->puerto;
+    __disable_irq();
+    switch (modo)
+    {
+    case SP_PIN_ENTRADA:
+        modificaLinea(&p->salidas,self->nrPin,false);
+        modificaLinea(&p->pulls,self->nrPin,false);
+    break;case SP_PIN_ENTRADA_PULLUP:
+        modificaLinea(&p->salidas,self->nrPin,false);
+        modificaLinea(&p->pulls,self->nrPin,true);
+        modificaLinea(&p->odr,self->nrPin,true);
+    break;case SP_PIN_ENTRADA_PULLDN:
+        modificaLinea(&p->salidas,self->nrPin,false);
+        modificaLinea(&p->pulls,self->nrPin,true);
+        modificaLinea(&p->odr,self->nrPin,false);
+    break;case SP_PIN_SALIDA:
+    /*fallthru*/case SP_PIN_SALIDA_OPEN_DRAIN:
+        modificaLinea(&p->salidas,self->nrPin,true);
+        modificaLinea(&p->pulls,self->nrPin,false);
+    break;default:
+    break;
+    }
+    __enable_irq();
+    actualizaEntradas(self->puerto);
+}
+
+bool SP_Pin_read(SP_HPin hPin){
+    Pin const *const pin = pinDeHandle(hPin);
+    ++lecturas;
+    return puertos[pin->puerto].idr & (1U << pin->nrPin);
+}
+
+uint16_t SP_Puerto_read(SP_HPuerto hPuerto){
+    return puertos[hPuerto].idr;
+}
+
+SP_HPuerto SP_Pin_getPuerto(SP_HPin hPin){
+    return pinDeHandle(hPin)->puerto;
+}
+
+unsigned SP_Pin_getLinea(SP_HPin hPin){
+    return pinDeHandle(hPin)->nrPin;
+}
+
+uint32_t SP_Sim_Pin_getLecturas(void){
+    return lecturas;
+}
+
+void SP_Pin_write(SP_HPin hPin, bool valor){
+    Pin const *const pin = pinDeHandle(hPin);
+    modificaLinea(&puertos[pin->puerto].odr,pin->nrPin,valor);
+    ++puertos[pin->puerto].escrituras;
+    actualizaEntradas(pin->puerto);
+}
+
+void SP_Puerto_writeMascara(SP_HPuerto hPuerto, uint16_t mascara, uint16_t valores){
+    PuertoSim *const p = puertos + hPuerto;
+    p->odr = (uint16_t)((p->odr & ~mascara) | (valores & mascara));
+    ++p->escrituras;
+    actualizaEntradas(hPuerto);
+}
+
+bool SP_Pines_init(SP_GrupoPines *const grupo, SP_HPin const pines[], unsigned const numPines){
+    bool hecho = false;
+    if (numPines <= SP_GRUPO_MAX_PINES){
+        *grupo = (SP_GrupoPines){.numPines = (uint8_t)numPines};
+        for (unsigned i=0;i<numPines;++i){
+            SP_HPuerto const hPuerto = SP_Pin_getPuerto(pines[i]);
+            unsigned const linea = SP_Pin_getLinea(pines[i]);
+            grupo->puertos[i] = (uint8_t)hPuerto;
+            grupo->lineas[i] = (uint8_t)linea;
+            grupo->mascaras[hPuerto] |= 1U << linea;
+        }
+        hecho = true;
+    }
+    return hecho;
+}
+
+void SP_Pines_write(SP_GrupoPines const *const grupo, uint32_t const valores){
+    uint16_t altos[SP_NUM_PUERTOS] = {0};
+    for (unsigned i=0;i<grupo->numPines;++i){
+        if (valores & (1UL << i)) altos[grupo->puertos[i]] |= 1U << grupo->lineas[i];
+    }
+    for (SP_HPuerto hPuerto=0;hPuerto<SP_NUM_PUERTOS;++hPuerto){
+        if (grupo->mascaras[hPuerto]) SP_Puerto_writeMascara(hPuerto,grupo->mascaras[hPuerto],altos[hPuerto]);
+    }
+}
+
+uint32_t SP_Sim_Puerto_getEscrituras(SP_HPuerto hPuerto){
+    return puertos[hPuerto].escrituras;
+}
+
+void SP_Sim_Pin_setEntrada(SP_HPin hPin, bool nivel){
+    if(hPin >= SP_NUM_PINES) return;
+    Pin const *const pin = pinDeHandle(hPin);
+    PuertoSim *const p = puertos + pin->puerto;
+    modificaLinea(&p->externas,pin->nrPin,true);
+    modificaLinea(&p->nivelesExternos,pin->nrPin,nivel);
+    actualizaEntradas(pin->puerto);
+}
+
+void SP_Sim_Pin_liberaEntrada(SP_HPin hPin){
+    if(hPin >= SP_NUM_PINES) return;
+    Pin const *const pin = pinDeHandle(hPin);
+    modificaLinea(&puertos[pin->puerto].externas,pin->nrPin,false);
+    actualizaEntradas(pin->puerto);
+}
+
+bool SP_Sim_Pin_getSalida(SP_HPin hPin){
+    Pin const *const pin = pinDeHandle(hPin);
+    return puertos[pin->puerto].odr & (1U << pin->nrPin);
+}
@@ -0,0 +1,76 @@
+#include "sp_sim_impl.h"
+#include <stdbool.h> // bool
+#include <stdint.h>  // uint32_t, uint8_t
+#include <stddef.h>  // size_t
+#include <sp_serie_buffer.h>
+
+/* Transmisión serie simulada */
+
+/*
+ * El DMA y el USART se modelan juntos: cada milisegundo de reloj
+ * virtual el canal entrega baudios/10 bytes (10 bits por byte) del
+ * buffer circular de sp_serie_buffer.c, de a tramos contiguos como el
+ * DMA de la placa, a la salida capturada, que se lee con
+ * SP_Sim_Serie_leeTransmitidos.
+ */
+
+#ifndef SP_SIM_SERIE_TAM_CAPTURA
+#define SP_SIM_SERIE_TAM_CAPTURA 4096
+#endif
+
+static uint32_t baudiosConfigurados;
+static uint32_t bitsAcumulados;        // En milésimas de bit
+
+static uint8_t captura[SP_SIM_SERIE_TAM_CAPTURA];
+static uint32_t capturados;
+static uint32_t leidos;
+
+void SP_Sim_Serie_reset(void){
+    SP_SerieBuffer_reinicia();
+    baudiosConfigurados = 0;
+    bitsAcumulados = 0;
+    capturados = 0;
+    leidos = 0;
+}
+
+void SP_Serie_init(uint32_t const baudios){
+    SP_Sim_Serie_reset();
+    baudiosConfigurados = baudios;
+}
+
+void DMA1_Channel4_IRQHandler(void){
+}
+
+void SP_Sim_Serie_avanza(void){
+    bitsAcumulados += baudiosConfigurados;
+    while (bitsAcumulados >= 10000 && SP_SerieBuffer_qPendientes()){
+        uint32_t n;
+        uint8_t const *const tramo = SP_SerieBuffer_tramo(&n);
+        if (n > bitsAcumulados / 10000) n = bitsAcumulados / 10000;
+        for (uint32_t i=0;i<n;++i){
+            if (capturados - leidos < SP_SIM_SERIE_TAM_CAPTURA){
+                captura[capturados++ % SP_SIM_SERIE_TAM_CAPTURA] = tramo[i];
+            }
+        }
+        bitsAcumulados -= n * 10000;
+        SP_SerieBuffer_libera(n);
+    }
+    if (!SP_SerieBuffer_qPendientes()) bitsAcumulados = 0;     // La línea queda libre
+}
+
+size_t SP_Sim_Serie_leeTransmitidos(void *const destino, size_t const tamano){
+    size_t n = 0;
+    uint8_t *const d = destino;
+    while (n < tamano && leidos != capturados){
+        d[n++] = captura[leidos++ % SP_SIM_SERIE_TAM_CAPTURA];
+    }
+    return n;
+}
+
+size_t SP_Serie_escribe(void const *const datos, size_t const tamano){
+    return SP_SerieBuffer_escribe(datos,tamano);
+}
+
+bool SP_Serie_qOcupado(void){
+    return SP_SerieBuffer_qPendientes();
+}
@@ -0,0 +1,71 @@
+#ifndef SP_SIM_IMPL_H
+#define SP_SIM_IMPL_H
+#include <soporte_placa_sim.h>
+#include <stdint.h>
+
+/**
+ * @brief Puertos GPIO simulados
+ * 
+ */
+enum SP_Sim_Puertos{
+    SP_SIM_PUERTO_A = SP_PUERTO_A,
+    SP_SIM_PUERTO_B = SP_PUERTO_B,
+    SP_SIM_PUERTO_C = SP_PUERTO_C,
+    SP_SIM_NUM_PUERTOS = SP_NUM_PUERTOS
+};
+
+/**
+ * @brief Obtiene el puerto y número de línea de un pin
+ * 
+ * @param hPin Handle al objeto Pin
+ * @param puerto Salida: puerto (SP_Sim_Puertos)
+ * @param linea Salida: número de pin dentro del puerto (0-15)
+ */
+void SP_Sim_Pin_ubicacion(SP_HPin hPin, unsigned *puerto, unsigned *linea);
+
+/**
+ * @brief Notifica un cambio del registro de entrada de un puerto
+ * al controlador EXTI simulado, que llama a los handlers de los
+ * flancos configurados
+ * 
+ * @param puerto Puerto que cambió
+ * @param idrAnterior Valor del registro de entrada antes del cambio
+ * @param idrNuevo Valor del registro de entrada luego del cambio
+ */
+void SP_Sim_Exti_procesaCambio(unsigned puerto, uint16_t idrAnterior, uint16_t idrNuevo);
+
+/**
+ * @brief Marcan el comienzo y el fin de una interrupción simulada.
+ * Al terminar la última interrupción en curso se atiende la
+ * expropiación pendiente
+ * 
+ */
+void SP_Sim_Interrupcion_entra(void);
+void SP_Sim_Interrupcion_sale(void);
+
+/**
+ * @brief Ejecuta la rutina de expropiación si hay una solicitud
+ * pendiente y nada la impide (interrupciones en curso o deshabilitadas)
+ * 
+ */
+void SP_Sim_Expropiacion_atiende(void);
+
+/**
+ * @brief Transmite los bytes que el USART simulado envía en un
+ * milisegundo
+ * 
+ */
+void SP_Sim_Serie_avanza(void);
+
+/**
+ * @brief Reinicia el estado de cada módulo simulado
+ * 
+ */
+void SP_Sim_Pin_reset(void);
+void SP_Sim_Exti_reset(void);
+void SP_Sim_Tiempo_reset(void);
+void SP_Sim_Expropiacion_reset(void);
+void SP_Sim_Perfil_reset(void);
+void SP_Sim_Serie_reset(void);
+
+#endif
@@ -0,0 +1,114 @@
+#include "sp_sim_impl.h"
+#include <stdbool.h> // bool, true, false
+#include <stdint.h>  // uint32_t
+#include <stddef.h>  // NULL
+#include <stm32f1xx.h>
+#include <sp_timeouts.h>
+
+/* Temporización simulada */
+
+/**
+ * @brief Reloj virtual, en ticks. Solo avanza con SP_Sim_Tiempo_avanza
+ * (o con las esperas de SP_Tiempo_delay y __WFI)
+ * 
+ */
+static uint64_t volatile ticks;
+static bool volatile despertarPendiente;
+static SP_Tiempo_Reposo reposo;
+static SP_Sim_Estimulo estimulo;
+static void *parametroEstimulo;
+
+void SP_Tiempo_init(void){
+}
+
+void SP_Tiempo_delay(uint32_t tiempo){
+    SP_Sim_Tiempo_avanza(tiempo);
+}
+
+void SP_Sim_Tiempo_reset(void){
+    ticks = 0;
+    despertarPendiente = false;
+    reposo = (SP_Tiempo_Reposo){0};
+    estimulo = NULL;
+    parametroEstimulo = NULL;
+    SP_Timeouts_reinicia();
+}
+
+void SysTick_Handler(void){
+    ++ticks;
+    uint32_t vencidos;
+    SP_PERFIL_MIDE(SysTick_Handler,vencidos = SP_Timeouts_procesa(1));
+    if (vencidos) despertarPendiente = true;
+}
+
+void SP_Sim_setEstimulo(SP_Sim_Estimulo const nuevoEstimulo, void *const param){
+    estimulo = nuevoEstimulo;
+    parametroEstimulo = param;
+}
+
+void SP_Sim_Tiempo_avanza(uint32_t milisegundos){
+    for (uint32_t i=0;i<milisegundos;++i){
+        SP_Sim_Interrupcion_entra();
+        for (unsigned t=0;t<SP_TIEMPO_TICKS_POR_MILISEGUNDO;++t) SysTick_Handler();
+        SP_Sim_Serie_avanza();
+        SP_Sim_Interrupcion_sale();
+        if (estimulo) estimulo(SP_Tiempo_getMilisegundos(),parametroEstimulo);
+    }
+}
+
+void SP_Sim_Tiempo_setMilisegundos(uint64_t milisegundos){
+    ticks = milisegundos * SP_TIEMPO_TICKS_POR_MILISEGUNDO;
+}
+
+uint32_t SP_Tiempo_getMilisegundos(void){
+    return (uint32_t)SP_Tiempo_getMilisegundos64();
+}
+
+uint64_t SP_Tiempo_getMilisegundos64(void){
+    return ticks / SP_TIEMPO_TICKS_POR_MILISEGUNDO;
+}
+
+/*
+ * El reloj virtual no avanza dentro de un tick: la cuenta del SysTick
+ * simulado está siempre al comienzo del tick
+ */
+uint64_t SP_Tiempo_getMicrosegundos64(void){
+    return ticks * SP_TIEMPO_MICROSEGUNDOS_POR_TICK;
+}
+
+void SP_Tiempo_despierta(void){
+    despertarPendiente = true;
+}
+
+SP_Tiempo_Reposo SP_Tiempo_getReposo(void){
+    return reposo;
+}
+
+/*
+ * En la placa simulada el procesamiento no consume tiempo virtual:
+ * el reloj solo avanza mientras el CPU "duerme". Cada milisegundo
+ * transcurrido dentro de SP_Tiempo_duerme se contabiliza en reposo.
+ */
+void SP_Tiempo_duerme(uint32_t const tiempoMaximo){
+    uint32_t const ticksHastaTimeout = SP_Timeouts_ticksHastaProximo();
+    uint32_t const limiteTimeouts = (ticksHastaTimeout == SP_TIEMPO_INDEFINIDO) ? SP_TIEMPO_INDEFINIDO
+                                  : (ticksHastaTimeout + SP_TIEMPO_TICKS_POR_MILISEGUNDO - 1) / SP_TIEMPO_TICKS_POR_MILISEGUNDO;
+    uint32_t const tiempo = (tiempoMaximo < limiteTimeouts) ? tiempoMaximo : limiteTimeouts;
+    if (despertarPendiente || !tiempo){
+        despertarPendiente = false;
+        return;
+    }
+    uint32_t dormido = 0;
+    if (estimulo){
+        do{
+            SP_Sim_Tiempo_avanza(1);
+            ++dormido;
+        }while(!despertarPendiente && dormido < tiempo);
+    }else{
+        SP_Sim_Tiempo_avanza(tiempo);
+        dormido = tiempo;
+    }
+    ++reposo.despertares;
+    reposo.milisegundosEnReposo += dormido;
+    despertarPendiente = false;
+}
@@ -0,0 +1,80 @@
+#ifndef STM32F1XX_SIM_H
+#define STM32F1XX_SIM_H
+
+#include <stdint.h>
+
+/*
+ * Sustituto de la cabecera CMSIS para la compilación nativa. Solo
+ * declara los intrínsecos que usan las librerías independientes
+ * del hardware (maquina_estado). Los periféricos no existen: el
+ * acceso a la placa se hace a través de soporte_placa.
+ */
+
+/**
+ * @brief Deshabilita las interrupciones simuladas
+ * 
+ */
+void __disable_irq(void);
+
+/**
+ * @brief Habilita las interrupciones simuladas
+ * 
+ */
+void __enable_irq(void);
+
+/**
+ * @brief Máscara de interrupciones simulada: 1 si están deshabilitadas
+ * 
+ */
+uint32_t __get_PRIMASK(void);
+
+/**
+ * @brief Deshabilita (1) o habilita (0) las interrupciones simuladas
+ * 
+ */
+void __set_PRIMASK(uint32_t primask);
+
+/**
+ * @brief Espera la próxima interrupción. En la placa simulada la
+ * próxima interrupción es el tick del SysTick, por lo que avanza
+ * el reloj virtual un milisegundo
+ * 
+ */
+void __WFI(void);
+
+/**
+ * @brief Carga exclusiva: lee el valor y registra la reserva del
+ * hilo sobre la dirección
+ * 
+ */
+uint32_t __LDREXW(volatile uint32_t *direccion);
+
+/**
+ * @brief Almacenamiento exclusivo: escribe solo si la dirección no
+ * cambió desde el __LDREXW del mismo hilo
+ * 
+ * @return uint32_t 0 si escribió, 1 si falló
+ */
+uint32_t __STREXW(uint32_t valor, volatile uint32_t *direccion);
+
+/**
+ * @brief Descarta la reserva de __LDREXW
+ * 
+ */
+void __CLREX(void);
+
+/**
+ * @brief Barrera de memoria
+ * 
+ */
+void __DMB(void);
+
+/**
+ * @brief Cantidad de ceros a la izquierda (32 si valor es 0)
+ * 
+ */
+static inline uint8_t __CLZ(uint32_t valor){
+    return valor ? (uint8_t)__builtin_clz(valor) : 32;
+}
+
+#endif
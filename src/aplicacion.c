@@ -0,0 +1,90 @@
+#include "aplicacion.h"
+#include "controlador_luz.h"
+#include "controlador_de_pulsaciones.h"
+#include "pulsador.h"
+#include "despacho_retardado.h"
+#include <planificador.h>
+#include <stddef.h>
+
+
+static Maquina * controladorLuz;
+static Maquina * controladorPulsaciones;
+static Pulsador pulsador[1];
+static DespachoRetardado despachoRetardado[1];
+static Planificador planificador[1];
+
+
+/*
+ * El despacho retardado es compartido con las máquinas de estado: en
+ * modo expropiativo se bloquea la expropiación mientras el lazo
+ * principal lo usa (ver Planificador_bloquea).
+ */
+#define TECHO_DESPACHO_RETARDADO PRIORIDAD_CONTROLADOR_LUZ
+
+bool Aplicacion_procesa(void){
+    bool procesado = false;
+    uint32_t const nivel = Planificador_bloquea(planificador,TECHO_DESPACHO_RETARDADO);
+    SP_PERFIL_MIDE(DespachoRetardado_procesarDespacho,DespachoRetardado_procesarDespacho(despachoRetardado));
+    SP_PERFIL_MIDE(Pulsador_procesa,Pulsador_procesa(pulsador));
+    Planificador_desbloquea(planificador,nivel);
+    while (Planificador_procesa(planificador)){             //Procesa en el mismo paso los eventos que generan otros eventos
+        procesado = true;
+    }
+    return procesado;
+}
+
+static uint32_t minimo(uint32_t a, uint32_t b){
+    return (a < b) ? a : b;
+}
+
+uint32_t Aplicacion_tiempoHastaProximoEvento(void){
+    uint32_t tiempo = 0;
+    if (!Planificador_hayListas(planificador)){
+        uint32_t const nivel = Planificador_bloquea(planificador,TECHO_DESPACHO_RETARDADO);
+        tiempo = minimo(DespachoRetardado_tiempoHastaProximoDespacho(despachoRetardado),
+                        Pulsador_tiempoHastaProximaLectura(pulsador));
+        Planificador_desbloquea(planificador,nivel);
+    }
+    return tiempo;
+}
+
+#if APLICACION_EXPROPIATIVA
+static void Aplicacion__expropia(void){
+    Planificador_expropia(planificador);
+}
+#endif
+
+void Aplicacion_init(void){
+    static ControladorLuz instanciaControlador;
+    static ControladorDePulsaciones instanciaPulsaciones;
+    
+    SP_init();
+    
+    DespachoRetardado_init(despachoRetardado);
+#if APLICACION_EXPROPIATIVA
+    SP_Expropiacion_init(Aplicacion__expropia);
+    Planificador_initExpropiativo(planificador,SP_Expropiacion_solicita);
+#else
+    Planificador_init(planificador);
+#endif
+
+    ControladorLuz_init(&instanciaControlador,TIEMPO_ON,PIN_LUZ,LUZ_ON,despachoRetardado);
+    controladorLuz = ControladorLuz_asMaquina(&instanciaControlador);
+    Maquina_procesa(controladorLuz); // Reset inicializa pin con luz apagada
+    
+    ControladorDePulsaciones_init(&instanciaPulsaciones,controladorLuz,despachoRetardado,TIEMPO_TRIPLE_PULSACION);
+    controladorPulsaciones = ControladorDePulsaciones_asMaquina(&instanciaPulsaciones);
+
+    Planificador_registra(planificador,controladorLuz,PRIORIDAD_CONTROLADOR_LUZ);
+    Planificador_registra(planificador,controladorPulsaciones,PRIORIDAD_CONTROLADOR_PULSACIONES);
+
+    Pulsador_init(pulsador, 
+                  controladorPulsaciones,
+                  EV_BOTON_PULSADO,
+                  PIN_PULSADOR,
+                  PULSADOR_NIVEL_ACTIVO,
+                  HISTERESIS_ANTIRREBOTE);
+#if APLICACION_REPOSO
+    Pulsador_habilitaDespertar(pulsador);
+#endif
+}
@@ -5,10 +5,13 @@ static Resultado estadoEspera(Maquina *contexto, Evento evento);
 static Resultado estadoCuenta(Maquina *contexto, Evento evento);
 
 void ControladorDePulsaciones_init (ControladorDePulsaciones *self, Maquina *maq_destino, DespachoRetardado *despachoRetardado, uint32_t tiempoPulsaciones){
-    Maquina_init(&self->maquina,estadoEspera);
+    Maquina_initConCola(&self->maquina,estadoEspera,self->cola,CONTROLADOR_DE_PULSACIONES_CAPACIDAD_COLA);
+    Maquina_setPoliticaDesborde(&self->maquina,MAQUINA_DESBORDE_RESERVA_FUSIONABLES,NULL);
+    Maquina_setEventosFusionables(&self->maquina,MAQUINA_BIT_EVENTO(EV_TIMEOUT));       //Las pulsaciones se cuentan: no se fusionan
     self->destino = maq_destino;
     self->despachoRetardado = despachoRetardado;
     self->tiempoPulsaciones = tiempoPulsaciones;
+    self->hTimeout = DESPACHO_RETARDADO_HANDLE_NULO;
 }
 
 Maquina * ControladorDePulsaciones_asMaquina(ControladorDePulsaciones *self) {
@@ -21,12 +24,11 @@ static Resultado estadoEspera(Maquina *contexto, Evento evento) {
     switch (evento) {
     case EV_BOTON_PULSADO:
         Maquina_despacha(self->destino,EV_BOTON_PULSADO);
-        DespachoRetardado_programarDespacho(self->despachoRetardado,contexto,EV_TIMEOUT,self->tiempoPulsaciones);
+        self->hTimeout = DespachoRetardado_programar(self->despachoRetardado,contexto,EV_TIMEOUT,self->tiempoPulsaciones);
         self->contadorPulsaciones = 1;
-        r.codigo = RES_TRANSICION;
-        r.nuevoEstado = estadoCuenta;
+        r = Resultado_transicion(estadoCuenta);
     break;default:
-        r.codigo = RES_IGNORADO;
+        r = Resultado_ignorado();
     break;
     }
     return r;
@@ -39,18 +41,17 @@ static Resultado estadoCuenta(Maquina *contexto, Evento evento) {
         case EV_BOTON_PULSADO:
         if(self->contadorPulsaciones < 2) {
             self->contadorPulsaciones++;
-            r.codigo = RES_PROCESADO;
+            r = Resultado_procesado();
         }
         else {
             Maquina_despacha(self->destino,EV_TRIPLE_PULSACION);
-            r.codigo = RES_TRANSICION;
-            r.nuevoEstado = estadoEspera;
+            DespachoRetardado_cancelarDespacho(self->despachoRetardado,self->hTimeout);
+            r = Resultado_transicion(estadoEspera);
         }
         break;case EV_TIMEOUT:
-            r.codigo = RES_TRANSICION;
-            r.nuevoEstado = estadoEspera;
+            r = Resultado_transicion(estadoEspera);
         break;default:
-        r.codigo = RES_IGNORADO;
+        r = Resultado_ignorado();
         break;
     }
     return r;
@@ -1,21 +1,69 @@
 #include "controlador_luz.h"
 #include <maquina_estado_impl.h>
 
+#if !CONTROLADOR_LUZ_TABLA
+
+/*
+ * Controlador de luz de escalera como máquina de estado jerárquica.
+ * La luz se enciende y apaga en la entrada y salida de LUZ_ENCENDIDA
+ * y el timeout se programa y cancela en la entrada y salida de
+ * TEMPORIZADO, en lugar de repetirlo en cada transición.
+ *
+ *  CONTROLADOR (entrada: configura el pin con la luz apagada)
+ *  ├── APAGADO
+ *  └── LUZ_ENCENDIDA (entrada: luzOn(); salida: luzOff())
+ *      ├── TEMPORIZADO (entrada: setTimeout(tiempoOn); salida: cancelaTimeout())
+ *      └── MUDANZA
+ */
+
 static Resultado estadoApagado(Maquina *contexto,Evento evento);
-static Resultado estadoEncendido(Maquina *contexto,Evento evento);
+static Resultado estadoTemporizado(Maquina *contexto,Evento evento);
 static Resultado estadoMudanza (Maquina *contexto, Evento evento);
+static void entraControlador(Maquina *contexto);
+static void entraLuzEncendida(Maquina *contexto);
+static void saleLuzEncendida(Maquina *contexto);
+static void entraTemporizado(Maquina *contexto);
+static void saleTemporizado(Maquina *contexto);
+
+static EstadoJerarquico const CONTROLADOR = {
+    .entrada = entraControlador,
+};
+static EstadoJerarquico const APAGADO = {
+    .padre = &CONTROLADOR,
+    .procesa = estadoApagado,
+};
+static EstadoJerarquico const TEMPORIZADO;
+static EstadoJerarquico const LUZ_ENCENDIDA = {
+    .padre = &CONTROLADOR,
+    .entrada = entraLuzEncendida,
+    .salida = saleLuzEncendida,
+    .inicial = &TEMPORIZADO,
+};
+static EstadoJerarquico const TEMPORIZADO = {
+    .padre = &LUZ_ENCENDIDA,
+    .procesa = estadoTemporizado,
+    .entrada = entraTemporizado,
+    .salida = saleTemporizado,
+};
+static EstadoJerarquico const MUDANZA = {
+    .padre = &LUZ_ENCENDIDA,
+    .procesa = estadoMudanza,
+};
 
 void ControladorLuz_init(ControladorLuz *self,uint32_t tiempoOn,SP_HPin pinLuz,bool nivelLuzOn,DespachoRetardado *despachoRetardado){
 
-    Maquina_init(&self->maquina,estadoApagado);
+    MaquinaJerarquica_initConCola(&self->maquina,&APAGADO,self->cola,CONTROLADOR_LUZ_CAPACIDAD_COLA);
+    Maquina_setPoliticaDesborde(ControladorLuz_asMaquina(self),MAQUINA_DESBORDE_RESERVA_FUSIONABLES,NULL);
+    Maquina_setEventosFusionables(ControladorLuz_asMaquina(self),MAQUINA_BIT_EVENTO(EV_TIMEOUT));
     self->tiempoOn = tiempoOn;
     self->interfazLuz.pin=pinLuz;
     self->interfazLuz.nivelOn=nivelLuzOn;
     self->despachoRetardado = despachoRetardado;
+    self->hTimeout = DESPACHO_RETARDADO_HANDLE_NULO;
 }
 
 Maquina * ControladorLuz_asMaquina(ControladorLuz *self){
-    return &self->maquina;
+    return MaquinaJerarquica_asMaquina(&self->maquina);
 }
 
 static void ControladorLuz__apagaLuz(ControladorLuz *self){
@@ -26,55 +74,54 @@ static void ControladorLuz__enciendeLuz(ControladorLuz *self){
     SP_Pin_write(self->interfazLuz.pin,self->interfazLuz.nivelOn);
 }
 
-static Resultado estadoApagado(Maquina *contexto,Evento evento){
-    ControladorLuz *self = (ControladorLuz*)contexto;               //Typecast Puntero a maquina -> Puntero a controlador luz
-    Resultado r = {0};                                              //r es de tipo resultado
-    switch (evento){
-    case EV_RESET:                                                  //Si se produce "RESET" en apagado
-        SP_Pin_setModo(self->interfazLuz.pin,SP_PIN_ENTRADA);       
-        ControladorLuz__apagaLuz(self);                             //Apago la luz
-        SP_Pin_setModo(self->interfazLuz.pin,SP_PIN_SALIDA);
-        r.codigo = RES_PROCESADO;                               //Indico que hay un cambio de estado
-    break; case EV_BOTON_PULSADO:                                   //Si se pulsa el boton
-        ControladorLuz__enciendeLuz(self);                          //Enciendo la luz
-        DespachoRetardado_programarDespacho(self->despachoRetardado,contexto,EV_TIMEOUT,self->tiempoOn); //Configuro el Timeout           
-        r.codigo = RES_TRANSICION;                               //Indico un cambio de estado
-        r.nuevoEstado = estadoEncendido;                            //El nuevo estado será encendido
-    break;default:
-        r.codigo = RES_IGNORADO;                                 //Si pasa algun otro evento lo ignora
-    break;
-    }
-    return r;                                                       //Retorno el resultado con el código del mismo y el nuevo estado (de ser necesario)
+static void entraControlador(Maquina *contexto){
+    ControladorLuz *self = (ControladorLuz*)contexto;
+    SP_Pin_setModo(self->interfazLuz.pin,SP_PIN_ENTRADA);
+    ControladorLuz__apagaLuz(self);                                 //Fija el nivel antes de habilitar la salida
+    SP_Pin_setModo(self->interfazLuz.pin,SP_PIN_SALIDA);
+}
+
+static void entraLuzEncendida(Maquina *contexto){
+    ControladorLuz__enciendeLuz((ControladorLuz*)contexto);
+}
+
+static void saleLuzEncendida(Maquina *contexto){
+    ControladorLuz__apagaLuz((ControladorLuz*)contexto);
+}
+
+static void entraTemporizado(Maquina *contexto){
+    ControladorLuz *self = (ControladorLuz*)contexto;
+    self->hTimeout = DespachoRetardado_programar(self->despachoRetardado,contexto,EV_TIMEOUT,self->tiempoOn);
 }
-static Resultado estadoEncendido(Maquina *contexto,Evento evento){
+
+static void saleTemporizado(Maquina *contexto){
     ControladorLuz *self = (ControladorLuz*)contexto;
-    Resultado r = {0};
+    DespachoRetardado_cancelarDespacho(self->despachoRetardado,self->hTimeout);    //Sin efecto si ya venció
+}
+
+static Resultado estadoApagado(Maquina *contexto,Evento evento){
+    Resultado r = Resultado_ignorado();
+    if (evento == EV_BOTON_PULSADO) r = MaquinaJerarquica_transicion(contexto,&LUZ_ENCENDIDA);
+    return r;
+}
+
+static Resultado estadoTemporizado(Maquina *contexto,Evento evento){
+    Resultado r = Resultado_ignorado();
     switch (evento){
-    case EV_TIMEOUT:                                                //Si ocurre el TIMEOUT
-        ControladorLuz__apagaLuz(self);                             //Apago la luz
-        r.codigo = RES_TRANSICION;                             
-        r.nuevoEstado = estadoApagado;                              //Cambio a estado apagado                              
-    break; case EV_TRIPLE_PULSACION:                                //Si llego a las tres pulsaciones
-        r.codigo = RES_TRANSICION;                               
-        r.nuevoEstado = estadoMudanza;                              //Paso al estado mudanza
+    case EV_TIMEOUT:
+        r = MaquinaJerarquica_transicion(contexto,&APAGADO);
+    break; case EV_TRIPLE_PULSACION:
+        r = MaquinaJerarquica_transicion(contexto,&MUDANZA);
     break;default:
-        r.codigo = RES_IGNORADO;
     break;
     }
     return r;
 }
 
 static Resultado estadoMudanza(Maquina *contexto,Evento evento){
-    ControladorLuz *self = (ControladorLuz*)contexto;
-    Resultado r = {0};
-    switch (evento){
-    case EV_TRIPLE_PULSACION:
-        ControladorLuz__apagaLuz(self);
-        r.codigo = RES_TRANSICION;
-        r.nuevoEstado = estadoApagado;
-    break;default:
-        r.codigo = RES_IGNORADO;
-    break;
-    }
+    Resultado r = Resultado_ignorado();
+    if (evento == EV_TRIPLE_PULSACION) r = MaquinaJerarquica_transicion(contexto,&APAGADO);
     return r;
-}
\ No newline at end of file
+}
+
+#endif
@@ -0,0 +1,106 @@
+#include "controlador_luz.h"
+
+#if CONTROLADOR_LUZ_TABLA
+
+/*
+ * Controlador de luz de escalera como máquina de estado por tabla.
+ * Mismo comportamiento que la implementación jerárquica de
+ * controlador_luz.c (CONTROLADOR_LUZ_TABLA=0); las pruebas de
+ * test/native/test_aplicacion verifican ambas
+ */
+
+enum EstadoControladorLuz{
+    APAGADO,
+    ENCENDIDO,
+    MUDANZA,
+    NUM_ESTADOS
+};
+
+enum AccionControladorLuz{
+    INICIALIZA,
+    ENCIENDE,
+    APAGA,
+    ENTRA_MUDANZA,
+    NUM_ACCIONES
+};
+
+enum {NUM_EVENTOS = MT_EVENTO(EV_TIMEOUT) + 1};
+
+static void ControladorLuz__apagaLuz(ControladorLuz *self){
+    SP_Pin_write(self->interfazLuz.pin,!self->interfazLuz.nivelOn);
+}
+
+static void ControladorLuz__enciendeLuz(ControladorLuz *self){
+    SP_Pin_write(self->interfazLuz.pin,self->interfazLuz.nivelOn);
+}
+
+static void accionInicializa(Maquina *contexto, Evento evento){
+    ControladorLuz *self = (ControladorLuz*)contexto;
+    (void)evento;
+    SP_Pin_setModo(self->interfazLuz.pin,SP_PIN_ENTRADA);
+    ControladorLuz__apagaLuz(self);
+    SP_Pin_setModo(self->interfazLuz.pin,SP_PIN_SALIDA);
+}
+
+static void accionEnciende(Maquina *contexto, Evento evento){
+    ControladorLuz *self = (ControladorLuz*)contexto;
+    (void)evento;
+    ControladorLuz__enciendeLuz(self);
+    self->hTimeout = DespachoRetardado_programar(self->despachoRetardado,contexto,EV_TIMEOUT,self->tiempoOn);
+}
+
+static void accionApaga(Maquina *contexto, Evento evento){
+    (void)evento;
+    ControladorLuz__apagaLuz((ControladorLuz*)contexto);
+}
+
+static void accionEntraMudanza(Maquina *contexto, Evento evento){
+    ControladorLuz *self = (ControladorLuz*)contexto;
+    (void)evento;
+    DespachoRetardado_cancelarDespacho(self->despachoRetardado,self->hTimeout);   //En mudanza no hay timeout
+}
+
+static MaquinaTabla_Accion const acciones[NUM_ACCIONES] = {
+    [INICIALIZA]    = accionInicializa,
+    [ENCIENDE]      = accionEnciende,
+    [APAGA]         = accionApaga,
+    [ENTRA_MUDANZA] = accionEntraMudanza,
+};
+
+static MaquinaTabla_Transicion const transiciones[NUM_ESTADOS][NUM_EVENTOS] = {
+    [APAGADO] = {
+        [MT_EVENTO(EV_RESET)]            = MT_ACCION(INICIALIZA),
+        [MT_EVENTO(EV_BOTON_PULSADO)]    = MT_TRANSICION(ENCIENDE,ENCENDIDO),
+    },
+    [ENCENDIDO] = {
+        [MT_EVENTO(EV_TIMEOUT)]          = MT_TRANSICION(APAGA,APAGADO),
+        [MT_EVENTO(EV_TRIPLE_PULSACION)] = MT_TRANSICION(ENTRA_MUDANZA,MUDANZA),
+    },
+    [MUDANZA] = {
+        [MT_EVENTO(EV_TRIPLE_PULSACION)] = MT_TRANSICION(APAGA,APAGADO),
+    },
+};
+
+static MaquinaTabla_Definicion const definicion = {
+    .transiciones = &transiciones[0][0],
+    .acciones = acciones,
+    .numEventos = NUM_EVENTOS,
+    .estadoInicial = APAGADO,
+};
+
+void ControladorLuz_init(ControladorLuz *self,uint32_t tiempoOn,SP_HPin pinLuz,bool nivelLuzOn,DespachoRetardado *despachoRetardado){
+    self->tiempoOn = tiempoOn;
+    self->interfazLuz.pin=pinLuz;
+    self->interfazLuz.nivelOn=nivelLuzOn;
+    self->despachoRetardado = despachoRetardado;
+    self->hTimeout = DESPACHO_RETARDADO_HANDLE_NULO;
+    MaquinaTabla_initConCola(&self->maquina,&definicion,self->cola,CONTROLADOR_LUZ_CAPACIDAD_COLA);
+    Maquina_setPoliticaDesborde(ControladorLuz_asMaquina(self),MAQUINA_DESBORDE_RESERVA_FUSIONABLES,NULL);
+    Maquina_setEventosFusionables(ControladorLuz_asMaquina(self),MAQUINA_BIT_EVENTO(EV_TIMEOUT));
+}
+
+Maquina * ControladorLuz_asMaquina(ControladorLuz *self){
+    return MaquinaTabla_asMaquina(&self->maquina);
+}
+
+#endif
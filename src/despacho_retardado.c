@@ -1,29 +1,87 @@
 #include <despacho_retardado.h>
 #include <soporte_placa.h>
 
+#if !DESPACHO_RETARDADO_MONTICULO
+
 void DespachoRetardado_init(DespachoRetardado *self){
     *self = (DespachoRetardado){0};
+    self->t0 = SP_Tiempo_getMilisegundos();
 }
 
-void DespachoRetardado_programarDespacho(DespachoRetardado *self, Maquina *const destino, Evento const evento, uint32_t const tiempoMilisegundos){
+DespachoRetardado_HDespacho DespachoRetardado_programar(DespachoRetardado *self, Maquina *const destino, Evento const evento, uint32_t const tiempoMilisegundos){
     size_t i;
     size_t const N = self->numDespachosEnEspera;
     struct DespachoEnEspera *const d = self->despachosEnEspera;
+    DespachoRetardado_HDespacho handle = DESPACHO_RETARDADO_HANDLE_NULO;
     for(i=0;i<N;++i){
         if((destino == d[i].destino) && (evento == d[i].evento)) break;
     }
     if (i<MAX_DESPACHOS_RETARDADOS_ACTIVOS){
-        d[i].cuenta  = tiempoMilisegundos;
+        d[i].cuenta  = tiempoMilisegundos + (SP_Tiempo_getMilisegundos() - self->t0);
         d[i].destino = destino;
         d[i].evento  = evento;
-        if (N == i)
+        if (N == i){
+            if (++self->ultimoHandle == DESPACHO_RETARDADO_HANDLE_NULO) ++self->ultimoHandle;
+            d[i].handle = self->ultimoHandle;
             self->numDespachosEnEspera = N+1;
+        }
+        handle = d[i].handle;
     }else{
         Maquina_despacha(destino,evento);
     }
+    return handle;
 }
 
+void DespachoRetardado_programarDespacho(DespachoRetardado *self, Maquina *const destino, Evento const evento, uint32_t const tiempoMilisegundos){
+    DespachoRetardado_programar(self,destino,evento,tiempoMilisegundos);
+}
 
+/**
+ * @brief Busca un despacho por su handle
+ * 
+ * @return size_t Posición en el arreglo o numDespachosEnEspera si no existe
+ */
+static size_t DespachoRetardado__buscaHandle(DespachoRetardado const *self, DespachoRetardado_HDespacho hDespacho){
+    size_t i;
+    size_t const N = self->numDespachosEnEspera;
+    for(i=0;i<N;++i){
+        if(hDespacho == self->despachosEnEspera[i].handle) break;
+    }
+    return i;
+}
+
+bool DespachoRetardado_reprogramar(DespachoRetardado *self, DespachoRetardado_HDespacho hDespacho, uint32_t const tiempoMilisegundos){
+    size_t const i = DespachoRetardado__buscaHandle(self,hDespacho);
+    bool const valido = (hDespacho != DESPACHO_RETARDADO_HANDLE_NULO) && (i < self->numDespachosEnEspera);
+    if (valido){
+        self->despachosEnEspera[i].cuenta = tiempoMilisegundos + (SP_Tiempo_getMilisegundos() - self->t0);
+    }
+    return valido;
+}
+
+bool DespachoRetardado_cancelarDespacho(DespachoRetardado *self, DespachoRetardado_HDespacho hDespacho){
+    size_t const i = DespachoRetardado__buscaHandle(self,hDespacho);
+    size_t const N = self->numDespachosEnEspera;
+    bool const valido = (hDespacho != DESPACHO_RETARDADO_HANDLE_NULO) && (i < N);
+    if (valido){
+        self->despachosEnEspera[i] = self->despachosEnEspera[N-1];
+        self->numDespachosEnEspera = N-1;
+    }
+    return valido;
+}
+
+bool DespachoRetardado_cancelar(DespachoRetardado *self, Maquina *const destino, Evento const evento){
+    size_t const N = self->numDespachosEnEspera;
+    struct DespachoEnEspera *const d = self->despachosEnEspera;
+    for(size_t i=0;i<N;++i){
+        if((destino == d[i].destino) && (evento == d[i].evento)){
+            d[i] = d[N-1];
+            self->numDespachosEnEspera = N-1;
+            return true;
+        }
+    }
+    return false;
+}
 
 void DespachoRetardado_procesarDespacho(DespachoRetardado * self){
     uint32_t const t = SP_Tiempo_getMilisegundos();
@@ -48,4 +106,18 @@ void DespachoRetardado_procesarDespacho(DespachoRetardado * self){
         }
         self->numDespachosEnEspera = N;
     }
-}
\ No newline at end of file
+}
+
+uint32_t DespachoRetardado_tiempoHastaProximoDespacho(DespachoRetardado const *self){
+    uint32_t const dt = SP_Tiempo_getMilisegundos() - self->t0;
+    uint32_t minimo = SP_TIEMPO_INDEFINIDO;
+    size_t const N = self->numDespachosEnEspera;
+    struct DespachoEnEspera const *const d = self->despachosEnEspera;
+    for(size_t i=0;i<N;++i){
+        uint32_t const restante = (d[i].cuenta > dt) ? d[i].cuenta - dt : 0;
+        if (restante < minimo) minimo = restante;
+    }
+    return minimo;
+}
+
+#endif
@@ -0,0 +1,242 @@
+#include <despacho_retardado.h>
+#include <soporte_placa.h>
+#include <stdint.h>
+
+#if DESPACHO_RETARDADO_MONTICULO
+
+/*
+ * Los despachos en espera son nodos de un arreglo fijo. Cada nodo
+ * activo está a la vez:
+ *  - en el montículo (monticulo[]), ordenado por vencimiento absoluto,
+ *    de modo que el próximo despacho siempre está en la cima;
+ *  - en una cubeta del índice hash por (destino, evento), para
+ *    encontrarlo al reprogramar o cancelar sin recorrer la lista.
+ * Los nodos inactivos forman la lista libre.
+ *
+ * Un handle combina el índice del nodo (16 bits bajos) con su
+ * generación (16 bits altos). La generación avanza cada vez que el
+ * nodo se libera, de modo que los handles de despachos ya vencidos o
+ * cancelados dejan de ser válidos aunque el nodo se reutilice.
+ */
+
+enum {NINGUNO = 0xFFFF};
+
+typedef struct DespachoEnEspera DespachoEnEspera;
+
+/**
+ * @brief Compara instantes tolerando el desborde del contador de
+ * milisegundos (válido para diferencias menores a 2^31 ms)
+ *
+ * @return true El instante a es anterior al instante b
+ */
+static bool anterior(uint32_t a, uint32_t b){
+    return (int32_t)(a - b) < 0;
+}
+
+static size_t cubetaDe(Maquina const *destino, Evento evento){
+    uint32_t const h = ((uint32_t)(uintptr_t)destino >> 2) * 2654435761u ^ (evento * 40503u);
+    return (h ^ (h >> 16)) & (DESPACHO_RETARDADO_CUBETAS - 1);
+}
+
+void DespachoRetardado_init(DespachoRetardado *self){
+    *self = (DespachoRetardado){0};
+    for (size_t i=0;i<DESPACHO_RETARDADO_CUBETAS;++i){
+        self->cubetas[i] = NINGUNO;
+    }
+    for (size_t i=0;i<MAX_DESPACHOS_RETARDADOS_ACTIVOS;++i){
+        self->despachosEnEspera[i].siguiente = (i+1 < MAX_DESPACHOS_RETARDADOS_ACTIVOS) ? i+1 : NINGUNO;
+        self->despachosEnEspera[i].generacion = 1;
+    }
+    self->libres = 0;
+}
+
+/* Montículo */
+
+static bool DespachoRetardado__qVenceAntes(DespachoRetardado const *self, size_t posA, size_t posB){
+    DespachoEnEspera const *const d = self->despachosEnEspera;
+    return anterior(d[self->monticulo[posA]].vencimiento, d[self->monticulo[posB]].vencimiento);
+}
+
+static void DespachoRetardado__ubica(DespachoRetardado *self, size_t pos, uint16_t nodo){
+    self->monticulo[pos] = nodo;
+    self->despachosEnEspera[nodo].posicion = pos;
+}
+
+static void DespachoRetardado__intercambia(DespachoRetardado *self, size_t posA, size_t posB){
+    uint16_t const nodoA = self->monticulo[posA];
+    DespachoRetardado__ubica(self,posA,self->monticulo[posB]);
+    DespachoRetardado__ubica(self,posB,nodoA);
+}
+
+static void DespachoRetardado__subeNodo(DespachoRetardado *self, size_t pos){
+    while (pos > 0){
+        size_t const padre = (pos - 1) / 2;
+        if (!DespachoRetardado__qVenceAntes(self,pos,padre)) break;
+        DespachoRetardado__intercambia(self,pos,padre);
+        pos = padre;
+    }
+}
+
+static void DespachoRetardado__bajaNodo(DespachoRetardado *self, size_t pos){
+    size_t const N = self->numDespachosEnEspera;
+    for (;;){
+        size_t const izquierdo = 2*pos + 1;
+        size_t const derecho = izquierdo + 1;
+        size_t menor = pos;
+        if (izquierdo < N && DespachoRetardado__qVenceAntes(self,izquierdo,menor)) menor = izquierdo;
+        if (derecho < N && DespachoRetardado__qVenceAntes(self,derecho,menor)) menor = derecho;
+        if (menor == pos) break;
+        DespachoRetardado__intercambia(self,pos,menor);
+        pos = menor;
+    }
+}
+
+/**
+ * @brief Restituye el orden del montículo luego de cambiar el
+ * vencimiento del nodo en la posición dada
+ *
+ */
+static void DespachoRetardado__reubica(DespachoRetardado *self, size_t pos){
+    if (pos > 0 && DespachoRetardado__qVenceAntes(self,pos,(pos - 1) / 2)){
+        DespachoRetardado__subeNodo(self,pos);
+    }else{
+        DespachoRetardado__bajaNodo(self,pos);
+    }
+}
+
+/* Índice por (destino, evento) */
+
+static uint16_t DespachoRetardado__busca(DespachoRetardado const *self, Maquina const *destino, Evento evento){
+    DespachoEnEspera const *const d = self->despachosEnEspera;
+    uint16_t nodo = self->cubetas[cubetaDe(destino,evento)];
+    while (nodo != NINGUNO && !(d[nodo].destino == destino && d[nodo].evento == evento)){
+        nodo = d[nodo].siguiente;
+    }
+    return nodo;
+}
+
+static void DespachoRetardado__quitaDeCubeta(DespachoRetardado *self, uint16_t nodo){
+    DespachoEnEspera *const d = self->despachosEnEspera;
+    uint16_t *enlace = &self->cubetas[cubetaDe(d[nodo].destino,d[nodo].evento)];
+    while (*enlace != nodo){
+        enlace = &d[*enlace].siguiente;
+    }
+    *enlace = d[nodo].siguiente;
+}
+
+/**
+ * @brief Quita un nodo del montículo y del índice y lo devuelve a la
+ * lista libre
+ *
+ * @param self Este objeto
+ * @param nodo Nodo activo
+ */
+static void DespachoRetardado__libera(DespachoRetardado *self, uint16_t nodo){
+    DespachoEnEspera *const d = self->despachosEnEspera;
+    size_t const pos = d[nodo].posicion;
+    size_t const ultimo = --self->numDespachosEnEspera;
+    if (pos != ultimo){
+        DespachoRetardado__ubica(self,pos,self->monticulo[ultimo]);
+        DespachoRetardado__reubica(self,pos);
+    }
+    DespachoRetardado__quitaDeCubeta(self,nodo);
+    if (++d[nodo].generacion == 0) d[nodo].generacion = 1;
+    d[nodo].siguiente = self->libres;
+    self->libres = nodo;
+}
+
+static DespachoRetardado_HDespacho DespachoRetardado__handleDe(DespachoRetardado const *self, uint16_t nodo){
+    return ((DespachoRetardado_HDespacho)self->despachosEnEspera[nodo].generacion << 16) | nodo;
+}
+
+/**
+ * @brief Obtiene el nodo activo correspondiente a un handle
+ *
+ * @return uint16_t Nodo o NINGUNO si el handle no es válido
+ */
+static uint16_t DespachoRetardado__nodoDe(DespachoRetardado const *self, DespachoRetardado_HDespacho hDespacho){
+    uint16_t const nodo = hDespacho & 0xFFFF;
+    bool const valido = (hDespacho != DESPACHO_RETARDADO_HANDLE_NULO)
+                     && (nodo < MAX_DESPACHOS_RETARDADOS_ACTIVOS)
+                     && (DespachoRetardado__handleDe(self,nodo) == hDespacho)
+                     && (self->despachosEnEspera[nodo].posicion < self->numDespachosEnEspera)
+                     && (self->monticulo[self->despachosEnEspera[nodo].posicion] == nodo);
+    return valido ? nodo : NINGUNO;
+}
+
+DespachoRetardado_HDespacho DespachoRetardado_programar(DespachoRetardado *self, Maquina *const destino, Evento const evento, uint32_t const tiempoMilisegundos){
+    DespachoEnEspera *const d = self->despachosEnEspera;
+    uint32_t const vencimiento = SP_Tiempo_getMilisegundos() + tiempoMilisegundos;
+    uint16_t nodo = DespachoRetardado__busca(self,destino,evento);
+    if (nodo != NINGUNO){
+        d[nodo].vencimiento = vencimiento;
+        DespachoRetardado__reubica(self,d[nodo].posicion);
+    }else if (self->libres != NINGUNO){
+        nodo = self->libres;
+        self->libres = d[nodo].siguiente;
+        d[nodo].destino = destino;
+        d[nodo].evento = evento;
+        d[nodo].vencimiento = vencimiento;
+        size_t const cubeta = cubetaDe(destino,evento);
+        d[nodo].siguiente = self->cubetas[cubeta];
+        self->cubetas[cubeta] = nodo;
+        size_t const pos = self->numDespachosEnEspera++;
+        DespachoRetardado__ubica(self,pos,nodo);
+        DespachoRetardado__subeNodo(self,pos);
+    }else{
+        Maquina_despacha(destino,evento);
+    }
+    return (nodo != NINGUNO) ? DespachoRetardado__handleDe(self,nodo) : DESPACHO_RETARDADO_HANDLE_NULO;
+}
+
+void DespachoRetardado_programarDespacho(DespachoRetardado *self, Maquina *const destino, Evento const evento, uint32_t const tiempoMilisegundos){
+    DespachoRetardado_programar(self,destino,evento,tiempoMilisegundos);
+}
+
+bool DespachoRetardado_reprogramar(DespachoRetardado *self, DespachoRetardado_HDespacho hDespacho, uint32_t const tiempoMilisegundos){
+    uint16_t const nodo = DespachoRetardado__nodoDe(self,hDespacho);
+    bool const valido = (nodo != NINGUNO);
+    if (valido){
+        self->despachosEnEspera[nodo].vencimiento = SP_Tiempo_getMilisegundos() + tiempoMilisegundos;
+        DespachoRetardado__reubica(self,self->despachosEnEspera[nodo].posicion);
+    }
+    return valido;
+}
+
+bool DespachoRetardado_cancelarDespacho(DespachoRetardado *self, DespachoRetardado_HDespacho hDespacho){
+    uint16_t const nodo = DespachoRetardado__nodoDe(self,hDespacho);
+    bool const valido = (nodo != NINGUNO);
+    if (valido) DespachoRetardado__libera(self,nodo);
+    return valido;
+}
+
+bool DespachoRetardado_cancelar(DespachoRetardado *self, Maquina *const destino, Evento const evento){
+    uint16_t const nodo = DespachoRetardado__busca(self,destino,evento);
+    bool const cancelado = (nodo != NINGUNO);
+    if (cancelado) DespachoRetardado__libera(self,nodo);
+    return cancelado;
+}
+
+void DespachoRetardado_procesarDespacho(DespachoRetardado *self){
+    uint32_t const t = SP_Tiempo_getMilisegundos();
+    DespachoEnEspera const *const d = self->despachosEnEspera;
+    while (self->numDespachosEnEspera && !anterior(t,d[self->monticulo[0]].vencimiento)){
+        uint16_t const nodo = self->monticulo[0];
+        Maquina *const destino = d[nodo].destino;
+        Evento const evento = d[nodo].evento;
+        DespachoRetardado__libera(self,nodo);
+        Maquina_despacha(destino,evento);
+    }
+}
+
+uint32_t DespachoRetardado_tiempoHastaProximoDespacho(DespachoRetardado const *self){
+    uint32_t tiempo = SP_TIEMPO_INDEFINIDO;
+    if (self->numDespachosEnEspera){
+        uint32_t const t = SP_Tiempo_getMilisegundos();
+        uint32_t const vencimiento = self->despachosEnEspera[self->monticulo[0]].vencimiento;
+        tiempo = anterior(t,vencimiento) ? vencimiento - t : 0;
+    }
+    return tiempo;
+}
+
+#endif
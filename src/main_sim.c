@@ -0,0 +1,148 @@
+#ifndef PIO_UNIT_TESTING
+#include "aplicacion.h"
+#include <soporte_placa_sim.h>
+#include <traza.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+/*
+ * Simulador del controlador de luz de escalera. Ejecuta el lazo
+ * principal sobre la placa simulada durante el tiempo indicado
+ * (en milisegundos simulados, una hora por defecto) pulsando el
+ * botón según un guión fijo, e informa la velocidad de simulación.
+ *
+ * Modos del lazo principal:
+ *   sondeo: consulta las máquinas continuamente (una o más pasadas
+ *           por milisegundo)
+ *   reposo: duerme con SP_Tiempo_duerme hasta el próximo evento
+ *           (por defecto si APLICACION_REPOSO es distinto de cero)
+ *
+ * Uso: program [milisegundos] [sondeo|reposo]
+ */
+
+#define DURACION_POR_DEFECTO 3600000UL
+
+#define PERIODO_PULSACION 120000UL      // Una pulsación cada dos minutos
+#define PERIODO_MUDANZA   960000UL      // Una triple pulsación cada dieciseis minutos
+#define DURACION_PULSACION 50UL
+#define SEPARACION_PULSACIONES 200UL
+
+/**
+ * @brief Nivel del pulsador según el guión de la simulación
+ * 
+ * @param t Tiempo simulado en milisegundos
+ * @return true Pulsador presionado
+ */
+static bool guionPulsador(uint32_t t){
+    uint32_t const numPulsaciones = (t % PERIODO_MUDANZA < PERIODO_PULSACION) ? 3 : 1;
+    uint32_t const fase = t % PERIODO_PULSACION;
+    return (fase < numPulsaciones * SEPARACION_PULSACIONES) 
+        && ((fase % SEPARACION_PULSACIONES) < DURACION_PULSACION);
+}
+
+typedef struct Medicion{
+    uint32_t encendidos;
+    uint32_t milisegundosEncendida;
+    bool luzAnterior;
+}Medicion;
+
+/**
+ * @brief Estímulo de la simulación: aplica el guión al pulsador y
+ * mide el tiempo con la luz encendida
+ * 
+ */
+static void estimulo(uint32_t t, void *param){
+    Medicion *const m = param;
+    SP_Sim_Pin_setEntrada(PIN_PULSADOR,guionPulsador(t) == PULSADOR_NIVEL_ACTIVO);
+    bool const luz = SP_Sim_Pin_getSalida(PIN_LUZ) == LUZ_ON;
+    if (luz && !m->luzAnterior) ++m->encendidos;
+    if (luz) ++m->milisegundosEncendida;
+    m->luzAnterior = luz;
+}
+
+static double segundosDeReloj(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC,&ts);
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+#if SP_PERFILADO
+/**
+ * @brief Imprime la tabla del perfil. Las funciones se identifican por
+ * dirección (nm o addr2line dan el nombre)
+ */
+static void imprimePerfil(void){
+    SP_Perfil const *const perfil = SP_Perfil_get();
+    printf("Perfil (ns)            : funcion llamadas minimo media maximo\n");
+    for (uint32_t i=0;i<perfil->numFunciones;++i){
+        SP_PerfilEstadistica const *const e = perfil->funciones + i;
+        printf("  %#18lx %8lu %6lu %6lu %6lu\n",(unsigned long)(uintptr_t)e->funcion,(unsigned long)e->llamadas,
+               (unsigned long)e->minimo,(unsigned long)SP_Perfil_getMedia(e),(unsigned long)e->maximo);
+    }
+    if (perfil->descartadas) printf("  mediciones descartadas: %lu\n",(unsigned long)perfil->descartadas);
+}
+#endif
+
+#if MAQUINA_TRAZA
+/**
+ * @brief Vuelca la traza de eventos para herramientas/decodifica_traza.c
+ */
+static void volcaTraza(char const *archivo){
+    FILE *const f = fopen(archivo,"wb");
+    if (f){
+        fwrite(Traza_get(),sizeof(Traza),1,f);
+        fclose(f);
+        printf("Traza                  : %s\n",archivo);
+    }
+}
+#endif
+
+int main(int argc, char *argv[]){
+    uint32_t const duracion = (argc > 1) ? strtoul(argv[1],NULL,0) : DURACION_POR_DEFECTO;
+    bool const reposo = (argc > 2) ? !strcmp(argv[2],"reposo") : APLICACION_REPOSO;
+    Medicion medicion = {0};
+    uint32_t pasadas = 0;
+
+    SP_Sim_reset();
+    Aplicacion_init();
+    SP_Sim_setEstimulo(estimulo,&medicion);
+
+    double const inicio = segundosDeReloj();
+    if (reposo){
+        while(SP_Tiempo_getMilisegundos() < duracion){
+            Aplicacion_procesa();
+            ++pasadas;
+            uint32_t const limite = duracion - SP_Tiempo_getMilisegundos();
+            uint32_t const tiempo = Aplicacion_tiempoHastaProximoEvento();
+            SP_Tiempo_duerme(tiempo < limite ? tiempo : limite);
+        }
+    }else{
+        while(SP_Tiempo_getMilisegundos() < duracion){
+            do ++pasadas; while(Aplicacion_procesa());
+            SP_Sim_Tiempo_avanza(1);
+        }
+    }
+    double const transcurrido = segundosDeReloj() - inicio;
+    SP_Tiempo_Reposo const r = SP_Tiempo_getReposo();
+
+    printf("Modo                   : %s\n",reposo ? "reposo" : "sondeo");
+    printf("Milisegundos simulados : %lu\n",(unsigned long)duracion);
+    printf("Encendidos de la luz   : %lu\n",(unsigned long)medicion.encendidos);
+    printf("Tiempo con luz (ms)    : %lu\n",(unsigned long)medicion.milisegundosEncendida);
+    printf("Pasadas del lazo       : %lu\n",(unsigned long)pasadas);
+    printf("Despertares            : %lu\n",(unsigned long)r.despertares);
+    printf("Fraccion en reposo     : %.4f\n",duracion ? (double)r.milisegundosEnReposo/duracion : 0.0);
+    printf("Tiempo de reloj (s)    : %.3f\n",transcurrido);
+    printf("Velocidad (ms sim./s)  : %.0f\n",transcurrido > 0 ? duracion/transcurrido : 0.0);
+#if SP_PERFILADO
+    imprimePerfil();
+#endif
+#if MAQUINA_TRAZA
+    volcaTraza("traza.bin");
+#endif
+    return 0;
+}
+#endif
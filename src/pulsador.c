@@ -9,24 +9,51 @@ void Pulsador_init(Pulsador *self,
 {
     self->destino = destino;
     self->evento  = evento;
+    self->parametros.pin = pin;
+    self->parametros.nivelActivo = nivelActivo;
+    self->parametros.histeresis = histeresis;
     self->estado.nivelAnterior = !nivelActivo;
     if (nivelActivo == false){
-        self->estado.contador = self->parametros.histeresis;
+        self->estado.contador = histeresis;
         SP_Pin_setModo(pin,SP_PIN_ENTRADA_PULLUP);
     }else{
         self->estado.contador = 0;
         SP_Pin_setModo(pin,SP_PIN_ENTRADA_PULLDN);
     }
-    self->parametros.pin = pin;
-    self->parametros.nivelActivo = nivelActivo;
-    self->parametros.histeresis = histeresis;
+    self->parametros.despertarPorFlanco = false;
+    self->estado.flanco = false;
     self->t0 = SP_Tiempo_getMilisegundos();
 }
 
+/**
+ * @brief El nivel filtrado es estable cuando el contador de
+ * histéresis está en el extremo correspondiente a ese nivel
+ * 
+ * @param self Este objeto
+ * @return true No hay antirrebote en curso
+ */
+static bool Pulsador__qEstable(Pulsador const *self){
+    uint8_t const extremo = self->estado.nivelAnterior ? self->parametros.histeresis : 0;
+    return self->estado.contador == extremo;
+}
+
+/**
+ * @brief Con interrupción por flanco, el pulsador solo necesita
+ * lecturas luego de un flanco y hasta que el nivel vuelve a ser
+ * estable
+ * 
+ * @param self Este objeto
+ * @return true No hace falta leer el pin
+ */
+static bool Pulsador__qEnReposo(Pulsador const *self){
+    return self->parametros.despertarPorFlanco && !self->estado.flanco && Pulsador__qEstable(self);
+}
+
 void Pulsador_procesa(Pulsador *self){
     uint32_t const t = SP_Tiempo_getMilisegundos();
-    if (self->t0 != t){
+    if (self->t0 != t && !Pulsador__qEnReposo(self)){
         self->t0 = t;
+        self->estado.flanco = false;
         bool const nivelPin = SP_Pin_read(self->parametros.pin);
         bool nivelFlitrado = self->estado.nivelAnterior;
         if (nivelPin && (self->estado.contador < self->parametros.histeresis)){
@@ -49,4 +76,23 @@ void Pulsador_procesa(Pulsador *self){
             }
         }
     }   
+}
+
+static void Pulsador__marcaFlanco(void volatile *param){
+    Pulsador volatile *const self = param;
+    self->estado.flanco = true;
+}
+
+bool Pulsador_habilitaDespertar(Pulsador *self){
+    bool const configurado = SP_Pin_setInterrupcion(self->parametros.pin,SP_PIN_INT_AMBOS_FLANCOS,Pulsador__marcaFlanco,self);
+    self->parametros.despertarPorFlanco = configurado;
+    return configurado;
+}
+
+uint32_t Pulsador_tiempoHastaProximaLectura(Pulsador const *self){
+    uint32_t tiempo = SP_TIEMPO_INDEFINIDO;
+    if (!Pulsador__qEnReposo(self)){
+        tiempo = (SP_Tiempo_getMilisegundos() != self->t0) ? 0 : 1;
+    }
+    return tiempo;
 }
\ No newline at end of file
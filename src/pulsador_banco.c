@@ -0,0 +1,76 @@
+#include "pulsador_banco.h"
+
+void PulsadorBanco_init(PulsadorBanco *self, SP_HPuerto puerto, uint8_t histeresis){
+    *self = (PulsadorBanco){0};
+    self->parametros.puerto = puerto;
+    if (histeresis < 1) histeresis = 1;
+    if (histeresis > PULSADOR_BANCO_MAX_HISTERESIS) histeresis = PULSADOR_BANCO_MAX_HISTERESIS;
+    self->parametros.histeresis = histeresis;
+    self->t0 = SP_Tiempo_getMilisegundos();
+}
+
+bool PulsadorBanco_agregaPulsador(PulsadorBanco *self,
+                                  SP_HPin pin,
+                                  bool nivelActivo,
+                                  Maquina *destino,
+                                  Evento evento)
+{
+    bool const agregado = (SP_Pin_getPuerto(pin) == self->parametros.puerto);
+    if (agregado){
+        unsigned const linea = SP_Pin_getLinea(pin);
+        uint16_t const bit = 1u << linea;
+        SP_Pin_setModo(pin,nivelActivo ? SP_PIN_ENTRADA_PULLDN : SP_PIN_ENTRADA_PULLUP);
+        self->salidas[linea].destino = destino;
+        self->salidas[linea].evento = evento;
+        self->parametros.nivelesActivos = nivelActivo ? (self->parametros.nivelesActivos | bit)
+                                                      : (self->parametros.nivelesActivos & ~bit);
+        self->estado.filtrado = nivelActivo ? (self->estado.filtrado & ~bit)   //Comienza sin pulsar
+                                            : (self->estado.filtrado | bit);
+        for (size_t i=0;i<PULSADOR_BANCO_BITS_CONTADOR;++i){
+            self->estado.contador[i] &= ~bit;
+        }
+        self->parametros.lineas |= bit;
+    }
+    return agregado;
+}
+
+/**
+ * @brief Actualiza los contadores verticales con una lectura del
+ * puerto. El contador de cada línea cuenta las lecturas consecutivas
+ * distintas al nivel filtrado y vuelve a cero con una lectura igual
+ *
+ * @param self Este objeto
+ * @param lectura Nivel leído en cada línea
+ * @return uint16_t Líneas cuyo nivel filtrado cambia
+ */
+static uint16_t PulsadorBanco__filtra(PulsadorBanco *self, uint16_t lectura){
+    uint16_t const distintas = (lectura ^ self->estado.filtrado) & self->parametros.lineas;
+    unsigned const limite = self->parametros.histeresis - 1u;
+    uint16_t enLimite = distintas;              //Líneas cuyo contador vale histeresis-1
+    uint16_t acarreo = distintas;               //Incremento en paralelo: suma 1 en las líneas distintas
+    for (size_t i=0;i<PULSADOR_BANCO_BITS_CONTADOR;++i){
+        uint16_t const plano = self->estado.contador[i];
+        enLimite &= (limite & (1u << i)) ? plano : (uint16_t)~plano;
+        self->estado.contador[i] = (plano ^ acarreo) & distintas;  //Líneas iguales vuelven a cero
+        acarreo &= plano;
+    }
+    for (size_t i=0;i<PULSADOR_BANCO_BITS_CONTADOR;++i){
+        self->estado.contador[i] &= ~enLimite;  //Las líneas que cambian vuelven a cero
+    }
+    return enLimite;
+}
+
+void PulsadorBanco_procesa(PulsadorBanco *self){
+    uint32_t const t = SP_Tiempo_getMilisegundos();
+    if (self->t0 != t){
+        self->t0 = t;
+        uint16_t const cambios = PulsadorBanco__filtra(self,SP_Puerto_read(self->parametros.puerto));
+        self->estado.filtrado ^= cambios;
+        unsigned pulsados = cambios & ~(self->estado.filtrado ^ self->parametros.nivelesActivos);
+        while (pulsados){                       //Una iteración por pulsación detectada
+            unsigned const linea = __builtin_ctz(pulsados);
+            Maquina_despacha(self->salidas[linea].destino,self->salidas[linea].evento);
+            pulsados &= pulsados - 1;
+        }
+    }
+}
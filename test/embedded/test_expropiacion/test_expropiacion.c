@@ -0,0 +1,134 @@
+#include <soporte_placa.h>
+#include <planificador.h>
+#include <maquina_estado_impl.h>
+#include <unity.h>
+#include <stm32f1xx.h>
+#include <stdio.h>
+
+//Latencia de despacho desde una interrupción con el planificador cooperativo y expropiativo
+
+enum {EV_PRUEBA = EV_USUARIO, MUESTRAS = 20, DURACION_ACCION_MS = 3};
+
+static Planificador planificador;
+static Maquina menosPrioritaria;
+static Maquina masPrioritaria;
+static LugarCola colaMenosPrioritaria[4];
+static LugarCola colaMasPrioritaria[4];
+
+static uint32_t volatile inicioLatencia;
+static uint32_t volatile latenciaMaxima;
+
+void setUp(){
+
+}
+void tearDown(){
+
+}
+
+static void CycleCounter_resetValue(void){
+    DWT->CYCCNT = 0;
+}
+static uint32_t CycleCounter_getValue(void){
+    return DWT->CYCCNT;
+}
+
+static void CycleCounter_init(void){
+    __disable_irq();
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    __enable_irq();
+    CycleCounter_resetValue();
+}
+static void CycleCounter_deinit(void){
+    __disable_irq();
+    DWT->CTRL &= ~DWT_CTRL_CYCCNTENA_Msk;
+    __enable_irq();
+    CycleCounter_resetValue();
+}
+
+/**
+ * @brief Acción larga: espera DURACION_ACCION_MS, tiempo en que vence
+ * el timeout que despacha a la máquina más prioritaria
+ */
+static Resultado estadoAccionLarga(Maquina *contexto, Evento evento){
+    (void)contexto;
+    if (evento != EV_RESET){
+        uint32_t const inicio = CycleCounter_getValue();
+        uint32_t const duracion = SystemCoreClock/1000UL*DURACION_ACCION_MS;
+        while (CycleCounter_getValue() - inicio < duracion);
+    }
+    return Resultado_procesado();
+}
+
+static Resultado estadoMideLatencia(Maquina *contexto, Evento evento){
+    (void)contexto;
+    if (evento != EV_RESET){
+        uint32_t const latencia = CycleCounter_getValue() - inicioLatencia;
+        if (latencia > latenciaMaxima) latenciaMaxima = latencia;
+    }
+    return Resultado_procesado();
+}
+
+static void despachaDesdeTimeout(void volatile *param){
+    (void)param;
+    inicioLatencia = CycleCounter_getValue();
+    Maquina_despacha(&masPrioritaria,EV_PRUEBA);
+}
+
+static void rutinaExpropiacion(void){
+    Planificador_expropia(&planificador);
+}
+
+/**
+ * @brief Peor latencia, en ciclos, entre el despacho desde SysTick a
+ * la máquina más prioritaria y el comienzo de su procesamiento
+ * mientras la menos prioritaria ejecuta una acción larga
+ */
+static uint32_t peorLatencia(bool expropiativo){
+    if (expropiativo){
+        SP_Expropiacion_init(rutinaExpropiacion);
+        Planificador_initExpropiativo(&planificador,SP_Expropiacion_solicita);
+    }else{
+        Planificador_init(&planificador);
+    }
+    Maquina_initConCola(&menosPrioritaria,estadoAccionLarga,colaMenosPrioritaria,4);
+    Maquina_initConCola(&masPrioritaria,estadoMideLatencia,colaMasPrioritaria,4);
+    Planificador_registra(&planificador,&menosPrioritaria,1);
+    Planificador_registra(&planificador,&masPrioritaria,2);
+    while (Planificador_procesa(&planificador));
+    latenciaMaxima = 0;
+    for (size_t i=0;i<MUESTRAS;++i){
+        SP_Tiempo_addTimeout(1,despachaDesdeTimeout,NULL);
+        Maquina_despacha(&menosPrioritaria,EV_PRUEBA);
+        while (Planificador_procesa(&planificador));
+    }
+    return latenciaMaxima;
+}
+
+static void test_latencia_cooperativo_espera_la_accion(void){
+    uint32_t const latencia = peorLatencia(false);
+    TEST_ASSERT_GREATER_THAN_UINT32(SystemCoreClock/1000UL,latencia);
+    char mensaje[80];
+    snprintf(mensaje,sizeof(mensaje),"cooperativo: peor latencia %lu ciclos",(unsigned long)latencia);
+    TEST_MESSAGE(mensaje);
+}
+
+static void test_latencia_expropiativo_no_espera_la_accion(void){
+    uint32_t const latencia = peorLatencia(true);
+    TEST_ASSERT_LESS_THAN_UINT32(SystemCoreClock/10000UL,latencia);
+    char mensaje[80];
+    snprintf(mensaje,sizeof(mensaje),"expropiativo: peor latencia %lu ciclos",(unsigned long)latencia);
+    TEST_MESSAGE(mensaje);
+}
+
+int main(void){
+    SP_init();
+    SP_Tiempo_delay(500);
+    UNITY_BEGIN();
+    CycleCounter_init();
+    RUN_TEST(test_latencia_cooperativo_espera_la_accion);
+    RUN_TEST(test_latencia_expropiativo_no_espera_la_accion);
+    CycleCounter_deinit();
+    UNITY_END();
+    return 0;
+}
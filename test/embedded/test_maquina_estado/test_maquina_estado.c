@@ -0,0 +1,135 @@
+#include <soporte_placa.h>
+#include <maquina_estado_impl.h>
+#include <unity.h>
+#include <stm32f1xx.h>
+#include <stdio.h>
+
+//Ciclos por Maquina_procesa y Maquina_procesaLote y RAM de una máquina con cola propia
+
+enum {EV_PRUEBA = EV_USUARIO, EV_CAMBIA, CAPACIDAD = 16, REPETICIONES = 1000};
+
+static Maquina maquina;
+static LugarCola cola[CAPACIDAD];
+
+void setUp(){
+
+}
+void tearDown(){
+
+}
+
+static void CycleCounter_resetValue(void){
+    DWT->CYCCNT = 0;
+}
+static uint32_t CycleCounter_getValue(void){
+    return DWT->CYCCNT;
+}
+
+static void CycleCounter_init(void){
+    __disable_irq();
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    __enable_irq();
+    CycleCounter_resetValue();
+}
+static void CycleCounter_deinit(void){
+    __disable_irq();
+    DWT->CTRL &= ~DWT_CTRL_CYCCNTENA_Msk;
+    __enable_irq();
+    CycleCounter_resetValue();
+}
+
+static Resultado estadoB(Maquina *contexto, Evento evento);
+
+static Resultado estadoA(Maquina *contexto, Evento evento){
+    (void)contexto;
+    return (evento == EV_CAMBIA) ? Resultado_transicion(estadoB) : Resultado_procesado();
+}
+
+static Resultado estadoB(Maquina *contexto, Evento evento){
+    (void)contexto;
+    return (evento == EV_CAMBIA) ? Resultado_transicion(estadoA) : Resultado_procesado();
+}
+
+/**
+ * @brief Menor cantidad de ciclos de un Maquina_procesa con el evento
+ * dado en cola (el despacho queda fuera de la medición)
+ */
+static uint32_t ciclosProcesa(Evento evento){
+    uint32_t minimo = UINT32_MAX;
+    for (uint32_t i=0;i<REPETICIONES;++i){
+        Maquina_despacha(&maquina,evento);
+        uint32_t const inicio = CycleCounter_getValue();
+        Maquina_procesa(&maquina);
+        uint32_t const ciclos = CycleCounter_getValue() - inicio;
+        if (ciclos < minimo) minimo = ciclos;
+    }
+    return minimo;
+}
+
+static void test_ciclos_por_procesa(void){
+    TEST_ASSERT_TRUE(Maquina_initConCola(&maquina,estadoA,cola,CAPACIDAD));
+    Maquina_procesa(&maquina);
+    uint32_t const sinTransicion = ciclosProcesa(EV_PRUEBA);
+    uint32_t const conTransicion = ciclosProcesa(EV_CAMBIA);
+    char mensaje[120];
+    snprintf(mensaje,sizeof(mensaje),"Maquina_procesa: %lu ciclos sin transicion, %lu con transicion",
+             (unsigned long)sinTransicion,(unsigned long)conTransicion);
+    TEST_MESSAGE(mensaje);
+}
+
+/**
+ * @brief Menor cantidad de ciclos por evento al vaciar una ráfaga de n
+ * eventos con Maquina_procesa en un lazo o con Maquina_procesaLote
+ */
+static uint32_t ciclosPorEventoEnRafaga(uint32_t n, bool lote){
+    uint32_t minimo = UINT32_MAX;
+    for (uint32_t i=0;i<REPETICIONES;++i){
+        for (uint32_t e=0;e<n;++e) Maquina_despacha(&maquina,EV_PRUEBA);
+        uint32_t const inicio = CycleCounter_getValue();
+        if (lote){
+            Maquina_procesaLote(&maquina,n);
+        }else{
+            while (Maquina_procesa(&maquina));
+        }
+        uint32_t const ciclos = CycleCounter_getValue() - inicio;
+        if (ciclos < minimo) minimo = ciclos;
+    }
+    return minimo / n;
+}
+
+static void test_ciclos_por_evento_en_rafaga(void){
+    static uint32_t const cantidades[] = {1,2,4,8,16};
+    TEST_ASSERT_TRUE(Maquina_initConCola(&maquina,estadoA,cola,CAPACIDAD));
+    Maquina_procesa(&maquina);
+    for (size_t c=0;c<sizeof(cantidades)/sizeof(*cantidades);++c){
+        uint32_t const n = cantidades[c];
+        uint32_t const uno = ciclosPorEventoEnRafaga(n,false);
+        uint32_t const lote = ciclosPorEventoEnRafaga(n,true);
+        char mensaje[120];
+        snprintf(mensaje,sizeof(mensaje),"rafaga de %2lu eventos: %lu ciclos por evento con Maquina_procesa, %lu con Maquina_procesaLote",
+                 (unsigned long)n,(unsigned long)uno,(unsigned long)lote);
+        TEST_MESSAGE(mensaje);
+    }
+}
+
+static void test_ram_por_maquina(void){
+    TEST_ASSERT_EQUAL(4,sizeof(Resultado));
+    char mensaje[120];
+    snprintf(mensaje,sizeof(mensaje),"Maquina: %u bytes + cola de %u lugares de %u bytes (MAX_EV_COLA=%u)",
+             (unsigned)sizeof(Maquina),(unsigned)CAPACIDAD,(unsigned)sizeof(LugarCola),(unsigned)MAX_EV_COLA);
+    TEST_MESSAGE(mensaje);
+}
+
+int main(void){
+    SP_init();
+    SP_Tiempo_delay(500);
+    UNITY_BEGIN();
+    CycleCounter_init();
+    RUN_TEST(test_ciclos_por_procesa);
+    RUN_TEST(test_ciclos_por_evento_en_rafaga);
+    RUN_TEST(test_ram_por_maquina);
+    CycleCounter_deinit();
+    UNITY_END();
+    return 0;
+}
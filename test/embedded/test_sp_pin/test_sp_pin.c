@@ -1,6 +1,7 @@
 #include <unity.h>
 #include <soporte_placa.h>
 #include <stm32f1xx.h>
+#include <stdio.h>
 
 //Aqui se testearán las funciones definidas en el archivo sp_pin.c
 
@@ -268,6 +269,104 @@ static void TEST_JTAG_PINES (void) {
     }
 }
 
+static void TEST_ESCRIBIR_MASCARA (void) {
+//Preparo el entorno
+    static SP_HPin const pinesGrupo[] = {SP_PB12,SP_PB13,SP_PB14,SP_PB15};
+    for (size_t i=0;i<4;++i) SP_Pin_setModo(pinesGrupo[i],SP_PIN_SALIDA);
+    SP_Puerto_writeMascara(SP_PUERTO_B,0xF000,0x5000);                          //PB12 y PB14 en 1, PB13 y PB15 en 0
+    uint32_t const ODR_ANTES = GPIOB->ODR;
+//Ejecuto la funcion a probar
+    SP_Puerto_writeMascara(SP_PUERTO_B,0x6000,0x2000);                          //Solo PB13 (a 1) y PB14 (a 0)
+//Comparo datos
+    uint32_t const ODR_DESPUES = GPIOB->ODR;
+    TEST_ASSERT_EQUAL_HEX16(0x5000,ODR_ANTES & 0xF000);
+    TEST_ASSERT_EQUAL_HEX16(0x3000,ODR_DESPUES & 0xF000);
+    TEST_ASSERT_BITS_LOW(~0x6000UL,ODR_ANTES ^ ODR_DESPUES);                    //Ninguna otra línea cambió
+}
+
+static void TEST_COSTO_GRUPO_VS_PIN_A_PIN (void) {
+//Preparo el entorno
+    enum {REPETICIONES = 100};
+    static SP_HPin const pinesGrupo[] = {SP_PB8,SP_PB9,SP_PB10,SP_PB11,SP_PB12,SP_PB13,SP_PB14,SP_PB15};
+    enum {NUM_PINES = sizeof(pinesGrupo)/sizeof(*pinesGrupo)};
+    SP_GrupoPines grupo;
+    TEST_ASSERT_TRUE(SP_Pines_init(&grupo,pinesGrupo,NUM_PINES));
+    for (size_t i=0;i<NUM_PINES;++i) SP_Pin_setModo(pinesGrupo[i],SP_PIN_SALIDA);
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+//Mido los ciclos de escribir los 8 pines de cada forma
+    uint32_t t0 = DWT->CYCCNT;
+    for (uint32_t r=0;r<REPETICIONES;++r){
+        for (size_t i=0;i<NUM_PINES;++i) SP_Pin_write(pinesGrupo[i],(r >> i) & 1);
+    }
+    uint32_t const pinAPin = (DWT->CYCCNT - t0)/REPETICIONES;
+    t0 = DWT->CYCCNT;
+    for (uint32_t r=0;r<REPETICIONES;++r) SP_Pines_write(&grupo,r);
+    uint32_t const conGrupo = (DWT->CYCCNT - t0)/REPETICIONES;
+    t0 = DWT->CYCCNT;
+    for (uint32_t r=0;r<REPETICIONES;++r) SP_Puerto_writeMascara(SP_PUERTO_B,0xFF00,(uint16_t)(r << 8));
+    uint32_t const conMascara = (DWT->CYCCNT - t0)/REPETICIONES;
+//Comparo datos
+    char mensaje[96];
+    snprintf(mensaje,sizeof(mensaje),"8 pines: %lu ciclos pin a pin, %lu con SP_Pines_write, %lu con SP_Puerto_writeMascara",
+             (unsigned long)pinAPin,(unsigned long)conGrupo,(unsigned long)conMascara);
+    TEST_MESSAGE(mensaje);
+    TEST_ASSERT_LESS_THAN_UINT32(pinAPin,conMascara);
+    TEST_ASSERT_EQUAL_HEX16((uint16_t)((REPETICIONES - 1) << 8),GPIOB->ODR & 0xFF00);
+}
+
+static void TEST_COSTO_HANDLE_CONSTANTE (void) {
+//Preparo el entorno
+    enum {REPETICIONES = 100};
+    SP_Pin_setModo(SP_PB12,SP_PIN_SALIDA);
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    uint32_t volatile lecturas = 0;
+//Mido los ciclos con la tabla de pines (función) y con el handle constante (en línea)
+    uint32_t t0 = DWT->CYCCNT;
+    for (uint32_t r=0;r<REPETICIONES;++r) (SP_Pin_write)(SP_PB12,r & 1);
+    uint32_t const escrituraTabla = (DWT->CYCCNT - t0)/REPETICIONES;
+    t0 = DWT->CYCCNT;
+    for (uint32_t r=0;r<REPETICIONES;++r) SP_Pin_write(SP_PB12,r & 1);
+    uint32_t const escrituraConstante = (DWT->CYCCNT - t0)/REPETICIONES;
+    t0 = DWT->CYCCNT;
+    for (uint32_t r=0;r<REPETICIONES;++r) lecturas += (SP_Pin_read)(SP_PB12);
+    uint32_t const lecturaTabla = (DWT->CYCCNT - t0)/REPETICIONES;
+    t0 = DWT->CYCCNT;
+    for (uint32_t r=0;r<REPETICIONES;++r) lecturas += SP_Pin_read(SP_PB12);
+    uint32_t const lecturaConstante = (DWT->CYCCNT - t0)/REPETICIONES;
+//Comparo datos
+    char mensaje[112];
+    snprintf(mensaje,sizeof(mensaje),"ciclos por iteración: escritura %lu con tabla, %lu constante; lectura %lu con tabla, %lu constante",
+             (unsigned long)escrituraTabla,(unsigned long)escrituraConstante,
+             (unsigned long)lecturaTabla,(unsigned long)lecturaConstante);
+    TEST_MESSAGE(mensaje);
+    TEST_ASSERT_LESS_THAN_UINT32(escrituraTabla,escrituraConstante);
+    TEST_ASSERT_LESS_THAN_UINT32(lecturaTabla,lecturaConstante);
+    SP_Pin_write(SP_PB12,1);
+    TEST_ASSERT_BIT_HIGH(12,GPIOB->ODR);
+    TEST_ASSERT_TRUE(SP_Pin_read(SP_PB12));
+    SP_Pin_write(SP_PB12,0);
+    TEST_ASSERT_BIT_LOW(12,GPIOB->ODR);
+    TEST_ASSERT_FALSE(SP_Pin_read(SP_PB12));
+}
+
+#if SP_PIN_BITBAND
+static void TEST_MODO_SIN_SECCION_CRITICA (void) {
+//Preparo el entorno
+    SP_Pin_setModo(SP_PB13,SP_PIN_SALIDA);
+    uint32_t const CRH_ANTES = GPIOB->CRH;
+//Ejecuto la funcion a probar con las interrupciones deshabilitadas
+    __disable_irq();
+    SP_Pin_setModo(SP_PB12,SP_PIN_SALIDA_OPEN_DRAIN);
+    uint32_t const primask = __get_PRIMASK();                                   //Sigue en 1: setModo no rehabilitó las interrupciones
+    __enable_irq();
+//Comparo datos
+    TEST_ASSERT_EQUAL(1,primask);
+    TEST_ASSERT_EQUAL_HEX32(0b0110 << 16,GPIOB->CRH & (0xF << 16));
+    TEST_ASSERT_EQUAL_HEX32(CRH_ANTES & ~(0xFUL << 16),GPIOB->CRH & ~(0xFUL << 16)); //Los demás pines no cambiaron
+}
+#endif
 
 int main (void) {
     SP_init();
@@ -283,6 +382,12 @@ int main (void) {
     RUN_TEST(TEST_LEER_1);
     RUN_TEST(TEST_LEER_0);
     RUN_TEST(TEST_JTAG_PINES);
+    RUN_TEST(TEST_ESCRIBIR_MASCARA);
+    RUN_TEST(TEST_COSTO_GRUPO_VS_PIN_A_PIN);
+    RUN_TEST(TEST_COSTO_HANDLE_CONSTANTE);
+#if SP_PIN_BITBAND
+    RUN_TEST(TEST_MODO_SIN_SECCION_CRITICA);
+#endif
     UNITY_END();
     return 0;
 }
\ No newline at end of file
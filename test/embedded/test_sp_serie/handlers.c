@@ -0,0 +1,365 @@
+#define DEFAULT_ACTION() while(1)
+
+#define SysTick_Handler_IS_DEFINED_
+#define PendSV_Handler_IS_DEFINED_
+#define SVC_Handler_IS_DEFINED_
+#define DMA1_Channel4_IRQHandler_IS_DEFINED_
+
+void RTC_Alarm_IRQHandler(void);
+void EXTI2_IRQHandler(void);
+void DebugMon_Handler(void);
+void TIM1_CC_IRQHandler(void);
+void HardFault_Handler(void);
+void PVD_IRQHandler(void);
+void SysTick_Handler(void);
+void PendSV_Handler(void);
+void NMI_Handler(void);
+void EXTI3_IRQHandler(void);
+void EXTI0_IRQHandler(void);
+void I2C2_EV_IRQHandler(void);
+void UsageFault_Handler(void);
+void ADC1_2_IRQHandler(void);
+void SPI1_IRQHandler(void);
+void TAMPER_IRQHandler(void);
+void DMA1_Channel4_IRQHandler(void);
+void USART3_IRQHandler(void);
+void RTC_IRQHandler(void);
+void DMA1_Channel7_IRQHandler(void);
+void CAN1_RX1_IRQHandler(void);
+void TIM4_IRQHandler(void);
+void I2C1_EV_IRQHandler(void);
+void DMA1_Channel6_IRQHandler(void);
+void TIM3_IRQHandler(void);
+void RCC_IRQHandler(void);
+void TIM1_TRG_COM_IRQHandler(void);
+void DMA1_Channel1_IRQHandler(void);
+void EXTI15_10_IRQHandler(void);
+void EXTI9_5_IRQHandler(void);
+void SPI2_IRQHandler(void);
+void MemManage_Handler(void);
+void SVC_Handler(void);
+void DMA1_Channel5_IRQHandler(void);
+void EXTI4_IRQHandler(void);
+void USB_LP_CAN1_RX0_IRQHandler(void);
+void USB_HP_CAN1_TX_IRQHandler(void);
+void DMA1_Channel3_IRQHandler(void);
+void TIM1_UP_IRQHandler(void);
+void WWDG_IRQHandler(void);
+void TIM2_IRQHandler(void);
+void TIM1_BRK_IRQHandler(void);
+void EXTI1_IRQHandler(void);
+void USART2_IRQHandler(void);
+void I2C2_ER_IRQHandler(void);
+void DMA1_Channel2_IRQHandler(void);
+void CAN1_SCE_IRQHandler(void);
+void FLASH_IRQHandler(void);
+void BusFault_Handler(void);
+void USART1_IRQHandler(void);
+void I2C1_ER_IRQHandler(void);
+void USBWakeUp_IRQHandler(void);
+
+#ifndef RTC_Alarm_IRQHandler_IS_DEFINED_
+void RTC_Alarm_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef EXTI2_IRQHandler_IS_DEFINED_
+void EXTI2_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef DebugMon_Handler_IS_DEFINED_
+void DebugMon_Handler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef TIM1_CC_IRQHandler_IS_DEFINED_
+void TIM1_CC_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef HardFault_Handler_IS_DEFINED_
+void HardFault_Handler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef PVD_IRQHandler_IS_DEFINED_
+void PVD_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef PendSV_Handler_IS_DEFINED_
+void PendSV_Handler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef NMI_Handler_IS_DEFINED_
+void NMI_Handler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef EXTI3_IRQHandler_IS_DEFINED_
+void EXTI3_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef EXTI0_IRQHandler_IS_DEFINED_
+void EXTI0_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef I2C2_EV_IRQHandler_IS_DEFINED_
+void I2C2_EV_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef UsageFault_Handler_IS_DEFINED_
+void UsageFault_Handler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef ADC1_2_IRQHandler_IS_DEFINED_
+void ADC1_2_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef SPI1_IRQHandler_IS_DEFINED_
+void SPI1_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef TAMPER_IRQHandler_IS_DEFINED_
+void TAMPER_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef DMA1_Channel4_IRQHandler_IS_DEFINED_
+void DMA1_Channel4_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef USART3_IRQHandler_IS_DEFINED_
+void USART3_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef RTC_IRQHandler_IS_DEFINED_
+void RTC_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef DMA1_Channel7_IRQHandler_IS_DEFINED_
+void DMA1_Channel7_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef CAN1_RX1_IRQHandler_IS_DEFINED_
+void CAN1_RX1_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef TIM4_IRQHandler_IS_DEFINED_
+void TIM4_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef I2C1_EV_IRQHandler_IS_DEFINED_
+void I2C1_EV_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef DMA1_Channel6_IRQHandler_IS_DEFINED_
+void DMA1_Channel6_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef TIM3_IRQHandler_IS_DEFINED_
+void TIM3_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef RCC_IRQHandler_IS_DEFINED_
+void RCC_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef TIM1_TRG_COM_IRQHandler_IS_DEFINED_
+void TIM1_TRG_COM_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef DMA1_Channel1_IRQHandler_IS_DEFINED_
+void DMA1_Channel1_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef EXTI15_10_IRQHandler_IS_DEFINED_
+void EXTI15_10_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef EXTI9_5_IRQHandler_IS_DEFINED_
+void EXTI9_5_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef SPI2_IRQHandler_IS_DEFINED_
+void SPI2_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef MemManage_Handler_IS_DEFINED_
+void MemManage_Handler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef SVC_Handler_IS_DEFINED_
+void SVC_Handler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef DMA1_Channel5_IRQHandler_IS_DEFINED_
+void DMA1_Channel5_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef EXTI4_IRQHandler_IS_DEFINED_
+void EXTI4_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef USB_LP_CAN1_RX0_IRQHandler_IS_DEFINED_
+void USB_LP_CAN1_RX0_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef USB_HP_CAN1_TX_IRQHandler_IS_DEFINED_
+void USB_HP_CAN1_TX_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef DMA1_Channel3_IRQHandler_IS_DEFINED_
+void DMA1_Channel3_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef TIM1_UP_IRQHandler_IS_DEFINED_
+void TIM1_UP_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef WWDG_IRQHandler_IS_DEFINED_
+void WWDG_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef TIM2_IRQHandler_IS_DEFINED_
+void TIM2_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef TIM1_BRK_IRQHandler_IS_DEFINED_
+void TIM1_BRK_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef EXTI1_IRQHandler_IS_DEFINED_
+void EXTI1_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef USART2_IRQHandler_IS_DEFINED_
+void USART2_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef I2C2_ER_IRQHandler_IS_DEFINED_
+void I2C2_ER_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef DMA1_Channel2_IRQHandler_IS_DEFINED_
+void DMA1_Channel2_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef CAN1_SCE_IRQHandler_IS_DEFINED_
+void CAN1_SCE_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef FLASH_IRQHandler_IS_DEFINED_
+void FLASH_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef BusFault_Handler_IS_DEFINED_
+void BusFault_Handler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef USART1_IRQHandler_IS_DEFINED_
+void USART1_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef I2C1_ER_IRQHandler_IS_DEFINED_
+void I2C1_ER_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
+
+#ifndef USBWakeUp_IRQHandler_IS_DEFINED_
+void USBWakeUp_IRQHandler(void){
+    DEFAULT_ACTION();
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include <soporte_placa.h>
+#include <unity.h>
+#include <unity_config.h>
+#include <stm32f1xx.h>
+#include <stdio.h>
+
+//Caudal y uso de CPU de la transmisión serie por DMA
+
+enum {VENTANA_MS = 200, TAM_BLOQUE = 64};
+
+void setUp(){
+
+}
+void tearDown(){
+
+}
+
+typedef struct Medicion{
+    uint32_t bytesPorSegundo;
+    uint32_t cpuPorMil;             // Uso de CPU en milésimas
+}Medicion;
+
+/**
+ * @brief Cuenta vueltas de un lazo que escribe bloques mientras haya
+ * lugar (o nunca, si umbral supera el tamaño del buffer) durante
+ * VENTANA_MS
+ */
+static uint32_t vueltas(size_t const umbral){
+    static uint8_t const bloque[TAM_BLOQUE] = {0};
+    uint32_t n = 0;
+    uint32_t const inicio = SP_Tiempo_getMilisegundos();
+    while (SP_Tiempo_getMilisegundos() - inicio < VENTANA_MS){
+        if (SP_Serie_getLibre() >= umbral) SP_Serie_escribe(bloque,TAM_BLOQUE);
+        ++n;
+    }
+    return n;
+}
+
+/**
+ * @brief Transmite continuamente con PA9 como entrada, para que los
+ * datos no lleguen a la PC, y compara las vueltas de un lazo ocioso
+ * con y sin transmisión
+ */
+static Medicion mide(uint32_t const baudios){
+    unityOutputFlush();
+    SP_Serie_init(baudios);
+    GPIOA->CRH = (GPIOA->CRH & ~(0xFUL << GPIO_CRH_MODE9_Pos)) | (0b0100UL << GPIO_CRH_MODE9_Pos); // PA9: entrada flotante
+    uint32_t const base = vueltas(SP_SERIE_TAM_BUFFER + 1);
+    uint32_t const transmitidos = SP_Serie_getTransmitidos();
+    uint32_t const conSerie = vueltas(TAM_BLOQUE);
+    Medicion const m = {
+        .bytesPorSegundo = (SP_Serie_getTransmitidos() - transmitidos)*1000UL/VENTANA_MS,
+        .cpuPorMil = conSerie < base ? (base - conSerie)*1000UL/base : 0
+    };
+    while (SP_Serie_qOcupado());
+    unityOutputStart(115200);
+    return m;
+}
+
+static void informa(uint32_t baudios, Medicion m){
+    char mensaje[80];
+    snprintf(mensaje,sizeof(mensaje),"%lu baudios: %lu bytes/s, CPU %lu.%lu %%",(unsigned long)baudios,
+             (unsigned long)m.bytesPorSegundo,(unsigned long)m.cpuPorMil/10,(unsigned long)m.cpuPorMil%10);
+    TEST_MESSAGE(mensaje);
+}
+
+static void test_caudal_115200(void){
+    Medicion const m = mide(115200);
+    informa(115200,m);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(11520*95/100,m.bytesPorSegundo);
+    TEST_ASSERT_LESS_THAN_UINT32(50,m.cpuPorMil);
+}
+
+static void test_caudal_921600(void){
+    Medicion const m = mide(921600);
+    informa(921600,m);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(92160*95/100,m.bytesPorSegundo);
+    TEST_ASSERT_LESS_THAN_UINT32(150,m.cpuPorMil);
+}
+
+int main(void){
+    SP_init();
+    SP_Tiempo_delay(500);
+    UNITY_BEGIN();
+    RUN_TEST(test_caudal_115200);
+    RUN_TEST(test_caudal_921600);
+    UNITY_END();
+    return 0;
+}
@@ -1,6 +1,9 @@
 #define DEFAULT_ACTION() while(1)
 
 #define SysTick_Handler_IS_DEFINED_
+#define PendSV_Handler_IS_DEFINED_
+#define SVC_Handler_IS_DEFINED_
+#define DMA1_Channel4_IRQHandler_IS_DEFINED_
 
 void RTC_Alarm_IRQHandler(void);
 void EXTI2_IRQHandler(void);
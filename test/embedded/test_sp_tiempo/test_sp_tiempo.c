@@ -1,6 +1,7 @@
 #include <soporte_placa.h>
 #include <unity.h>
 #include <stm32f1xx.h>
+#include <stdio.h>
 
 #define CICLOS_DIF 200UL
 
@@ -165,6 +166,65 @@ static void test_varios_timeouts_iguales(void){
 
 }
 
+static void test_SP_Tiempo_getMicrosegundos64(void){
+    uint64_t anterior = SP_Tiempo_getMicrosegundos64();
+    uint32_t const t0 = SP_Tiempo_getMilisegundos();
+    while (SP_Tiempo_getMilisegundos() - t0 < 5){                  //Monótono a lo largo de varios ticks
+        uint64_t const us = SP_Tiempo_getMicrosegundos64();
+        TEST_ASSERT_TRUE(us >= anterior);
+        anterior = us;
+    }
+    uint64_t const ms_antes = SP_Tiempo_getMilisegundos64();
+    uint64_t const us = SP_Tiempo_getMicrosegundos64();
+    uint64_t const ms_despues = SP_Tiempo_getMilisegundos64();
+    TEST_ASSERT_TRUE(us >= ms_antes*1000);
+    TEST_ASSERT_TRUE(us < (ms_despues + 1)*1000);
+}
+
+static void test_SP_Tiempo_getMicrosegundos64_tickPendiente(void){
+    uint32_t const ciclos_por_us = SystemCoreClock/1000000;
+    __disable_irq();                                                //SysTick_Handler no corre: el tick queda pendiente
+    uint64_t const inicio = SP_Tiempo_getMicrosegundos64();
+    CycleCounter_resetValue();
+    while (CycleCounter_getValue() < 1500*ciclos_por_us);           //Menos de dos ticks
+    uint64_t const fin = SP_Tiempo_getMicrosegundos64();
+    __enable_irq();
+    TEST_ASSERT_UINT64_WITHIN(20,1500,fin - inicio);
+}
+
+static void test_SP_Tiempo_getMicrosegundos64_costo(void){
+    enum {REPETICIONES = 100};
+    uint64_t volatile sumidero;
+    CycleCounter_resetValue();
+    for (uint32_t i=0;i<REPETICIONES;++i) sumidero = SP_Tiempo_getMicrosegundos64();
+    uint32_t const ciclos = CycleCounter_getValue()/REPETICIONES;
+    (void)sumidero;
+    char mensaje[64];
+    snprintf(mensaje,sizeof(mensaje),"SP_Tiempo_getMicrosegundos64: %lu ciclos",(unsigned long)ciclos);
+    TEST_MESSAGE(mensaje);
+}
+
+static void cuenta(void volatile *param){
+    uint32_t volatile *const c = param;
+    ++*c;
+}
+
+static void test_peor_tick_con_todos_los_timeouts_venciendo_juntos(void){
+    uint32_t volatile vencidos = 0;
+    uint32_t programados = 0;
+    __disable_irq();                                                //Llama a SysTick_Handler directamente: el reloj adelanta 1 ms
+    while (SP_Tiempo_addTimeout(1,cuenta,&vencidos)) ++programados;
+    for (unsigned t=1;t<SP_TIEMPO_TICKS_POR_MILISEGUNDO;++t) SysTick_Handler();
+    CycleCounter_resetValue();
+    SysTick_Handler();
+    uint32_t const ciclos = CycleCounter_getValue();
+    __enable_irq();
+    TEST_ASSERT_EQUAL_UINT32(programados,vencidos);
+    char mensaje[80];
+    snprintf(mensaje,sizeof(mensaje),"SysTick_Handler con %lu vencimientos: %lu ciclos",(unsigned long)programados,(unsigned long)ciclos);
+    TEST_MESSAGE(mensaje);
+}
+
 int main(void){
     SP_init();
     SP_Tiempo_delay(500);
@@ -176,9 +236,13 @@ int main(void){
     RUN_TEST(test_SP_delay_10ms_iniciaMediaCuenta);
     RUN_TEST(test_SP_delay_10ms_iniciaDespuesMediaCuenta);
     RUN_TEST(test_SP_Tiempo_getMilisegundos);
+    RUN_TEST(test_SP_Tiempo_getMicrosegundos64);
+    RUN_TEST(test_SP_Tiempo_getMicrosegundos64_tickPendiente);
+    RUN_TEST(test_SP_Tiempo_getMicrosegundos64_costo);
     RUN_TEST(test_un_timeout);
     RUN_TEST(test_varios_timeouts);
     RUN_TEST(test_varios_timeouts_iguales);
+    RUN_TEST(test_peor_tick_con_todos_los_timeouts_venciendo_juntos);
     CycleCounter_deinit();
     UNITY_END();
     return 0;
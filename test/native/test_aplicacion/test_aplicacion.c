@@ -0,0 +1,90 @@
+#include <aplicacion.h>
+#include <soporte_placa_sim.h>
+#include <unity.h>
+
+//Pruebas del controlador de luz de escalera completo sobre la placa simulada
+
+void setUp(void){
+    SP_Sim_reset();
+    Aplicacion_init();
+}
+void tearDown(void){
+
+}
+
+/**
+ * @brief Ejecuta el lazo principal durante el tiempo indicado,
+ * procesando todos los eventos pendientes en cada milisegundo
+ * 
+ * @param milisegundos Tiempo a simular
+ */
+static void ejecuta(uint32_t milisegundos){
+    for (uint32_t i=0;i<milisegundos;++i){
+        Aplicacion_procesa();
+        while(Aplicacion_procesa());
+        SP_Sim_Tiempo_avanza(1);
+    }
+}
+
+static void pulsa(void){
+    SP_Sim_Pin_setEntrada(PIN_PULSADOR,PULSADOR_NIVEL_ACTIVO);
+    ejecuta(50);
+    SP_Sim_Pin_setEntrada(PIN_PULSADOR,!PULSADOR_NIVEL_ACTIVO);
+    ejecuta(50);
+}
+
+static bool luzEncendida(void){
+    return SP_Sim_Pin_getSalida(PIN_LUZ) == LUZ_ON;
+}
+
+static void test_luz_apagada_luego_de_reset(void){
+    ejecuta(100);
+    TEST_ASSERT_FALSE(luzEncendida());
+}
+
+static void test_pulsacion_enciende_la_luz(void){
+    ejecuta(100);
+    pulsa();
+    TEST_ASSERT_TRUE(luzEncendida());
+}
+
+static void test_luz_se_apaga_luego_de_tiempo_on(void){
+    ejecuta(100);
+    pulsa();
+    ejecuta(TIEMPO_ON - 1000);
+    TEST_ASSERT_TRUE(luzEncendida());
+    ejecuta(1000);
+    TEST_ASSERT_FALSE(luzEncendida());
+}
+
+static void test_triple_pulsacion_entra_y_sale_de_mudanza(void){
+    ejecuta(100);
+    pulsa();
+    pulsa();
+    pulsa();
+    ejecuta(2*TIEMPO_ON);
+    TEST_ASSERT_TRUE(luzEncendida());
+    pulsa();
+    pulsa();
+    pulsa();
+    TEST_ASSERT_FALSE(luzEncendida());
+}
+
+static void test_mudanza_no_deja_timeouts_pendientes(void){
+    ejecuta(100);
+    pulsa();
+    pulsa();
+    pulsa();
+    TEST_ASSERT_EQUAL_UINT32(SP_TIEMPO_INDEFINIDO,Aplicacion_tiempoHastaProximoEvento());
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_luz_apagada_luego_de_reset);
+    RUN_TEST(test_pulsacion_enciende_la_luz);
+    RUN_TEST(test_luz_se_apaga_luego_de_tiempo_on);
+    RUN_TEST(test_triple_pulsacion_entra_y_sale_de_mudanza);
+    RUN_TEST(test_mudanza_no_deja_timeouts_pendientes);
+    UNITY_END();
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include <controlador_luz.h>
+#include <soporte_placa_sim.h>
+#include <unity.h>
+
+//Pruebas del controlador de luz con la cola llena por una ráfaga de pulsaciones
+
+enum {TIEMPO_ON_PRUEBA = 1000, RAFAGA = 2*CONTROLADOR_LUZ_CAPACIDAD_COLA};
+
+static DespachoRetardado despacho[1];
+static ControladorLuz controlador;
+
+static Maquina *maquina(void){
+    return ControladorLuz_asMaquina(&controlador);
+}
+
+static void procesa(void){
+    while(Maquina_procesa(maquina()));
+}
+
+/**
+ * @brief Avanza el reloj despachando los eventos retardados, sin
+ * procesarlos: el lazo principal está ocupado
+ */
+static void avanzaSinProcesar(uint32_t milisegundos){
+    for (uint32_t i=0;i<milisegundos;++i){
+        SP_Sim_Tiempo_avanza(1);
+        DespachoRetardado_procesarDespacho(despacho);
+    }
+}
+
+static void ejecuta(uint32_t milisegundos){
+    for (uint32_t i=0;i<milisegundos;++i){
+        avanzaSinProcesar(1);
+        procesa();
+    }
+}
+
+static void rafaga(void){
+    for (size_t i=0;i<RAFAGA;++i) Maquina_despacha(maquina(),EV_BOTON_PULSADO);
+}
+
+static bool luzEncendida(void){
+    return SP_Sim_Pin_getSalida(SP_PIN_LED);
+}
+
+void setUp(void){
+    SP_Sim_reset();
+    DespachoRetardado_init(despacho);
+    ControladorLuz_init(&controlador,TIEMPO_ON_PRUEBA,SP_PIN_LED,true,despacho);
+    procesa();
+    TEST_ASSERT_TRUE(Maquina_despacha(maquina(),EV_BOTON_PULSADO));
+    procesa();
+    TEST_ASSERT_TRUE(luzEncendida());
+}
+void tearDown(void){
+
+}
+
+static void test_timeout_seguido_de_rafaga_apaga_la_luz(void){
+    avanzaSinProcesar(TIEMPO_ON_PRUEBA);                                //EV_TIMEOUT en cola
+    rafaga();
+    bool seApago = false;
+    while(Maquina_procesa(maquina())){
+        if (!luzEncendida()) seApago = true;
+    }
+    TEST_ASSERT_TRUE(seApago);
+    TEST_ASSERT_EQUAL(RAFAGA - (CONTROLADOR_LUZ_CAPACIDAD_COLA - 2),Maquina_getDescartados(maquina()));
+    TEST_ASSERT_TRUE(luzEncendida());                                   //Una pulsación posterior al timeout la vuelve a encender
+    ejecuta(TIEMPO_ON_PRUEBA);
+    TEST_ASSERT_FALSE(luzEncendida());
+}
+
+static void test_rafaga_seguida_de_timeout_apaga_la_luz(void){
+    avanzaSinProcesar(TIEMPO_ON_PRUEBA - 1);
+    rafaga();
+    avanzaSinProcesar(1);                                               //EV_TIMEOUT en el lugar reservado
+    procesa();
+    TEST_ASSERT_FALSE(luzEncendida());
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_timeout_seguido_de_rafaga_apaga_la_luz);
+    RUN_TEST(test_rafaga_seguida_de_timeout_apaga_la_luz);
+    UNITY_END();
+    return 0;
+}
@@ -0,0 +1,199 @@
+#include <despacho_retardado.h>
+#include <maquina_estado_impl.h>
+#include <soporte_placa_sim.h>
+#include <unity.h>
+#include <time.h>
+
+//Pruebas del despacho retardado de eventos sobre el reloj simulado
+
+enum {EV_PRUEBA = EV_USUARIO, MAX_RECIBIDOS = 32};
+
+typedef struct Receptor{
+    Maquina maquina;
+    Evento recibidos[MAX_RECIBIDOS];
+    uint32_t instantes[MAX_RECIBIDOS];
+    size_t numRecibidos;
+}Receptor;
+
+static DespachoRetardado despacho[1];
+static Receptor receptor;
+
+static Resultado estadoRecibe(Maquina *contexto, Evento evento){
+    Receptor *const self = (Receptor*)contexto;
+    if (evento != EV_RESET && self->numRecibidos < MAX_RECIBIDOS){
+        self->recibidos[self->numRecibidos] = evento;
+        self->instantes[self->numRecibidos] = SP_Tiempo_getMilisegundos();
+        ++self->numRecibidos;
+    }
+    return Resultado_procesado();
+}
+
+/**
+ * @brief Avanza el reloj de a un milisegundo procesando despachos
+ * y eventos recibidos
+ * 
+ */
+static void ejecuta(uint32_t milisegundos){
+    for (uint32_t i=0;i<milisegundos;++i){
+        SP_Sim_Tiempo_avanza(1);
+        DespachoRetardado_procesarDespacho(despacho);
+        while(Maquina_procesa(&receptor.maquina));
+    }
+}
+
+void setUp(void){
+    SP_Sim_reset();
+    DespachoRetardado_init(despacho);
+    receptor = (Receptor){0};
+    Maquina_init(&receptor.maquina,estadoRecibe);
+    Maquina_procesa(&receptor.maquina);
+}
+void tearDown(void){
+
+}
+
+static void test_despacha_luego_del_tiempo(void){
+    DespachoRetardado_programarDespacho(despacho,&receptor.maquina,EV_PRUEBA,100);
+    ejecuta(99);
+    TEST_ASSERT_EQUAL(0,receptor.numRecibidos);
+    ejecuta(1);
+    TEST_ASSERT_EQUAL(1,receptor.numRecibidos);
+    TEST_ASSERT_EQUAL_UINT32(100,receptor.instantes[0]);
+}
+
+static void test_reprogramar_mismo_evento_no_duplica(void){
+    DespachoRetardado_programarDespacho(despacho,&receptor.maquina,EV_PRUEBA,100);
+    ejecuta(50);
+    DespachoRetardado_programarDespacho(despacho,&receptor.maquina,EV_PRUEBA,100);
+    ejecuta(200);
+    TEST_ASSERT_EQUAL(1,receptor.numRecibidos);
+    TEST_ASSERT_EQUAL_UINT32(150,receptor.instantes[0]);
+}
+
+static void test_despacha_en_orden_de_vencimiento(void){
+    static uint32_t const retardos[] = {70,10,50,30,90,20};
+    size_t const N = sizeof(retardos)/sizeof(retardos[0]);
+    for (size_t i=0;i<N;++i){
+        DespachoRetardado_programarDespacho(despacho,&receptor.maquina,EV_PRUEBA+i,retardos[i]);
+    }
+    ejecuta(100);
+    TEST_ASSERT_EQUAL(N,receptor.numRecibidos);
+    for (size_t i=1;i<N;++i){
+        TEST_ASSERT_TRUE(receptor.instantes[i-1] < receptor.instantes[i]);
+    }
+    TEST_ASSERT_EQUAL(EV_PRUEBA+1,receptor.recibidos[0]);
+    TEST_ASSERT_EQUAL(EV_PRUEBA+4,receptor.recibidos[N-1]);
+}
+
+static void test_cancelar(void){
+    DespachoRetardado_programarDespacho(despacho,&receptor.maquina,EV_PRUEBA,100);
+    DespachoRetardado_programarDespacho(despacho,&receptor.maquina,EV_PRUEBA+1,50);
+    TEST_ASSERT_TRUE(DespachoRetardado_cancelar(despacho,&receptor.maquina,EV_PRUEBA));
+    TEST_ASSERT_FALSE(DespachoRetardado_cancelar(despacho,&receptor.maquina,EV_PRUEBA));
+    ejecuta(200);
+    TEST_ASSERT_EQUAL(1,receptor.numRecibidos);
+    TEST_ASSERT_EQUAL(EV_PRUEBA+1,receptor.recibidos[0]);
+}
+
+static void test_cancelar_por_handle(void){
+    DespachoRetardado_HDespacho const h = DespachoRetardado_programar(despacho,&receptor.maquina,EV_PRUEBA,100);
+    DespachoRetardado_programarDespacho(despacho,&receptor.maquina,EV_PRUEBA+1,50);
+    TEST_ASSERT_NOT_EQUAL(DESPACHO_RETARDADO_HANDLE_NULO,h);
+    TEST_ASSERT_TRUE(DespachoRetardado_cancelarDespacho(despacho,h));
+    TEST_ASSERT_FALSE(DespachoRetardado_cancelarDespacho(despacho,h));
+    ejecuta(200);
+    TEST_ASSERT_EQUAL(1,receptor.numRecibidos);
+    TEST_ASSERT_EQUAL(EV_PRUEBA+1,receptor.recibidos[0]);
+}
+
+static void test_reprogramar_por_handle(void){
+    DespachoRetardado_HDespacho const h = DespachoRetardado_programar(despacho,&receptor.maquina,EV_PRUEBA,100);
+    ejecuta(80);
+    TEST_ASSERT_TRUE(DespachoRetardado_reprogramar(despacho,h,100));
+    ejecuta(99);
+    TEST_ASSERT_EQUAL(0,receptor.numRecibidos);
+    ejecuta(1);
+    TEST_ASSERT_EQUAL(1,receptor.numRecibidos);
+    TEST_ASSERT_EQUAL_UINT32(180,receptor.instantes[0]);
+}
+
+static void test_handle_vencido_no_es_valido(void){
+    DespachoRetardado_HDespacho const h = DespachoRetardado_programar(despacho,&receptor.maquina,EV_PRUEBA,10);
+    ejecuta(10);
+    TEST_ASSERT_EQUAL(1,receptor.numRecibidos);
+    // El nuevo despacho puede reutilizar los recursos del anterior
+    DespachoRetardado_HDespacho const h2 = DespachoRetardado_programar(despacho,&receptor.maquina,EV_PRUEBA,10);
+    TEST_ASSERT_NOT_EQUAL(h,h2);
+    TEST_ASSERT_FALSE(DespachoRetardado_reprogramar(despacho,h,100));
+    TEST_ASSERT_FALSE(DespachoRetardado_cancelarDespacho(despacho,h));
+    TEST_ASSERT_FALSE(DespachoRetardado_cancelarDespacho(despacho,DESPACHO_RETARDADO_HANDLE_NULO));
+    ejecuta(10);
+    TEST_ASSERT_EQUAL(2,receptor.numRecibidos);
+}
+
+static void test_recursos_agotados_despacha_inmediatamente(void){
+    for (size_t i=0;i<MAX_DESPACHOS_RETARDADOS_ACTIVOS;++i){
+        DespachoRetardado_programarDespacho(despacho,&receptor.maquina,EV_PRUEBA+1+i,1000);
+    }
+    DespachoRetardado_programarDespacho(despacho,&receptor.maquina,EV_PRUEBA,1000);
+    while(Maquina_procesa(&receptor.maquina));
+    TEST_ASSERT_EQUAL(1,receptor.numRecibidos);
+    TEST_ASSERT_EQUAL(EV_PRUEBA,receptor.recibidos[0]);
+}
+
+static void test_tiempo_hasta_proximo_despacho(void){
+    TEST_ASSERT_EQUAL_UINT32(SP_TIEMPO_INDEFINIDO,DespachoRetardado_tiempoHastaProximoDespacho(despacho));
+    DespachoRetardado_programarDespacho(despacho,&receptor.maquina,EV_PRUEBA,100);
+    DespachoRetardado_programarDespacho(despacho,&receptor.maquina,EV_PRUEBA+1,40);
+    ejecuta(10);
+    TEST_ASSERT_EQUAL_UINT32(30,DespachoRetardado_tiempoHastaProximoDespacho(despacho));
+}
+
+/**
+ * @brief Mide el costo de procesar despachos con N pendientes que
+ * no vencen durante la medición
+ * 
+ * @return double Nanosegundos por llamada a DespachoRetardado_procesarDespacho
+ */
+static double costoProcesar(size_t N){
+    enum {LLAMADAS = 100000};
+    DespachoRetardado_init(despacho);
+    for (size_t i=0;i<N;++i){
+        DespachoRetardado_programarDespacho(despacho,&receptor.maquina,EV_PRUEBA+i,2*LLAMADAS+i);
+    }
+    struct timespec t0,t1;
+    clock_gettime(CLOCK_MONOTONIC,&t0);
+    for (size_t i=0;i<LLAMADAS;++i){
+        SP_Sim_Tiempo_avanza(1);
+        DespachoRetardado_procesarDespacho(despacho);
+    }
+    clock_gettime(CLOCK_MONOTONIC,&t1);
+    double const ns = (t1.tv_sec - t0.tv_sec)*1e9 + (t1.tv_nsec - t0.tv_nsec);
+    return ns / LLAMADAS;
+}
+
+static void test_costo_procesar_segun_despachos_pendientes(void){
+    static size_t const pendientes[] = {4,32,256};
+    for (size_t i=0;i<3;++i){
+        double const costo = costoProcesar(pendientes[i] < MAX_DESPACHOS_RETARDADOS_ACTIVOS ? pendientes[i] : MAX_DESPACHOS_RETARDADOS_ACTIVOS);
+        char mensaje[80];
+        snprintf(mensaje,sizeof(mensaje),"%u pendientes: %.1f ns por procesarDespacho",(unsigned)pendientes[i],costo);
+        TEST_MESSAGE(mensaje);
+    }
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_despacha_luego_del_tiempo);
+    RUN_TEST(test_reprogramar_mismo_evento_no_duplica);
+    RUN_TEST(test_despacha_en_orden_de_vencimiento);
+    RUN_TEST(test_cancelar);
+    RUN_TEST(test_cancelar_por_handle);
+    RUN_TEST(test_reprogramar_por_handle);
+    RUN_TEST(test_handle_vencido_no_es_valido);
+    RUN_TEST(test_recursos_agotados_despacha_inmediatamente);
+    RUN_TEST(test_tiempo_hasta_proximo_despacho);
+    RUN_TEST(test_costo_procesar_segun_despachos_pendientes);
+    UNITY_END();
+    return 0;
+}
@@ -0,0 +1,581 @@
+#include <maquina_estado_impl.h>
+#include <soporte_placa_sim.h>
+#include <unity.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+
+//Pruebas de la cola de eventos de la máquina de estado
+
+enum {EV_PRUEBA = EV_USUARIO, MAX_RECIBIDOS = 2*MAX_EV_COLA};
+
+typedef struct Receptor{
+    Maquina maquina;
+    Evento recibidos[MAX_RECIBIDOS];
+#if MAQUINA_TAM_PARAMETRO
+    uint32_t parametros[MAX_RECIBIDOS];
+#endif
+    size_t numRecibidos;
+}Receptor;
+
+static Receptor receptor;
+
+static Resultado estadoRecibe(Maquina *contexto, Evento evento){
+    Receptor *const self = (Receptor*)contexto;
+    if (evento != EV_RESET && self->numRecibidos < MAX_RECIBIDOS){
+        self->recibidos[self->numRecibidos] = evento;
+#if MAQUINA_TAM_PARAMETRO
+        memcpy(&self->parametros[self->numRecibidos],Maquina_getParametro(contexto),sizeof(uint32_t));
+#endif
+        ++self->numRecibidos;
+    }
+    return Resultado_procesado();
+}
+
+void setUp(void){
+    SP_Sim_reset();
+    receptor = (Receptor){0};
+    Maquina_init(&receptor.maquina,estadoRecibe);
+    Maquina_procesa(&receptor.maquina);
+}
+void tearDown(void){
+
+}
+
+static void test_procesa_en_orden_de_despacho(void){
+    for (size_t i=0;i<3;++i){
+        TEST_ASSERT_TRUE(Maquina_despacha(&receptor.maquina,EV_PRUEBA+i));
+    }
+    while(Maquina_procesa(&receptor.maquina));
+    TEST_ASSERT_EQUAL(3,receptor.numRecibidos);
+    for (size_t i=0;i<3;++i){
+        TEST_ASSERT_EQUAL(EV_PRUEBA+i,receptor.recibidos[i]);
+    }
+    TEST_ASSERT_FALSE(Maquina_procesa(&receptor.maquina));
+}
+
+static void test_cola_llena_rechaza_eventos(void){
+    for (size_t i=0;i<MAX_EV_COLA;++i){
+        TEST_ASSERT_TRUE(Maquina_despacha(&receptor.maquina,EV_PRUEBA));
+    }
+    TEST_ASSERT_FALSE(Maquina_despacha(&receptor.maquina,EV_PRUEBA));
+    TEST_ASSERT_FALSE(Maquina_despacha(&receptor.maquina,EV_NULO));
+    while(Maquina_procesa(&receptor.maquina));
+    TEST_ASSERT_EQUAL(MAX_EV_COLA,receptor.numRecibidos);
+}
+
+static void test_cola_propia_de_la_capacidad_dada(void){
+    LugarCola lugares[4];
+    TEST_ASSERT_TRUE(Maquina_initConCola(&receptor.maquina,estadoRecibe,lugares,4));
+    Maquina_procesa(&receptor.maquina);
+    for (uint32_t vuelta=0;vuelta<3;++vuelta){                          //Varias vueltas por la cola
+        for (size_t i=0;i<4;++i){
+            TEST_ASSERT_TRUE(Maquina_despacha(&receptor.maquina,EV_PRUEBA+i));
+        }
+        TEST_ASSERT_FALSE(Maquina_despacha(&receptor.maquina,EV_PRUEBA));
+        while(Maquina_procesa(&receptor.maquina));
+    }
+    TEST_ASSERT_EQUAL(12,receptor.numRecibidos);
+    TEST_ASSERT_EQUAL(EV_PRUEBA+3,receptor.recibidos[11]);
+}
+
+static void test_capacidad_invalida_es_rechazada(void){
+    LugarCola lugares[8];
+    static uint32_t const invalidas[] = {0,1,3,6};
+    for (size_t i=0;i<sizeof(invalidas)/sizeof(*invalidas);++i){
+        TEST_ASSERT_FALSE(Maquina_initConCola(&receptor.maquina,estadoRecibe,lugares,invalidas[i]));
+    }
+#if MAQUINA_EVENTO_8_BITS
+    TEST_ASSERT_FALSE(Maquina_initConCola(&receptor.maquina,estadoRecibe,lugares,2*MAQUINA_MAX_CAPACIDAD_COLA));
+#endif
+    TEST_ASSERT_TRUE(Maquina_initConCola(&receptor.maquina,estadoRecibe,lugares,2));
+}
+
+static void test_cola_invalida_rechaza_despachos(void){
+    LugarCola lugares[8];
+    TEST_ASSERT_FALSE(Maquina_initConCola(&receptor.maquina,estadoRecibe,lugares,3));
+    TEST_ASSERT_FALSE(Maquina_despacha(&receptor.maquina,EV_PRUEBA));
+    TEST_ASSERT_FALSE(Maquina_despacha(&receptor.maquina,EV_PRUEBA+1));
+    TEST_ASSERT_FALSE(Maquina_hayEventosPendientes(&receptor.maquina));
+    TEST_ASSERT_FALSE(Maquina_procesa(&receptor.maquina));
+    TEST_ASSERT_FALSE(Maquina_initConCola(&receptor.maquina,estadoRecibe,NULL,4));
+    TEST_ASSERT_FALSE(Maquina_despacha(&receptor.maquina,EV_PRUEBA));
+    TEST_ASSERT_FALSE(Maquina_hayEventosPendientes(&receptor.maquina));
+    TEST_ASSERT_FALSE(Maquina_procesa(&receptor.maquina));
+    Maquina_setPoliticaDesborde(&receptor.maquina,MAQUINA_DESBORDE_DESCARTA_VIEJO,NULL);
+    TEST_ASSERT_FALSE(Maquina_despacha(&receptor.maquina,EV_PRUEBA));
+    TEST_ASSERT_EQUAL(0,receptor.numRecibidos);
+}
+
+/**
+ * @brief Inicia la máquina con una cola de 4 lugares y la política
+ * dada y la llena con EV_PRUEBA, ..., EV_PRUEBA+3
+ */
+static void llenaCola(LugarCola *lugares, PoliticaDesborde politica, AvisoDesborde aviso){
+    TEST_ASSERT_TRUE(Maquina_initConCola(&receptor.maquina,estadoRecibe,lugares,4));
+    Maquina_setPoliticaDesborde(&receptor.maquina,politica,aviso);
+    Maquina_procesa(&receptor.maquina);
+    for (size_t i=0;i<4;++i){
+        TEST_ASSERT_TRUE(Maquina_despacha(&receptor.maquina,EV_PRUEBA+i));
+    }
+}
+
+static void test_descarta_nuevo_y_cuenta_descartados(void){
+    LugarCola lugares[4];
+    llenaCola(lugares,MAQUINA_DESBORDE_DESCARTA_NUEVO,NULL);
+    TEST_ASSERT_FALSE(Maquina_despacha(&receptor.maquina,EV_PRUEBA+4));
+    TEST_ASSERT_FALSE(Maquina_despacha(&receptor.maquina,EV_PRUEBA+5));
+    TEST_ASSERT_EQUAL(2,Maquina_getDescartados(&receptor.maquina));
+    TEST_ASSERT_EQUAL(1,Maquina_getOcupacionMaxima(&receptor.maquina));     //Solo se procesó el reset
+    while(Maquina_procesa(&receptor.maquina));
+    TEST_ASSERT_EQUAL(4,Maquina_getOcupacionMaxima(&receptor.maquina));
+    TEST_ASSERT_EQUAL(4,receptor.numRecibidos);
+    TEST_ASSERT_EQUAL(EV_PRUEBA+3,receptor.recibidos[3]);
+}
+
+static void test_descarta_viejo_conserva_los_ultimos(void){
+    LugarCola lugares[4];
+    llenaCola(lugares,MAQUINA_DESBORDE_DESCARTA_VIEJO,NULL);
+    TEST_ASSERT_TRUE(Maquina_despacha(&receptor.maquina,EV_PRUEBA+4));
+    TEST_ASSERT_TRUE(Maquina_despacha(&receptor.maquina,EV_PRUEBA+5));
+    TEST_ASSERT_EQUAL(2,Maquina_getDescartados(&receptor.maquina));
+    SP_Sim_reiniciaBloqueos();
+    while(Maquina_procesa(&receptor.maquina));
+    TEST_ASSERT_EQUAL(5,SP_Sim_getBloqueos().secciones);                   //El consumidor toma cada evento bloqueando, también al ver la cola vacía
+    TEST_ASSERT_EQUAL(4,receptor.numRecibidos);
+    for (size_t i=0;i<4;++i){
+        TEST_ASSERT_EQUAL(EV_PRUEBA+2+i,receptor.recibidos[i]);
+    }
+    TEST_ASSERT_EQUAL(4,Maquina_getOcupacionMaxima(&receptor.maquina));
+}
+
+static void test_fusiona_eventos_repetidos(void){
+    LugarCola lugares[4];
+    llenaCola(lugares,MAQUINA_DESBORDE_FUSIONA,NULL);
+    TEST_ASSERT_TRUE(Maquina_despacha(&receptor.maquina,EV_PRUEBA+1));    //Igual a uno en cola
+    TEST_ASSERT_FALSE(Maquina_despacha(&receptor.maquina,EV_PRUEBA+4));
+    TEST_ASSERT_EQUAL(1,Maquina_getDescartados(&receptor.maquina));
+    while(Maquina_procesa(&receptor.maquina));
+    TEST_ASSERT_EQUAL(4,receptor.numRecibidos);
+    TEST_ASSERT_EQUAL(EV_PRUEBA+3,receptor.recibidos[3]);
+}
+
+static void test_reserva_un_lugar_por_evento_fusionable(void){
+    LugarCola lugares[4];
+    TEST_ASSERT_TRUE(Maquina_initConCola(&receptor.maquina,estadoRecibe,lugares,4));
+    Maquina_setPoliticaDesborde(&receptor.maquina,MAQUINA_DESBORDE_RESERVA_FUSIONABLES,NULL);
+    Maquina_setEventosFusionables(&receptor.maquina,MAQUINA_BIT_EVENTO(EV_PRUEBA) | MAQUINA_BIT_EVENTO(EV_PRUEBA+1));
+    Maquina_procesa(&receptor.maquina);
+    TEST_ASSERT_TRUE(Maquina_despacha(&receptor.maquina,EV_PRUEBA+2));
+    TEST_ASSERT_TRUE(Maquina_despacha(&receptor.maquina,EV_PRUEBA+3));
+    TEST_ASSERT_FALSE(Maquina_despacha(&receptor.maquina,EV_PRUEBA+2));       //Quedan solo los lugares reservados
+    TEST_ASSERT_FALSE(Maquina_despachaBloqueado(&receptor.maquina,EV_PRUEBA+3));
+    TEST_ASSERT_TRUE(Maquina_despacha(&receptor.maquina,EV_PRUEBA+1));
+    TEST_ASSERT_TRUE(Maquina_despacha(&receptor.maquina,EV_PRUEBA));
+    TEST_ASSERT_TRUE(Maquina_despacha(&receptor.maquina,EV_PRUEBA));          //Fusionado
+    TEST_ASSERT_EQUAL(2,Maquina_getDescartados(&receptor.maquina));
+    SP_Sim_reiniciaBloqueos();
+    while(Maquina_procesa(&receptor.maquina));
+    TEST_ASSERT_EQUAL(0,SP_Sim_getBloqueos().secciones);                   //El consumidor no bloquea
+    static Evento const esperados[] = {EV_PRUEBA+2,EV_PRUEBA+3,EV_PRUEBA+1,EV_PRUEBA};
+    TEST_ASSERT_EQUAL(4,receptor.numRecibidos);
+    for (size_t i=0;i<4;++i){
+        TEST_ASSERT_EQUAL(esperados[i],receptor.recibidos[i]);
+    }
+}
+
+static Evento avisado;
+
+static void avisaDesborde(Maquina *maquina, Evento evento){
+    TEST_ASSERT_TRUE(maquina == &receptor.maquina);
+    avisado = evento;
+}
+
+static void test_aviso_de_desborde(void){
+    LugarCola lugares[4];
+    llenaCola(lugares,MAQUINA_DESBORDE_AVISA,avisaDesborde);
+    avisado = EV_NULO;
+    TEST_ASSERT_FALSE(Maquina_despacha(&receptor.maquina,EV_PRUEBA+4));
+    TEST_ASSERT_EQUAL(EV_PRUEBA+4,avisado);
+    TEST_ASSERT_EQUAL(1,Maquina_getDescartados(&receptor.maquina));
+    TEST_ASSERT_TRUE(SP_Sim_qInterrupcionesHabilitadas());                 //El aviso corre fuera de la sección crítica
+}
+
+static void test_evento_fusionable_ocupa_un_lugar(void){
+    Maquina_setEventosFusionables(&receptor.maquina,MAQUINA_BIT_EVENTO(EV_PRUEBA));
+    for (size_t i=0;i<3*MAX_EV_COLA;++i){                             //Más despachos que lugares
+        TEST_ASSERT_TRUE(Maquina_despacha(&receptor.maquina,EV_PRUEBA));
+    }
+    TEST_ASSERT_TRUE(Maquina_despacha(&receptor.maquina,EV_PRUEBA+1));
+    TEST_ASSERT_TRUE(Maquina_despacha(&receptor.maquina,EV_PRUEBA+1)); //No fusionable
+    TEST_ASSERT_TRUE(Maquina_procesa(&receptor.maquina));
+    TEST_ASSERT_TRUE(Maquina_despacha(&receptor.maquina,EV_PRUEBA));  //Ya tomado: vuelve a encolarse
+    while(Maquina_procesa(&receptor.maquina));
+    static Evento const esperados[] = {EV_PRUEBA,EV_PRUEBA+1,EV_PRUEBA+1,EV_PRUEBA};
+    TEST_ASSERT_EQUAL(4,receptor.numRecibidos);
+    for (size_t i=0;i<4;++i){
+        TEST_ASSERT_EQUAL(esperados[i],receptor.recibidos[i]);
+    }
+    TEST_ASSERT_EQUAL(3,Maquina_getOcupacionMaxima(&receptor.maquina));
+    TEST_ASSERT_EQUAL(0,Maquina_getDescartados(&receptor.maquina));
+}
+
+static void test_evento_fusionable_descartado_deja_de_estar_pendiente(void){
+    LugarCola lugares[4];
+    TEST_ASSERT_TRUE(Maquina_initConCola(&receptor.maquina,estadoRecibe,lugares,4));
+    Maquina_setPoliticaDesborde(&receptor.maquina,MAQUINA_DESBORDE_DESCARTA_VIEJO,NULL);
+    Maquina_setEventosFusionables(&receptor.maquina,MAQUINA_BIT_EVENTO(EV_PRUEBA));
+    Maquina_procesa(&receptor.maquina);
+    for (size_t i=0;i<5;++i){                                           //El último quita al EV_PRUEBA más antiguo
+        TEST_ASSERT_TRUE(Maquina_despacha(&receptor.maquina,EV_PRUEBA+i));
+    }
+    TEST_ASSERT_TRUE(Maquina_despacha(&receptor.maquina,EV_PRUEBA));
+    while(Maquina_procesa(&receptor.maquina));
+    TEST_ASSERT_EQUAL(4,receptor.numRecibidos);
+    TEST_ASSERT_EQUAL(EV_PRUEBA,receptor.recibidos[3]);
+}
+
+static Resultado estadoDestino(Maquina *contexto, Evento evento){
+    return estadoRecibe(contexto,evento);
+}
+
+enum {DESPLAZAMIENTO_MARCA = 100};
+
+static Resultado estadoMarca(Maquina *contexto, Evento evento){
+    return estadoRecibe(contexto,(evento == EV_RESET) ? evento : evento + DESPLAZAMIENTO_MARCA);
+}
+
+static Resultado estadoCambia(Maquina *contexto, Evento evento){
+    estadoRecibe(contexto,evento);
+    return (evento == EV_PRUEBA+1) ? Resultado_transicion(estadoMarca) : Resultado_procesado();
+}
+
+static void test_procesa_lote_hasta_el_maximo(void){
+    Maquina_init(&receptor.maquina,estadoCambia);
+    for (size_t i=0;i<5;++i){
+        TEST_ASSERT_TRUE(Maquina_despacha(&receptor.maquina,EV_PRUEBA+i));
+    }
+    TEST_ASSERT_EQUAL(4,Maquina_procesaLote(&receptor.maquina,4));      //Reset y tres eventos
+    TEST_ASSERT_EQUAL(2,Maquina_procesaLote(&receptor.maquina,16));     //Se vació la cola
+    TEST_ASSERT_EQUAL(0,Maquina_procesaLote(&receptor.maquina,16));
+    static Evento const esperados[] = {EV_PRUEBA,EV_PRUEBA+1,EV_PRUEBA+2+DESPLAZAMIENTO_MARCA,
+                                       EV_PRUEBA+3+DESPLAZAMIENTO_MARCA,EV_PRUEBA+4+DESPLAZAMIENTO_MARCA};
+    TEST_ASSERT_EQUAL(5,receptor.numRecibidos);
+    for (size_t i=0;i<5;++i){
+        TEST_ASSERT_EQUAL(esperados[i],receptor.recibidos[i]);
+    }
+    Maquina_despacha(&receptor.maquina,EV_PRUEBA);
+    TEST_ASSERT_TRUE(Maquina_procesa(&receptor.maquina));               //El lote guardó el estado al terminar
+    TEST_ASSERT_EQUAL(EV_PRUEBA+DESPLAZAMIENTO_MARCA,receptor.recibidos[5]);
+}
+
+static void test_resultado_en_una_palabra(void){
+    TEST_ASSERT_EQUAL(sizeof(uintptr_t),sizeof(Resultado));
+    TEST_ASSERT_EQUAL(RES_IGNORADO,Resultado_getCodigo(Resultado_ignorado()));
+    TEST_ASSERT_EQUAL(RES_PROCESADO,Resultado_getCodigo(Resultado_procesado()));
+    Resultado const transicion = Resultado_transicion(estadoDestino);
+    TEST_ASSERT_EQUAL(RES_TRANSICION,Resultado_getCodigo(transicion));
+    TEST_ASSERT_TRUE(Resultado_getNuevoEstado(transicion) == estadoDestino);
+}
+
+#if MAQUINA_EVENTO_8_BITS
+static void test_evento_de_mas_de_8_bits_es_rechazado(void){
+    TEST_ASSERT_FALSE(Maquina_despacha(&receptor.maquina,UINT8_MAX + 1));
+    TEST_ASSERT_TRUE(Maquina_despacha(&receptor.maquina,UINT8_MAX));
+    Maquina_procesa(&receptor.maquina);
+    TEST_ASSERT_EQUAL(UINT8_MAX,receptor.recibidos[0]);
+}
+#endif
+
+#if MAQUINA_TAM_PARAMETRO
+
+static void test_parametro_acompana_al_evento(void){
+    // Más despachos que lugares en la cola: cada parámetro sobrevive al reuso del lugar
+    for (uint32_t i=0;i<MAX_RECIBIDOS;++i){
+        uint32_t const parametro = 1000 + i;
+        TEST_ASSERT_TRUE(Maquina_despachaConParametro(&receptor.maquina,EV_PRUEBA,&parametro,sizeof(parametro)));
+        if (i >= MAX_EV_COLA/2) Maquina_procesa(&receptor.maquina);
+    }
+    while(Maquina_procesa(&receptor.maquina));
+    TEST_ASSERT_EQUAL(MAX_RECIBIDOS,receptor.numRecibidos);
+    for (uint32_t i=0;i<MAX_RECIBIDOS;++i){
+        TEST_ASSERT_EQUAL_UINT32(1000 + i,receptor.parametros[i]);
+    }
+}
+
+static void test_parametro_demasiado_grande_es_rechazado(void){
+    unsigned char parametro[MAQUINA_TAM_PARAMETRO + 1] = {0};
+    TEST_ASSERT_FALSE(Maquina_despachaConParametro(&receptor.maquina,EV_PRUEBA,parametro,sizeof(parametro)));
+    TEST_ASSERT_TRUE(Maquina_despachaConParametro(&receptor.maquina,EV_PRUEBA,parametro,MAQUINA_TAM_PARAMETRO));
+    TEST_ASSERT_FALSE(Maquina_despachaConParametro(&receptor.maquina,EV_NULO,parametro,1));
+    while(Maquina_procesa(&receptor.maquina));
+    TEST_ASSERT_EQUAL(1,receptor.numRecibidos);
+}
+
+#endif
+
+static void test_despacho_y_bloqueo_de_interrupciones(void){
+    SP_Sim_reiniciaBloqueos();
+    for (size_t i=0;i<3;++i){
+        Maquina_despacha(&receptor.maquina,EV_PRUEBA);
+    }
+    while(Maquina_procesa(&receptor.maquina));
+    TEST_ASSERT_TRUE(SP_Sim_qInterrupcionesHabilitadas());
+#if MAQUINA_COLA == MAQUINA_COLA_BLOQUEO
+    TEST_ASSERT_EQUAL(3,SP_Sim_getBloqueos().secciones);
+#else
+    TEST_ASSERT_EQUAL(0,SP_Sim_getBloqueos().secciones);
+#endif
+}
+
+#if MAQUINA_COLA != MAQUINA_COLA_BLOQUEO
+
+#if MAQUINA_COLA == MAQUINA_COLA_MPSC
+enum {PRODUCTORES = 3};
+#else
+enum {PRODUCTORES = 1};
+#endif
+#if MAQUINA_EVENTO_8_BITS
+enum {EVENTOS_POR_PRODUCTOR = 50000, BITS_CONTADOR = 6};          //El contador da la vuelta: el evento entra en un byte
+#else
+enum {EVENTOS_POR_PRODUCTOR = 50000, BITS_CONTADOR = 20};
+#endif
+#define MASCARA_CONTADOR ((1u << BITS_CONTADOR) - 1)
+
+/**
+ * @brief Productor concurrente: despacha eventos que codifican su
+ * número y un contador, reintentando mientras la cola esté llena
+ */
+static void *productor(void *param){
+    uintptr_t const numero = (uintptr_t)param;
+    for (Evento i=0;i<EVENTOS_POR_PRODUCTOR;++i){
+        Evento const evento = EV_USUARIO + ((numero << BITS_CONTADOR) | (i & MASCARA_CONTADOR));
+        while(!Maquina_despacha(&receptor.maquina,evento)) sched_yield();
+    }
+    return NULL;
+}
+
+static struct{
+    Evento siguiente[PRODUCTORES];
+    size_t desordenados;
+}verificacion;
+
+static Resultado estadoVerifica(Maquina *contexto, Evento evento){
+    (void)contexto;
+    if (evento != EV_RESET){
+        Evento const valor = evento - EV_USUARIO;
+        size_t const numero = valor >> BITS_CONTADOR;
+        Evento const contador = valor & MASCARA_CONTADOR;
+        if (numero >= PRODUCTORES || contador != (verificacion.siguiente[numero] & MASCARA_CONTADOR)) ++verificacion.desordenados;
+        else ++verificacion.siguiente[numero];
+    }
+    return Resultado_procesado();
+}
+
+static void test_productores_concurrentes(void){
+    pthread_t hilos[PRODUCTORES];
+    memset(&verificacion,0,sizeof(verificacion));
+    Maquina_init(&receptor.maquina,estadoVerifica);
+    for (uintptr_t i=0;i<PRODUCTORES;++i){
+        pthread_create(&hilos[i],NULL,productor,(void*)i);
+    }
+    size_t procesados = 0;
+    while (procesados < 1 + PRODUCTORES*EVENTOS_POR_PRODUCTOR){
+        if (Maquina_procesa(&receptor.maquina)) ++procesados;
+        else sched_yield();
+    }
+    for (size_t i=0;i<PRODUCTORES;++i){
+        pthread_join(hilos[i],NULL);
+    }
+    TEST_ASSERT_FALSE(Maquina_procesa(&receptor.maquina));
+    TEST_ASSERT_EQUAL(0,verificacion.desordenados);
+    for (size_t i=0;i<PRODUCTORES;++i){
+        TEST_ASSERT_EQUAL(EVENTOS_POR_PRODUCTOR,verificacion.siguiente[i]);
+    }
+}
+
+#endif
+
+static volatile Evento sumidero;
+
+static Resultado estadoConsume(Maquina *contexto, Evento evento){
+#if MAQUINA_TAM_PARAMETRO
+    sumidero = evento + *(unsigned char const*)Maquina_getParametro(contexto);
+#else
+    (void)contexto;
+    sumidero = evento;
+#endif
+    return Resultado_procesado();
+}
+
+/**
+ * @brief Mide el costo de despachar y procesar un evento con un
+ * parámetro del tamaño dado (0: Maquina_despacha)
+ *
+ * @return double Nanosegundos por par despacho + procesamiento
+ */
+static double costoDespacho(size_t tamano){
+    enum {LLAMADAS = 1000000};
+    unsigned char parametro[MAQUINA_TAM_PARAMETRO + 1] = {1};
+    Maquina_init(&receptor.maquina,estadoConsume);
+    Maquina_procesa(&receptor.maquina);
+    struct timespec t0,t1;
+    clock_gettime(CLOCK_MONOTONIC,&t0);
+    for (size_t i=0;i<LLAMADAS;++i){
+#if MAQUINA_TAM_PARAMETRO
+        if (tamano) Maquina_despachaConParametro(&receptor.maquina,EV_PRUEBA,parametro,tamano);
+        else
+#endif
+        Maquina_despacha(&receptor.maquina,EV_PRUEBA);
+        Maquina_procesa(&receptor.maquina);
+    }
+    clock_gettime(CLOCK_MONOTONIC,&t1);
+    (void)parametro;
+    (void)tamano;
+    double const ns = (t1.tv_sec - t0.tv_sec)*1e9 + (t1.tv_nsec - t0.tv_nsec);
+    return ns / LLAMADAS;
+}
+
+/**
+ * @brief Informa el costo del despacho y el mayor tiempo con las
+ * interrupciones deshabilitadas mientras el lazo despacha y procesa
+ */
+static void test_latencia_interrupciones_al_despachar(void){
+    static char const *const modos[] = {"bloqueo","spsc","mpsc"};
+    SP_Sim_reiniciaBloqueos();
+    double const ns = costoDespacho(0);
+    SP_Sim_Bloqueos const bloqueos = SP_Sim_getBloqueos();
+    double const media = bloqueos.secciones ? (double)bloqueos.nanosegundosTotal / bloqueos.secciones : 0.0;
+    char mensaje[160];
+    snprintf(mensaje,sizeof(mensaje),"cola %s: %.1f ns por despacho+proceso, %u secciones con IRQ deshabilitadas (media %.1f ns, maxima %u ns)",
+             modos[MAQUINA_COLA],ns,(unsigned)bloqueos.secciones,media,(unsigned)bloqueos.nanosegundosMaximo);
+    TEST_MESSAGE(mensaje);
+#if MAQUINA_COLA != MAQUINA_COLA_BLOQUEO
+    TEST_ASSERT_EQUAL(0,bloqueos.secciones);
+#endif
+}
+
+static void test_costo_despacho_segun_parametro(void){
+    static size_t const tamanos[] = {0,4,MAQUINA_TAM_PARAMETRO};
+    for (size_t i=0;i<3;++i){
+        bool const repetido = (i && tamanos[i] <= tamanos[i-1]);
+        if (repetido || tamanos[i] > MAQUINA_TAM_PARAMETRO) continue;
+        char mensaje[96];
+        snprintf(mensaje,sizeof(mensaje),"parametro de %u bytes (MAQUINA_TAM_PARAMETRO=%u): %.1f ns por despacho+proceso",
+                 (unsigned)tamanos[i],(unsigned)MAQUINA_TAM_PARAMETRO,costoDespacho(tamanos[i]));
+        TEST_MESSAGE(mensaje);
+    }
+}
+
+enum {RAFAGAS = 20000, REPETICIONES_RAFAGA = 3};
+
+/**
+ * @brief Nanosegundos por ráfaga de n despachos del mismo evento
+ * seguida del procesamiento de la cola
+ */
+static double costoRafaga(unsigned n, bool fusion){
+    Maquina_setEventosFusionables(&receptor.maquina,fusion ? MAQUINA_BIT_EVENTO(EV_PRUEBA) : 0);
+    double minimo = 1e30;
+    for (size_t r=0;r<REPETICIONES_RAFAGA;++r){
+        struct timespec t0,t1;
+        clock_gettime(CLOCK_MONOTONIC,&t0);
+        for (size_t i=0;i<RAFAGAS;++i){
+            for (unsigned e=0;e<n;++e) Maquina_despacha(&receptor.maquina,EV_PRUEBA);
+            while(Maquina_procesa(&receptor.maquina));
+        }
+        clock_gettime(CLOCK_MONOTONIC,&t1);
+        double const ns = (t1.tv_sec - t0.tv_sec)*1e9 + (t1.tv_nsec - t0.tv_nsec);
+        if (ns < minimo) minimo = ns;
+    }
+    return minimo / RAFAGAS;
+}
+
+static void test_costo_rafaga_segun_fusion(void){
+    static unsigned const cantidades[] = {1,4,MAX_EV_COLA};
+    for (size_t c=0;c<sizeof(cantidades)/sizeof(*cantidades);++c){
+        unsigned const n = cantidades[c];
+        double const sinFusion = costoRafaga(n,false);
+        double const conFusion = costoRafaga(n,true);
+        TEST_ASSERT_EQUAL(0,Maquina_getDescartados(&receptor.maquina));
+        char mensaje[128];
+        snprintf(mensaje,sizeof(mensaje),"rafaga de %2u eventos iguales: %.1f ns sin fusion, %.1f ns con fusion",
+                 n,sinFusion,conFusion);
+        TEST_MESSAGE(mensaje);
+    }
+    TEST_ASSERT_EQUAL(MAX_EV_COLA,Maquina_getOcupacionMaxima(&receptor.maquina));
+}
+
+/**
+ * @brief Millones de eventos por segundo al vaciar ráfagas de n
+ * eventos con Maquina_procesa en un lazo o con Maquina_procesaLote.
+ * El despacho de cada ráfaga se incluye en ambos casos
+ */
+static double eventosPorSegundo(unsigned n, bool lote){
+    double minimo = 1e30;
+    for (size_t r=0;r<REPETICIONES_RAFAGA;++r){
+        struct timespec t0,t1;
+        clock_gettime(CLOCK_MONOTONIC,&t0);
+        for (size_t i=0;i<RAFAGAS;++i){
+            for (unsigned e=0;e<n;++e) Maquina_despacha(&receptor.maquina,EV_PRUEBA);
+            if (lote){
+                Maquina_procesaLote(&receptor.maquina,n);
+            }else{
+                while(Maquina_procesa(&receptor.maquina));
+            }
+        }
+        clock_gettime(CLOCK_MONOTONIC,&t1);
+        double const ns = (t1.tv_sec - t0.tv_sec)*1e9 + (t1.tv_nsec - t0.tv_nsec);
+        if (ns < minimo) minimo = ns;
+    }
+    return 1e3 * RAFAGAS * n / minimo;
+}
+
+static void test_eventos_por_segundo_segun_rafaga(void){
+    static unsigned const cantidades[] = {1,2,4,8,16};
+    for (size_t c=0;c<sizeof(cantidades)/sizeof(*cantidades);++c){
+        unsigned const n = cantidades[c];
+        double const uno = eventosPorSegundo(n,false);
+        double const lote = eventosPorSegundo(n,true);
+        TEST_ASSERT_FALSE(Maquina_hayEventosPendientes(&receptor.maquina));
+        char mensaje[128];
+        snprintf(mensaje,sizeof(mensaje),"rafaga de %2u eventos: %.1f M eventos/s con Maquina_procesa, %.1f M con Maquina_procesaLote",
+                 n,uno,lote);
+        TEST_MESSAGE(mensaje);
+    }
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_procesa_en_orden_de_despacho);
+    RUN_TEST(test_cola_llena_rechaza_eventos);
+    RUN_TEST(test_cola_propia_de_la_capacidad_dada);
+    RUN_TEST(test_capacidad_invalida_es_rechazada);
+    RUN_TEST(test_cola_invalida_rechaza_despachos);
+    RUN_TEST(test_descarta_nuevo_y_cuenta_descartados);
+    RUN_TEST(test_descarta_viejo_conserva_los_ultimos);
+    RUN_TEST(test_fusiona_eventos_repetidos);
+    RUN_TEST(test_reserva_un_lugar_por_evento_fusionable);
+    RUN_TEST(test_aviso_de_desborde);
+    RUN_TEST(test_evento_fusionable_ocupa_un_lugar);
+    RUN_TEST(test_evento_fusionable_descartado_deja_de_estar_pendiente);
+    RUN_TEST(test_resultado_en_una_palabra);
+    RUN_TEST(test_procesa_lote_hasta_el_maximo);
+#if MAQUINA_EVENTO_8_BITS
+    RUN_TEST(test_evento_de_mas_de_8_bits_es_rechazado);
+#endif
+#if MAQUINA_TAM_PARAMETRO
+    RUN_TEST(test_parametro_acompana_al_evento);
+    RUN_TEST(test_parametro_demasiado_grande_es_rechazado);
+#endif
+    RUN_TEST(test_despacho_y_bloqueo_de_interrupciones);
+#if MAQUINA_COLA != MAQUINA_COLA_BLOQUEO
+    RUN_TEST(test_productores_concurrentes);
+#endif
+    RUN_TEST(test_latencia_interrupciones_al_despachar);
+    RUN_TEST(test_costo_despacho_segun_parametro);
+    RUN_TEST(test_costo_rafaga_segun_fusion);
+    RUN_TEST(test_eventos_por_segundo_segun_rafaga);
+    UNITY_END();
+    return 0;
+}
@@ -0,0 +1,233 @@
+#include <maquina_jerarquica.h>
+#include <maquina_estado_impl.h>
+#include <soporte_placa_sim.h>
+#include <unity.h>
+#include <string.h>
+#include <time.h>
+
+//Pruebas de la máquina de estado jerárquica
+
+enum {EV_A_B = EV_USUARIO, EV_A_C, EV_B_B, EV_B_S2, EV_S1_S, EV_S_S2, EV_DE_S, EV_DE_RAIZ, EV_NINGUNO};
+
+/*
+ *  RAIZ
+ *  ├── S (inicial S1)
+ *  │   ├── S1 (inicial A)
+ *  │   │   ├── A
+ *  │   │   └── B
+ *  │   └── S2
+ *  └── C
+ */
+
+/**
+ * @brief Registro de las acciones ejecutadas, como una cadena
+ */
+static char traza[256];
+
+static void registra(char const *texto){
+    strncat(traza,texto,sizeof(traza) - strlen(traza) - 1);
+}
+
+#define ACCIONES(nombre) \
+    static void entra##nombre(Maquina *contexto){(void)contexto; registra("+" #nombre);} \
+    static void sale##nombre(Maquina *contexto){(void)contexto; registra("-" #nombre);}
+
+ACCIONES(RAIZ)
+ACCIONES(S)
+ACCIONES(S1)
+ACCIONES(S2)
+ACCIONES(A)
+ACCIONES(B)
+ACCIONES(C)
+
+static EstadoJerarquico const RAIZ, S, S1, S2, A, B, C;
+
+static Resultado procesaRaiz(Maquina *contexto, Evento evento){
+    Resultado r = Resultado_ignorado();
+    if (evento == EV_DE_RAIZ){
+        registra("!RAIZ");
+        r = Resultado_procesado();
+    }
+    (void)contexto;
+    return r;
+}
+
+static Resultado procesaS(Maquina *contexto, Evento evento){
+    Resultado r = Resultado_ignorado();
+    switch (evento){
+    case EV_DE_S:
+        registra("!S");
+        r = Resultado_procesado();
+    break;case EV_S_S2:
+        r = MaquinaJerarquica_transicion(contexto,&S2);
+    break;default:
+    break;
+    }
+    return r;
+}
+
+static Resultado procesaS1(Maquina *contexto, Evento evento){
+    Resultado r = Resultado_ignorado();
+    if (evento == EV_S1_S) r = MaquinaJerarquica_transicion(contexto,&S);
+    return r;
+}
+
+static Resultado procesaA(Maquina *contexto, Evento evento){
+    Resultado r = Resultado_ignorado();
+    switch (evento){
+    case EV_A_B:
+        r = MaquinaJerarquica_transicion(contexto,&B);
+    break;case EV_A_C:
+        r = MaquinaJerarquica_transicion(contexto,&C);
+    break;default:
+    break;
+    }
+    return r;
+}
+
+static Resultado procesaB(Maquina *contexto, Evento evento){
+    Resultado r = Resultado_ignorado();
+    switch (evento){
+    case EV_B_B:
+        r = MaquinaJerarquica_transicion(contexto,&B);
+    break;case EV_B_S2:
+        r = MaquinaJerarquica_transicion(contexto,&S2);
+    break;default:
+    break;
+    }
+    return r;
+}
+
+static EstadoJerarquico const RAIZ = {NULL,procesaRaiz,entraRAIZ,saleRAIZ,&S};
+static EstadoJerarquico const S = {&RAIZ,procesaS,entraS,saleS,&S1};
+static EstadoJerarquico const S1 = {&S,procesaS1,entraS1,saleS1,&A};
+static EstadoJerarquico const S2 = {&S,NULL,entraS2,saleS2,NULL};
+static EstadoJerarquico const A = {&S1,procesaA,entraA,saleA,NULL};
+static EstadoJerarquico const B = {&S1,procesaB,entraB,saleB,NULL};
+static EstadoJerarquico const C = {&RAIZ,NULL,entraC,saleC,NULL};
+
+static MaquinaJerarquica maquina;
+
+static void procesa(Evento evento){
+    traza[0] = 0;
+    Maquina_despacha(MaquinaJerarquica_asMaquina(&maquina),evento);
+    while(Maquina_procesa(MaquinaJerarquica_asMaquina(&maquina)));
+}
+
+void setUp(void){
+    SP_Sim_reset();
+    traza[0] = 0;
+    MaquinaJerarquica_init(&maquina,&RAIZ);
+    while(Maquina_procesa(MaquinaJerarquica_asMaquina(&maquina)));
+}
+void tearDown(void){
+
+}
+
+static void test_reset_entra_siguiendo_subestados_iniciales(void){
+    TEST_ASSERT_EQUAL_STRING("+RAIZ+S+S1+A",traza);
+    TEST_ASSERT_EQUAL_PTR(&A,MaquinaJerarquica_getEstado(&maquina));
+    TEST_ASSERT_TRUE(MaquinaJerarquica_enEstado(&maquina,&S1));
+    TEST_ASSERT_TRUE(MaquinaJerarquica_enEstado(&maquina,&RAIZ));
+    TEST_ASSERT_FALSE(MaquinaJerarquica_enEstado(&maquina,&S2));
+}
+
+static void test_transicion_entre_hermanos(void){
+    procesa(EV_A_B);
+    TEST_ASSERT_EQUAL_STRING("-A+B",traza);
+    TEST_ASSERT_EQUAL_PTR(&B,MaquinaJerarquica_getEstado(&maquina));
+}
+
+static void test_transicion_sale_hasta_ancestro_comun(void){
+    procesa(EV_A_C);
+    TEST_ASSERT_EQUAL_STRING("-A-S1-S+C",traza);
+    procesa(EV_NINGUNO);
+    TEST_ASSERT_EQUAL_STRING("",traza);
+    TEST_ASSERT_EQUAL_PTR(&C,MaquinaJerarquica_getEstado(&maquina));
+}
+
+static void test_transicion_a_si_mismo_sale_y_entra(void){
+    procesa(EV_A_B);
+    procesa(EV_B_B);
+    TEST_ASSERT_EQUAL_STRING("-B+B",traza);
+}
+
+static void test_evento_ignorado_sube_a_los_padres(void){
+    procesa(EV_DE_S);
+    TEST_ASSERT_EQUAL_STRING("!S",traza);
+    procesa(EV_DE_RAIZ);
+    TEST_ASSERT_EQUAL_STRING("!RAIZ",traza);
+    TEST_ASSERT_EQUAL_PTR(&A,MaquinaJerarquica_getEstado(&maquina));
+}
+
+static void test_transicion_desde_un_ancestro(void){
+    procesa(EV_A_B);
+    procesa(EV_S_S2);
+    TEST_ASSERT_EQUAL_STRING("-B-S1+S2",traza);
+    procesa(EV_DE_S);
+    TEST_ASSERT_EQUAL_STRING("!S",traza);
+}
+
+static void test_transicion_al_padre_entra_al_subestado_inicial(void){
+    procesa(EV_A_B);
+    procesa(EV_S1_S);
+    TEST_ASSERT_EQUAL_STRING("-B-S1+S1+A",traza);
+    TEST_ASSERT_EQUAL_PTR(&A,MaquinaJerarquica_getEstado(&maquina));
+}
+
+static void test_reset_no_ejecuta_salidas(void){
+    procesa(EV_A_C);
+    procesa(EV_RESET);
+    TEST_ASSERT_EQUAL_STRING("+RAIZ+S+S1+A",traza);
+}
+
+/**
+ * @brief Mide el costo de procesar un evento según cuántos niveles
+ * sube hasta el estado que lo procesa
+ *
+ * @return double Nanosegundos por evento
+ */
+static double costoPorEvento(Evento evento){
+    enum {EVENTOS = 1000000, REPETICIONES = 3};
+    Maquina *const m = MaquinaJerarquica_asMaquina(&maquina);
+    double minimo = 1e30;
+    for (size_t r=0;r<REPETICIONES;++r){
+        struct timespec t0,t1;
+        clock_gettime(CLOCK_MONOTONIC,&t0);
+        for (size_t i=0;i<EVENTOS;++i){
+            traza[0] = 0;
+            Maquina_despacha(m,evento);
+            Maquina_procesa(m);
+        }
+        clock_gettime(CLOCK_MONOTONIC,&t1);
+        double const ns = (t1.tv_sec - t0.tv_sec)*1e9 + (t1.tv_nsec - t0.tv_nsec);
+        if (ns < minimo) minimo = ns;
+    }
+    return minimo / EVENTOS;
+}
+
+static void test_costo_segun_profundidad(void){
+    procesa(EV_A_B);
+    double const hoja = costoPorEvento(EV_B_B);
+    double const abuelo = costoPorEvento(EV_DE_S);
+    double const raiz = costoPorEvento(EV_DE_RAIZ);
+    char mensaje[160];
+    snprintf(mensaje,sizeof(mensaje),"despacho+proceso: %.1f ns transicion en la hoja, %.1f ns evento del abuelo, %.1f ns evento de la raiz",
+             hoja,abuelo,raiz);
+    TEST_MESSAGE(mensaje);
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_reset_entra_siguiendo_subestados_iniciales);
+    RUN_TEST(test_transicion_entre_hermanos);
+    RUN_TEST(test_transicion_sale_hasta_ancestro_comun);
+    RUN_TEST(test_transicion_a_si_mismo_sale_y_entra);
+    RUN_TEST(test_evento_ignorado_sube_a_los_padres);
+    RUN_TEST(test_transicion_desde_un_ancestro);
+    RUN_TEST(test_transicion_al_padre_entra_al_subestado_inicial);
+    RUN_TEST(test_reset_no_ejecuta_salidas);
+    RUN_TEST(test_costo_segun_profundidad);
+    UNITY_END();
+    return 0;
+}
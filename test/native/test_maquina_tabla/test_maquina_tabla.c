@@ -0,0 +1,226 @@
+#include <maquina_tabla.h>
+#include <maquina_estado_impl.h>
+#include <soporte_placa_sim.h>
+#include <unity.h>
+#include <time.h>
+
+//Pruebas de la máquina de estado por tabla y comparación con la de funciones de estado
+
+enum {EV_X = EV_USUARIO, EV_Y, EV_Z, EV_FUERA_DE_TABLA};
+
+enum {A, B, C, NUM_ESTADOS};
+enum {CUENTA, REINICIA, NUM_ACCIONES};
+enum {NUM_EVENTOS = MT_EVENTO(EV_Z) + 1};
+
+/**
+ * @brief Máquina de prueba: recorre A -> B -> C -> A con EV_X, EV_Y
+ * y EV_Z, contando las transiciones
+ */
+typedef struct Ciclo{
+    MaquinaTabla maquina;
+    unsigned transiciones;
+    unsigned reinicios;
+}Ciclo;
+
+static void accionCuenta(Maquina *contexto, Evento evento){
+    (void)evento;
+    ((Ciclo*)contexto)->transiciones++;
+}
+
+static void accionReinicia(Maquina *contexto, Evento evento){
+    (void)evento;
+    ((Ciclo*)contexto)->reinicios++;
+}
+
+static MaquinaTabla_Accion const acciones[NUM_ACCIONES] = {
+    [CUENTA] = accionCuenta,
+    [REINICIA] = accionReinicia,
+};
+
+static MaquinaTabla_Transicion const transiciones[NUM_ESTADOS][NUM_EVENTOS] = {
+    [A] = {
+        [MT_EVENTO(EV_RESET)] = MT_ACCION(REINICIA),
+        [MT_EVENTO(EV_X)] = MT_TRANSICION(CUENTA,B),
+    },
+    [B] = {
+        [MT_EVENTO(EV_Y)] = MT_TRANSICION(CUENTA,C),
+    },
+    [C] = {
+        [MT_EVENTO(EV_Z)] = MT_TRANSICION(CUENTA,A),
+        [MT_EVENTO(EV_X)] = MT_SALTO(B),
+    },
+};
+
+static MaquinaTabla_Definicion const definicion = {
+    .transiciones = &transiciones[0][0],
+    .acciones = acciones,
+    .numEventos = NUM_EVENTOS,
+    .estadoInicial = A,
+};
+
+static Ciclo ciclo;
+
+static void procesaTodo(Maquina *maquina){
+    while(Maquina_procesa(maquina));
+}
+
+void setUp(void){
+    SP_Sim_reset();
+    ciclo = (Ciclo){0};
+    MaquinaTabla_init(&ciclo.maquina,&definicion);
+    procesaTodo(MaquinaTabla_asMaquina(&ciclo.maquina));
+}
+void tearDown(void){
+
+}
+
+static void test_reset_ejecuta_celda_del_estado_inicial(void){
+    TEST_ASSERT_EQUAL(1,ciclo.reinicios);
+    TEST_ASSERT_EQUAL(A,MaquinaTabla_getEstado(&ciclo.maquina));
+}
+
+static void test_transiciones_ejecutan_accion_y_cambian_estado(void){
+    Maquina *const m = MaquinaTabla_asMaquina(&ciclo.maquina);
+    Maquina_despacha(m,EV_X);
+    procesaTodo(m);
+    TEST_ASSERT_EQUAL(B,MaquinaTabla_getEstado(&ciclo.maquina));
+    Maquina_despacha(m,EV_Y);
+    Maquina_despacha(m,EV_Z);
+    procesaTodo(m);
+    TEST_ASSERT_EQUAL(A,MaquinaTabla_getEstado(&ciclo.maquina));
+    TEST_ASSERT_EQUAL(3,ciclo.transiciones);
+}
+
+static void test_salto_sin_accion(void){
+    Maquina *const m = MaquinaTabla_asMaquina(&ciclo.maquina);
+    Maquina_despacha(m,EV_X);
+    Maquina_despacha(m,EV_Y);
+    Maquina_despacha(m,EV_X);
+    procesaTodo(m);
+    TEST_ASSERT_EQUAL(B,MaquinaTabla_getEstado(&ciclo.maquina));
+    TEST_ASSERT_EQUAL(2,ciclo.transiciones);
+}
+
+static void test_eventos_ignorados(void){
+    Maquina *const m = MaquinaTabla_asMaquina(&ciclo.maquina);
+    Maquina_despacha(m,EV_Y);
+    Maquina_despacha(m,EV_FUERA_DE_TABLA);
+    procesaTodo(m);
+    TEST_ASSERT_EQUAL(A,MaquinaTabla_getEstado(&ciclo.maquina));
+    TEST_ASSERT_EQUAL(0,ciclo.transiciones);
+}
+
+static void test_reset_vuelve_al_estado_inicial(void){
+    Maquina *const m = MaquinaTabla_asMaquina(&ciclo.maquina);
+    Maquina_despacha(m,EV_X);
+    Maquina_despacha(m,EV_RESET);
+    procesaTodo(m);
+    TEST_ASSERT_EQUAL(A,MaquinaTabla_getEstado(&ciclo.maquina));
+    TEST_ASSERT_EQUAL(2,ciclo.reinicios);
+}
+
+/* La misma máquina con una función por estado */
+
+typedef struct CicloFunciones{
+    Maquina maquina;
+    unsigned transiciones;
+}CicloFunciones;
+
+static Resultado estadoA(Maquina *contexto, Evento evento);
+static Resultado estadoB(Maquina *contexto, Evento evento);
+static Resultado estadoC(Maquina *contexto, Evento evento);
+
+static Resultado estadoA(Maquina *contexto, Evento evento){
+    CicloFunciones *const self = (CicloFunciones*)contexto;
+    Resultado r = {0};
+    switch (evento){
+    case EV_RESET:
+        r = Resultado_procesado();
+    break;case EV_X:
+        self->transiciones++;
+        r = Resultado_transicion(estadoB);
+    break;default:
+        r = Resultado_ignorado();
+    break;
+    }
+    return r;
+}
+
+static Resultado estadoB(Maquina *contexto, Evento evento){
+    CicloFunciones *const self = (CicloFunciones*)contexto;
+    Resultado r = {0};
+    switch (evento){
+    case EV_Y:
+        self->transiciones++;
+        r = Resultado_transicion(estadoC);
+    break;default:
+        r = Resultado_ignorado();
+    break;
+    }
+    return r;
+}
+
+static Resultado estadoC(Maquina *contexto, Evento evento){
+    CicloFunciones *const self = (CicloFunciones*)contexto;
+    Resultado r = {0};
+    switch (evento){
+    case EV_Z:
+        self->transiciones++;
+        r = Resultado_transicion(estadoA);
+    break;case EV_X:
+        r = Resultado_transicion(estadoB);
+    break;default:
+        r = Resultado_ignorado();
+    break;
+    }
+    return r;
+}
+
+/**
+ * @brief Mide el costo de despachar y procesar eventos que recorren
+ * el ciclo completo
+ *
+ * @return double Nanosegundos por evento
+ */
+static double costoPorEvento(Maquina *m){
+    enum {VUELTAS = 1000000, REPETICIONES = 3};
+    double minimo = 1e30;
+    procesaTodo(m);
+    for (size_t r=0;r<REPETICIONES;++r){
+        struct timespec t0,t1;
+        clock_gettime(CLOCK_MONOTONIC,&t0);
+        for (size_t i=0;i<VUELTAS;++i){
+            Maquina_despacha(m,EV_X);
+            Maquina_despacha(m,EV_Y);
+            Maquina_despacha(m,EV_Z);
+            procesaTodo(m);
+        }
+        clock_gettime(CLOCK_MONOTONIC,&t1);
+        double const ns = (t1.tv_sec - t0.tv_sec)*1e9 + (t1.tv_nsec - t0.tv_nsec);
+        if (ns < minimo) minimo = ns;
+    }
+    return minimo / (3.0*VUELTAS);
+}
+
+static void test_costo_tabla_vs_funciones(void){
+    static CicloFunciones cicloFunciones;
+    Maquina_init(&cicloFunciones.maquina,estadoA);
+    double const funciones = costoPorEvento(&cicloFunciones.maquina);
+    double const tabla = costoPorEvento(MaquinaTabla_asMaquina(&ciclo.maquina));
+    TEST_ASSERT_EQUAL(ciclo.transiciones,cicloFunciones.transiciones);
+    char mensaje[128];
+    snprintf(mensaje,sizeof(mensaje),"funciones de estado: %.1f ns por evento, tabla: %.1f ns por evento",funciones,tabla);
+    TEST_MESSAGE(mensaje);
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_reset_ejecuta_celda_del_estado_inicial);
+    RUN_TEST(test_transiciones_ejecutan_accion_y_cambian_estado);
+    RUN_TEST(test_salto_sin_accion);
+    RUN_TEST(test_eventos_ignorados);
+    RUN_TEST(test_reset_vuelve_al_estado_inicial);
+    RUN_TEST(test_costo_tabla_vs_funciones);
+    UNITY_END();
+    return 0;
+}
@@ -0,0 +1,391 @@
+#include <planificador.h>
+#include <maquina_estado_impl.h>
+#include <soporte_placa_sim.h>
+#include <unity.h>
+#include <time.h>
+
+//Pruebas del planificador por prioridades
+
+enum {EV_PRUEBA = EV_USUARIO, EV_REENVIA, EV_INTERRUPCION, NUM_MAQUINAS = 16, MAX_REGISTRO = 64};
+
+/**
+ * @brief Marca registrada al terminar de procesar EV_REENVIA o
+ * EV_INTERRUPCION (FIN + número de receptor)
+ */
+enum {FIN = 100};
+
+#define PIN_INTERRUPCION SP_PB9
+
+typedef struct Receptor{
+    Maquina maquina;
+    unsigned numero;
+    Maquina *reenvio;       //Destino de EV_REENVIA
+}Receptor;
+
+static Receptor receptores[NUM_MAQUINAS];
+static Planificador planificador;
+
+/**
+ * @brief Orden en que se procesaron los eventos (número de receptor)
+ */
+static struct{
+    unsigned orden[MAX_REGISTRO];
+    unsigned n;
+}registro;
+
+static void registra(unsigned valor){
+    if (registro.n < MAX_REGISTRO) registro.orden[registro.n++] = valor;
+}
+
+static Resultado estadoRegistra(Maquina *contexto, Evento evento){
+    Receptor *const self = (Receptor*)contexto;
+    if (evento != EV_RESET) registra(self->numero);
+    switch (evento){
+    case EV_REENVIA:
+        Maquina_despacha(self->reenvio,EV_PRUEBA);
+        registra(FIN + self->numero);
+    break;case EV_INTERRUPCION:
+        SP_Sim_Pin_setEntrada(PIN_INTERRUPCION,0);      //Dispara la interrupción en medio de la acción
+        SP_Sim_Pin_setEntrada(PIN_INTERRUPCION,1);
+        registra(FIN + self->numero);
+    break;default:
+    break;
+    }
+    return Resultado_procesado();
+}
+
+static void reiniciaReceptores(Estado estado){
+    for (unsigned i=0;i<NUM_MAQUINAS;++i){
+        receptores[i] = (Receptor){.numero = i};
+        Maquina_init(&receptores[i].maquina,estado);
+        Maquina_procesa(&receptores[i].maquina);
+    }
+}
+
+void setUp(void){
+    SP_Sim_reset();
+    registro.n = 0;
+    Planificador_init(&planificador);
+    reiniciaReceptores(estadoRegistra);
+}
+void tearDown(void){
+
+}
+
+static void procesaTodo(void){
+    while (Planificador_procesa(&planificador));
+}
+
+static void test_registro_valida_prioridad(void){
+    TEST_ASSERT_TRUE(Planificador_registra(&planificador,&receptores[0].maquina,5));
+    TEST_ASSERT_FALSE(Planificador_registra(&planificador,&receptores[1].maquina,5));
+    TEST_ASSERT_FALSE(Planificador_registra(&planificador,&receptores[1].maquina,PLANIFICADOR_NUM_PRIORIDADES));
+    TEST_ASSERT_TRUE(Planificador_registra(&planificador,&receptores[1].maquina,PLANIFICADOR_NUM_PRIORIDADES - 1));
+}
+
+static void test_maquina_con_reset_pendiente_queda_lista(void){
+    Receptor nuevo = {.numero = 99};
+    Maquina_init(&nuevo.maquina,estadoRegistra);
+    Planificador_registra(&planificador,&nuevo.maquina,0);
+    TEST_ASSERT_TRUE(Planificador_hayListas(&planificador));
+    TEST_ASSERT_TRUE(Planificador_procesa(&planificador));
+    TEST_ASSERT_FALSE(Planificador_hayListas(&planificador));
+    TEST_ASSERT_FALSE(Planificador_procesa(&planificador));
+}
+
+static void test_procesa_por_orden_de_prioridad(void){
+    Planificador_registra(&planificador,&receptores[0].maquina,3);
+    Planificador_registra(&planificador,&receptores[1].maquina,31);
+    Planificador_registra(&planificador,&receptores[2].maquina,0);
+    Maquina_despacha(&receptores[0].maquina,EV_PRUEBA);
+    Maquina_despacha(&receptores[2].maquina,EV_PRUEBA);
+    Maquina_despacha(&receptores[0].maquina,EV_PRUEBA);
+    Maquina_despacha(&receptores[1].maquina,EV_PRUEBA);
+    procesaTodo();
+    TEST_ASSERT_EQUAL(4,registro.n);
+    TEST_ASSERT_EQUAL(1,registro.orden[0]);
+    TEST_ASSERT_EQUAL(0,registro.orden[1]);
+    TEST_ASSERT_EQUAL(0,registro.orden[2]);
+    TEST_ASSERT_EQUAL(2,registro.orden[3]);
+    TEST_ASSERT_FALSE(Planificador_hayListas(&planificador));
+}
+
+static void test_evento_generado_a_mayor_prioridad_se_adelanta(void){
+    Planificador_registra(&planificador,&receptores[0].maquina,1);
+    Planificador_registra(&planificador,&receptores[1].maquina,2);
+    receptores[0].reenvio = &receptores[1].maquina;
+    Maquina_despacha(&receptores[0].maquina,EV_REENVIA);
+    Maquina_despacha(&receptores[0].maquina,EV_PRUEBA);
+    procesaTodo();
+    TEST_ASSERT_EQUAL(4,registro.n);
+    TEST_ASSERT_EQUAL(0,registro.orden[0]);
+    TEST_ASSERT_EQUAL(FIN + 0,registro.orden[1]);
+    TEST_ASSERT_EQUAL(1,registro.orden[2]);
+    TEST_ASSERT_EQUAL(0,registro.orden[3]);
+}
+
+/* Modo expropiativo */
+
+static void rutinaExpropiacion(void){
+    Planificador_expropia(&planificador);
+}
+
+static void iniciaExpropiativo(void){
+    SP_Expropiacion_init(rutinaExpropiacion);
+    Planificador_initExpropiativo(&planificador,SP_Expropiacion_solicita);
+}
+
+static void despachaDesdeInterrupcion(void volatile *param){
+    Maquina_despacha((Maquina*)param,EV_PRUEBA);
+}
+
+static void test_expropiativo_despacho_a_mayor_prioridad_expropia(void){
+    iniciaExpropiativo();
+    Planificador_registra(&planificador,&receptores[0].maquina,1);
+    Planificador_registra(&planificador,&receptores[1].maquina,2);
+    receptores[0].reenvio = &receptores[1].maquina;
+    Maquina_despacha(&receptores[0].maquina,EV_REENVIA);
+    TEST_ASSERT_EQUAL(3,registro.n);
+    TEST_ASSERT_EQUAL(0,registro.orden[0]);
+    TEST_ASSERT_EQUAL(1,registro.orden[1]);
+    TEST_ASSERT_EQUAL(FIN + 0,registro.orden[2]);
+    TEST_ASSERT_FALSE(Planificador_hayListas(&planificador));
+}
+
+static void test_expropiativo_despacho_a_menor_prioridad_espera(void){
+    iniciaExpropiativo();
+    Planificador_registra(&planificador,&receptores[0].maquina,1);
+    Planificador_registra(&planificador,&receptores[1].maquina,2);
+    receptores[1].reenvio = &receptores[0].maquina;
+    Maquina_despacha(&receptores[1].maquina,EV_REENVIA);
+    TEST_ASSERT_EQUAL(3,registro.n);
+    TEST_ASSERT_EQUAL(1,registro.orden[0]);
+    TEST_ASSERT_EQUAL(FIN + 1,registro.orden[1]);
+    TEST_ASSERT_EQUAL(0,registro.orden[2]);
+}
+
+static void test_expropiativo_interrupcion_expropia_al_terminar(void){
+    iniciaExpropiativo();
+    Planificador_registra(&planificador,&receptores[0].maquina,1);
+    Planificador_registra(&planificador,&receptores[1].maquina,2);
+    SP_Pin_setModo(PIN_INTERRUPCION,SP_PIN_ENTRADA);
+    SP_Sim_Pin_setEntrada(PIN_INTERRUPCION,1);
+    SP_Pin_setInterrupcion(PIN_INTERRUPCION,SP_PIN_INT_FLANCO_DESCENDENTE,despachaDesdeInterrupcion,&receptores[1].maquina);
+    uint32_t const ejecuciones = SP_Sim_Expropiacion_getEjecuciones();
+    Maquina_despacha(&receptores[0].maquina,EV_INTERRUPCION);
+    TEST_ASSERT_EQUAL(3,registro.n);
+    TEST_ASSERT_EQUAL(0,registro.orden[0]);
+    TEST_ASSERT_EQUAL(1,registro.orden[1]);
+    TEST_ASSERT_EQUAL(FIN + 0,registro.orden[2]);
+    TEST_ASSERT_EQUAL(ejecuciones + 2,SP_Sim_Expropiacion_getEjecuciones());
+}
+
+static void test_expropiativo_bloqueo_difiere_hasta_desbloquear(void){
+    iniciaExpropiativo();
+    Planificador_registra(&planificador,&receptores[0].maquina,1);
+    Planificador_registra(&planificador,&receptores[1].maquina,2);
+    uint32_t const nivel = Planificador_bloquea(&planificador,1);
+    Maquina_despacha(&receptores[0].maquina,EV_PRUEBA);
+    Maquina_despacha(&receptores[1].maquina,EV_PRUEBA);
+    TEST_ASSERT_EQUAL(1,registro.n);
+    TEST_ASSERT_EQUAL(1,registro.orden[0]);
+    Planificador_desbloquea(&planificador,nivel);
+    TEST_ASSERT_EQUAL(2,registro.n);
+    TEST_ASSERT_EQUAL(0,registro.orden[1]);
+}
+
+static double segundos(void){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC,&t);
+    return t.tv_sec + t.tv_nsec*1e-9;
+}
+
+enum {DURACION_ACCION_US = 200};
+
+static double inicioLatencia;
+static double latenciaMaxima;
+
+static void despachaYMarca(void volatile *param){
+    inicioLatencia = segundos();
+    Maquina_despacha((Maquina*)param,EV_PRUEBA);
+}
+
+/**
+ * @brief Acción larga: espera DURACION_ACCION_US y a la mitad
+ * dispara la interrupción
+ */
+static Resultado estadoAccionLarga(Maquina *contexto, Evento evento){
+    (void)contexto;
+    if (evento != EV_RESET){
+        double const inicio = segundos();
+        bool disparada = false;
+        while (segundos() - inicio < DURACION_ACCION_US*1e-6){
+            if (!disparada && segundos() - inicio > DURACION_ACCION_US*0.5e-6){
+                disparada = true;
+                SP_Sim_Pin_setEntrada(PIN_INTERRUPCION,0);
+                SP_Sim_Pin_setEntrada(PIN_INTERRUPCION,1);
+            }
+        }
+    }
+    return Resultado_procesado();
+}
+
+static Resultado estadoMideLatencia(Maquina *contexto, Evento evento){
+    (void)contexto;
+    if (evento != EV_RESET){
+        double const latencia = segundos() - inicioLatencia;
+        if (latencia > latenciaMaxima) latenciaMaxima = latencia;
+    }
+    return Resultado_procesado();
+}
+
+/**
+ * @brief Peor latencia entre el despacho desde una interrupción a la
+ * máquina más prioritaria y el comienzo de su procesamiento, mientras
+ * una máquina menos prioritaria ejecuta una acción larga
+ *
+ * @return double Microsegundos
+ */
+static double peorLatencia(bool expropiativo){
+    enum {MUESTRAS = 50};
+    if (expropiativo) iniciaExpropiativo();
+    else Planificador_init(&planificador);
+    Maquina_init(&receptores[0].maquina,estadoAccionLarga);
+    Maquina_init(&receptores[1].maquina,estadoMideLatencia);
+    Planificador_registra(&planificador,&receptores[0].maquina,1);
+    Planificador_registra(&planificador,&receptores[1].maquina,2);
+    procesaTodo();
+    SP_Pin_resetInterrupcion(PIN_INTERRUPCION);
+    SP_Pin_setModo(PIN_INTERRUPCION,SP_PIN_ENTRADA);
+    SP_Sim_Pin_setEntrada(PIN_INTERRUPCION,1);
+    SP_Pin_setInterrupcion(PIN_INTERRUPCION,SP_PIN_INT_FLANCO_DESCENDENTE,despachaYMarca,&receptores[1].maquina);
+    latenciaMaxima = 0;
+    for (size_t i=0;i<MUESTRAS;++i){
+        Maquina_despacha(&receptores[0].maquina,EV_PRUEBA);
+        procesaTodo();
+    }
+    return latenciaMaxima*1e6;
+}
+
+static void test_latencia_con_accion_larga(void){
+    double const cooperativo = peorLatencia(false);
+    double const expropiativo = peorLatencia(true);
+    TEST_ASSERT_LESS_THAN(cooperativo,expropiativo);
+    char mensaje[160];
+    snprintf(mensaje,sizeof(mensaje),"peor latencia de interrupcion a maquina prioritaria, accion de %u us en curso: cooperativo %.1f us, expropiativo %.1f us",
+             DURACION_ACCION_US,cooperativo,expropiativo);
+    TEST_MESSAGE(mensaje);
+}
+
+static Resultado estadoNulo(Maquina *contexto, Evento evento){
+    (void)contexto;
+    (void)evento;
+    return Resultado_procesado();
+}
+
+static void despachaRafaga(unsigned rafaga){
+    for (unsigned j=0;j<rafaga;++j){
+        Maquina_despacha(&receptores[j % NUM_MAQUINAS].maquina,EV_PRUEBA);
+    }
+}
+
+/**
+ * @brief Mide el costo por evento de procesar una ráfaga repartida
+ * entre las primeras máquinas, con el lazo anterior (un Maquina_procesa
+ * por máquina y pasada, hasta vaciar las colas) o con el planificador
+ *
+ * @return double Nanosegundos por evento
+ */
+static double costoPorEvento(unsigned rafaga, bool conPlanificador){
+    enum {RAFAGAS = 200000, REPETICIONES = 3};
+    double minimo = 1e30;
+    for (size_t r=0;r<REPETICIONES;++r){
+        struct timespec t0,t1;
+        clock_gettime(CLOCK_MONOTONIC,&t0);
+        for (size_t i=0;i<RAFAGAS;++i){
+            despachaRafaga(rafaga);
+            if (conPlanificador){
+                procesaTodo();
+            }else{
+                bool procesado;
+                do{
+                    procesado = false;
+                    for (unsigned j=0;j<NUM_MAQUINAS;++j){
+                        procesado |= Maquina_procesa(&receptores[j].maquina);
+                    }
+                }while(procesado);
+            }
+        }
+        clock_gettime(CLOCK_MONOTONIC,&t1);
+        double const ns = (t1.tv_sec - t0.tv_sec)*1e9 + (t1.tv_nsec - t0.tv_nsec);
+        if (ns < minimo) minimo = ns;
+    }
+    return minimo / ((double)RAFAGAS * rafaga);
+}
+
+/**
+ * @brief Cuántos eventos de máquinas menos prioritarias se procesan
+ * antes del evento de la máquina más prioritaria, despachado último
+ * en una ráfaga, con el lazo anterior o con el planificador
+ */
+static unsigned esperaDelMasPrioritario(unsigned rafaga, bool conPlanificador){
+    registro.n = 0;
+    despachaRafaga(rafaga);
+    Maquina_despacha(&receptores[NUM_MAQUINAS - 1].maquina,EV_PRUEBA);
+    if (conPlanificador){
+        Planificador_procesa(&planificador);
+    }else{
+        for (unsigned j=0;j<NUM_MAQUINAS;++j){
+            if (Maquina_procesa(&receptores[j].maquina) && j == NUM_MAQUINAS - 1) break;
+        }
+    }
+    unsigned espera = 0;
+    while (espera < registro.n && registro.orden[espera] != NUM_MAQUINAS - 1) ++espera;
+    procesaTodo();
+    for (unsigned j=0;j<NUM_MAQUINAS;++j) while(Maquina_procesa(&receptores[j].maquina));
+    return espera;
+}
+
+static void registraReceptores(void){
+    Planificador_init(&planificador);
+    for (unsigned i=0;i<NUM_MAQUINAS;++i){
+        Planificador_registra(&planificador,&receptores[i].maquina,i);
+    }
+}
+
+static void test_costo_y_latencia_en_rafagas(void){
+    char mensaje[160];
+    registraReceptores();
+    unsigned const esperaLazo = esperaDelMasPrioritario(NUM_MAQUINAS - 1,false);
+    unsigned const esperaPlanificador = esperaDelMasPrioritario(NUM_MAQUINAS - 1,true);
+    TEST_ASSERT_EQUAL(0,esperaPlanificador);
+    snprintf(mensaje,sizeof(mensaje),"evento de mayor prioridad tras una rafaga a %u maquinas: espera %u eventos con el lazo, %u con el planificador",
+             NUM_MAQUINAS - 1,esperaLazo,esperaPlanificador);
+    TEST_MESSAGE(mensaje);
+    static unsigned const rafagas[] = {1,4,16};
+    for (size_t i=0;i<3;++i){
+        reiniciaReceptores(estadoNulo);
+        double const lazo = costoPorEvento(rafagas[i],false);
+        registraReceptores();
+        double const conPlanificador = costoPorEvento(rafagas[i],true);
+        snprintf(mensaje,sizeof(mensaje),"rafaga de %2u eventos, %u maquinas: %.1f ns por evento con el lazo, %.1f ns con el planificador",
+                 rafagas[i],NUM_MAQUINAS,lazo,conPlanificador);
+        TEST_MESSAGE(mensaje);
+    }
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_registro_valida_prioridad);
+    RUN_TEST(test_maquina_con_reset_pendiente_queda_lista);
+    RUN_TEST(test_procesa_por_orden_de_prioridad);
+    RUN_TEST(test_evento_generado_a_mayor_prioridad_se_adelanta);
+    RUN_TEST(test_expropiativo_despacho_a_mayor_prioridad_expropia);
+    RUN_TEST(test_expropiativo_despacho_a_menor_prioridad_espera);
+    RUN_TEST(test_expropiativo_interrupcion_expropia_al_terminar);
+    RUN_TEST(test_expropiativo_bloqueo_difiere_hasta_desbloquear);
+    RUN_TEST(test_latencia_con_accion_larga);
+    RUN_TEST(test_costo_y_latencia_en_rafagas);
+    UNITY_END();
+    return 0;
+}
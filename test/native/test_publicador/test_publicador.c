@@ -0,0 +1,143 @@
+#include <publicador.h>
+#include <maquina_estado_impl.h>
+#include <soporte_placa_sim.h>
+#include <unity.h>
+#include <time.h>
+
+//Pruebas de la publicación de eventos a varias máquinas suscriptas
+
+enum {EV_PRUEBA = EV_USUARIO, EV_OTRO, NUM_MAQUINAS = PLANIFICADOR_NUM_PRIORIDADES};
+
+typedef struct Receptor{
+    Maquina maquina;
+    unsigned recibidos;
+}Receptor;
+
+static Receptor receptores[NUM_MAQUINAS];
+static Planificador planificador;
+static Publicador publicador;
+
+static Resultado estadoCuenta(Maquina *contexto, Evento evento){
+    Receptor *const self = (Receptor*)contexto;
+    if (evento != EV_RESET) ++self->recibidos;
+    return Resultado_procesado();
+}
+
+void setUp(void){
+    SP_Sim_reset();
+    Planificador_init(&planificador);
+    for (unsigned i=0;i<NUM_MAQUINAS;++i){
+        receptores[i] = (Receptor){0};
+        Maquina_init(&receptores[i].maquina,estadoCuenta);
+        Maquina_procesa(&receptores[i].maquina);
+        Planificador_registra(&planificador,&receptores[i].maquina,i);
+    }
+    Publicador_init(&publicador,&planificador);
+}
+void tearDown(void){
+
+}
+
+static void procesaTodo(void){
+    while (Planificador_procesa(&planificador));
+}
+
+static void test_publica_a_todos_los_suscriptores_en_una_seccion(void){
+    static unsigned const suscriptos[] = {3,7,30};
+    for (size_t i=0;i<3;++i){
+        TEST_ASSERT_TRUE(Publicador_suscribe(&publicador,EV_PRUEBA,&receptores[suscriptos[i]].maquina));
+    }
+    SP_Sim_reiniciaBloqueos();
+    TEST_ASSERT_EQUAL_HEX32(0x40000088,Publicador_publica(&publicador,EV_PRUEBA));
+    TEST_ASSERT_EQUAL(1,SP_Sim_getBloqueos().secciones);
+    TEST_ASSERT_TRUE(SP_Sim_qInterrupcionesHabilitadas());
+    TEST_ASSERT_EQUAL(0,Publicador_publica(&publicador,EV_OTRO));      //Sin suscriptores
+    procesaTodo();
+    for (unsigned i=0;i<NUM_MAQUINAS;++i){
+        bool const suscripto = (i == 3 || i == 7 || i == 30);
+        TEST_ASSERT_EQUAL(suscripto ? 1 : 0,receptores[i].recibidos);
+    }
+}
+
+static void test_cola_llena_falta_en_los_entregados(void){
+    Publicador_suscribe(&publicador,EV_PRUEBA,&receptores[1].maquina);
+    Publicador_suscribe(&publicador,EV_PRUEBA,&receptores[2].maquina);
+    for (unsigned i=0;i<MAX_EV_COLA;++i){
+        TEST_ASSERT_TRUE(Maquina_despacha(&receptores[2].maquina,EV_OTRO));
+    }
+    TEST_ASSERT_EQUAL_HEX32(0x2,Publicador_publica(&publicador,EV_PRUEBA));
+    procesaTodo();
+    TEST_ASSERT_EQUAL(1,receptores[1].recibidos);
+    TEST_ASSERT_EQUAL(MAX_EV_COLA,receptores[2].recibidos);
+}
+
+static void test_suscripciones_invalidas_y_desuscripcion(void){
+    Maquina ajena;
+    Maquina_init(&ajena,estadoCuenta);
+    TEST_ASSERT_FALSE(Publicador_suscribe(&publicador,EV_PRUEBA,&ajena));
+    TEST_ASSERT_FALSE(Publicador_suscribe(&publicador,PUBLICADOR_NUM_EVENTOS,&receptores[0].maquina));
+    TEST_ASSERT_FALSE(Publicador_suscribe(&publicador,EV_NULO,&receptores[0].maquina));
+    TEST_ASSERT_TRUE(Publicador_suscribe(&publicador,EV_PRUEBA,&receptores[5].maquina));
+    TEST_ASSERT_TRUE(Publicador_desuscribe(&publicador,EV_PRUEBA,&receptores[5].maquina));
+    TEST_ASSERT_FALSE(Publicador_desuscribe(&publicador,EV_PRUEBA,&receptores[5].maquina));
+    TEST_ASSERT_EQUAL(0,Publicador_getSuscriptores(&publicador,EV_PRUEBA));
+    TEST_ASSERT_EQUAL(0,Publicador_publica(&publicador,EV_PRUEBA));
+}
+
+enum {TANDAS = 20000, REPETICIONES = 3};
+
+/**
+ * @brief Nanosegundos por evento entregado a n suscriptores, con una
+ * publicación o con n llamadas a Maquina_despacha. Cada tanda llena
+ * las colas y se vacían fuera de la medición
+ */
+static double costoEntrega(unsigned n, bool publicando){
+    double minimo = 1e30;
+    for (size_t r=0;r<REPETICIONES;++r){
+        double ns = 0;
+        for (size_t t=0;t<TANDAS;++t){
+            struct timespec t0,t1;
+            clock_gettime(CLOCK_MONOTONIC,&t0);
+            for (unsigned e=0;e<MAX_EV_COLA;++e){
+                if (publicando){
+                    Publicador_publica(&publicador,EV_PRUEBA);
+                }else{
+                    for (unsigned i=0;i<n;++i) Maquina_despacha(&receptores[i].maquina,EV_PRUEBA);
+                }
+            }
+            clock_gettime(CLOCK_MONOTONIC,&t1);
+            ns += (t1.tv_sec - t0.tv_sec)*1e9 + (t1.tv_nsec - t0.tv_nsec);
+            procesaTodo();
+        }
+        if (ns < minimo) minimo = ns;
+    }
+    return minimo / ((double)TANDAS*MAX_EV_COLA);
+}
+
+static void test_costo_segun_suscriptores(void){
+    static unsigned const cantidades[] = {1,2,4,8,16,32};
+    for (size_t c=0;c<sizeof(cantidades)/sizeof(*cantidades);++c){
+        unsigned const n = cantidades[c];
+        for (unsigned i=0;i<n;++i) Publicador_suscribe(&publicador,EV_PRUEBA,&receptores[i].maquina);
+        double const despachando = costoEntrega(n,false);
+        SP_Sim_reiniciaBloqueos();
+        double const publicando = costoEntrega(n,true);
+        TEST_ASSERT_EQUAL_UINT32(REPETICIONES*TANDAS*MAX_EV_COLA,SP_Sim_getBloqueos().secciones);   //Una sección por publicación
+        for (unsigned i=0;i<n;++i) TEST_ASSERT_EQUAL(2*REPETICIONES*TANDAS*MAX_EV_COLA,receptores[i].recibidos);
+        for (unsigned i=0;i<n;++i) receptores[i].recibidos = 0;
+        char mensaje[160];
+        snprintf(mensaje,sizeof(mensaje),"%2u suscriptores: %.1f ns por publicacion, %.1f ns con %u llamadas a Maquina_despacha",
+                 n,publicando,despachando,n);
+        TEST_MESSAGE(mensaje);
+    }
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_publica_a_todos_los_suscriptores_en_una_seccion);
+    RUN_TEST(test_cola_llena_falta_en_los_entregados);
+    RUN_TEST(test_suscripciones_invalidas_y_desuscripcion);
+    RUN_TEST(test_costo_segun_suscriptores);
+    UNITY_END();
+    return 0;
+}
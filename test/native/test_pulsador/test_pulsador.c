@@ -0,0 +1,136 @@
+#include <pulsador.h>
+#include <maquina_estado_impl.h>
+#include <soporte_placa_sim.h>
+#include <unity.h>
+
+//Pruebas del antirrebote del pulsador, por sondeo y por interrupción
+
+enum {EV_PULSADO = EV_USUARIO, HISTERESIS = 5};
+enum {SEGUNDOS_MEDICION = 10};
+
+#define PIN SP_PB9
+
+typedef struct Receptor{
+    Maquina maquina;
+    unsigned pulsaciones;
+}Receptor;
+
+static Receptor receptor;
+static Pulsador pulsador;
+
+static Resultado estadoCuenta(Maquina *contexto, Evento evento){
+    Receptor *const self = (Receptor*)contexto;
+    if (evento == EV_PULSADO) ++self->pulsaciones;
+    return Resultado_procesado();
+}
+
+/**
+ * @brief Avanza el reloj de a un milisegundo procesando el pulsador
+ * y los eventos recibidos
+ *
+ */
+static void ejecuta(uint32_t milisegundos){
+    for (uint32_t i=0;i<milisegundos;++i){
+        SP_Sim_Tiempo_avanza(1);
+        Pulsador_procesa(&pulsador);
+        while(Maquina_procesa(&receptor.maquina));
+    }
+}
+
+static void pulsa(void){
+    SP_Sim_Pin_setEntrada(PIN,0);
+    ejecuta(50);
+    SP_Sim_Pin_setEntrada(PIN,1);
+    ejecuta(50);
+}
+
+void setUp(void){
+    SP_Sim_reset();
+    receptor = (Receptor){0};
+    Maquina_init(&receptor.maquina,estadoCuenta);
+    Maquina_procesa(&receptor.maquina);
+    Pulsador_init(&pulsador,&receptor.maquina,EV_PULSADO,PIN,0,HISTERESIS);
+}
+void tearDown(void){
+
+}
+
+static void test_sondeo_detecta_pulsacion(void){
+    ejecuta(100);
+    pulsa();
+    TEST_ASSERT_EQUAL(1,receptor.pulsaciones);
+}
+
+static void test_interrupcion_detecta_pulsacion(void){
+    TEST_ASSERT_TRUE(Pulsador_habilitaDespertar(&pulsador));
+    ejecuta(100);
+    pulsa();
+    pulsa();
+    TEST_ASSERT_EQUAL(2,receptor.pulsaciones);
+}
+
+static void test_interrupcion_filtra_rebotes(void){
+    TEST_ASSERT_TRUE(Pulsador_habilitaDespertar(&pulsador));
+    ejecuta(100);
+    for (size_t i=0;i<4;++i){
+        SP_Sim_Pin_setEntrada(PIN,0);
+        ejecuta(1);
+        SP_Sim_Pin_setEntrada(PIN,1);
+        ejecuta(1);
+    }
+    pulsa();
+    TEST_ASSERT_EQUAL(1,receptor.pulsaciones);
+}
+
+static void test_interrupcion_no_lee_el_pin_en_reposo(void){
+    TEST_ASSERT_TRUE(Pulsador_habilitaDespertar(&pulsador));
+    ejecuta(10000);
+    TEST_ASSERT_EQUAL_UINT32(0,SP_Sim_Pin_getLecturas());
+    TEST_ASSERT_EQUAL_UINT32(SP_TIEMPO_INDEFINIDO,Pulsador_tiempoHastaProximaLectura(&pulsador));
+    pulsa();
+    uint32_t const lecturas = SP_Sim_Pin_getLecturas();
+    TEST_ASSERT_TRUE(lecturas <= 2*(HISTERESIS + 1));
+    ejecuta(10000);
+    TEST_ASSERT_EQUAL_UINT32(lecturas,SP_Sim_Pin_getLecturas());
+}
+
+/**
+ * @brief Cuenta las lecturas del pin por segundo simulado sin
+ * pulsaciones, llamando a Pulsador_procesa en cada milisegundo. Cada
+ * lectura es una vuelta completa del antirrebote: en la placa, el
+ * trabajo que el pulsador le cuesta al lazo principal en reposo
+ *
+ * @return uint32_t Lecturas del pin por segundo simulado
+ */
+static uint32_t lecturasPorSegundoEnReposo(void){
+    uint32_t const lecturas = SP_Sim_Pin_getLecturas();
+    for (uint32_t i=0;i<SEGUNDOS_MEDICION*1000;++i){
+        SP_Sim_Tiempo_avanza(1);
+        Pulsador_procesa(&pulsador);
+    }
+    return (SP_Sim_Pin_getLecturas() - lecturas)/SEGUNDOS_MEDICION;
+}
+
+static void test_lecturas_en_reposo_sondeo_vs_interrupcion(void){
+    ejecuta(100);
+    uint32_t const sondeo = lecturasPorSegundoEnReposo();
+    TEST_ASSERT_TRUE(Pulsador_habilitaDespertar(&pulsador));
+    ejecuta(100);
+    uint32_t const interrupcion = lecturasPorSegundoEnReposo();
+    char mensaje[128];
+    snprintf(mensaje,sizeof(mensaje),"en reposo: %u lecturas por segundo con sondeo, %u con interrupcion",(unsigned)sondeo,(unsigned)interrupcion);
+    TEST_MESSAGE(mensaje);
+    TEST_ASSERT_EQUAL_UINT32(1000,sondeo);                          //Una lectura por milisegundo
+    TEST_ASSERT_EQUAL_UINT32(0,interrupcion);
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_sondeo_detecta_pulsacion);
+    RUN_TEST(test_interrupcion_detecta_pulsacion);
+    RUN_TEST(test_interrupcion_filtra_rebotes);
+    RUN_TEST(test_interrupcion_no_lee_el_pin_en_reposo);
+    RUN_TEST(test_lecturas_en_reposo_sondeo_vs_interrupcion);
+    UNITY_END();
+    return 0;
+}
@@ -0,0 +1,185 @@
+#include <pulsador_banco.h>
+#include <pulsador.h>
+#include <maquina_estado_impl.h>
+#include <soporte_placa_sim.h>
+#include <unity.h>
+#include <time.h>
+
+//Pruebas del banco de pulsadores con contadores verticales
+
+enum {EV_PULSADO = EV_USUARIO, HISTERESIS = 5, NUM_RECEPTORES = 14};
+
+/**
+ * @brief Pines del puerto B disponibles en la placa
+ */
+static SP_HPin const pines[NUM_RECEPTORES] = {
+    SP_PB0,SP_PB1,SP_PB3,SP_PB4,SP_PB5,SP_PB6,SP_PB7,
+    SP_PB8,SP_PB9,SP_PB10,SP_PB11,SP_PB12,SP_PB13,SP_PB14
+};
+
+typedef struct Receptor{
+    Maquina maquina;
+    unsigned pulsaciones;
+}Receptor;
+
+static Receptor receptores[NUM_RECEPTORES];
+static PulsadorBanco banco;
+
+static Resultado estadoCuenta(Maquina *contexto, Evento evento){
+    Receptor *const self = (Receptor*)contexto;
+    if (evento == EV_PULSADO) ++self->pulsaciones;
+    return Resultado_procesado();
+}
+
+static void ejecuta(uint32_t milisegundos){
+    for (uint32_t i=0;i<milisegundos;++i){
+        SP_Sim_Tiempo_avanza(1);
+        PulsadorBanco_procesa(&banco);
+        for (size_t j=0;j<NUM_RECEPTORES;++j){
+            while(Maquina_procesa(&receptores[j].maquina));
+        }
+    }
+}
+
+void setUp(void){
+    SP_Sim_reset();
+    for (size_t i=0;i<NUM_RECEPTORES;++i){
+        receptores[i] = (Receptor){0};
+        Maquina_init(&receptores[i].maquina,estadoCuenta);
+        Maquina_procesa(&receptores[i].maquina);
+    }
+    PulsadorBanco_init(&banco,SP_PUERTO_B,HISTERESIS);
+}
+void tearDown(void){
+
+}
+
+static void test_cada_linea_despacha_a_su_destino(void){
+    TEST_ASSERT_TRUE(PulsadorBanco_agregaPulsador(&banco,SP_PB9,0,&receptores[0].maquina,EV_PULSADO));
+    TEST_ASSERT_TRUE(PulsadorBanco_agregaPulsador(&banco,SP_PB12,1,&receptores[1].maquina,EV_PULSADO));
+    ejecuta(20);
+    SP_Sim_Pin_setEntrada(SP_PB9,0);
+    ejecuta(50);
+    SP_Sim_Pin_setEntrada(SP_PB9,1);
+    ejecuta(50);
+    TEST_ASSERT_EQUAL(1,receptores[0].pulsaciones);
+    TEST_ASSERT_EQUAL(0,receptores[1].pulsaciones);
+    SP_Sim_Pin_setEntrada(SP_PB12,1);
+    SP_Sim_Pin_setEntrada(SP_PB9,0);
+    ejecuta(50);
+    TEST_ASSERT_EQUAL(2,receptores[0].pulsaciones);
+    TEST_ASSERT_EQUAL(1,receptores[1].pulsaciones);
+}
+
+static void test_pin_de_otro_puerto_es_rechazado(void){
+    TEST_ASSERT_FALSE(PulsadorBanco_agregaPulsador(&banco,SP_PA0,0,&receptores[0].maquina,EV_PULSADO));
+    TEST_ASSERT_EQUAL_UINT16(0,banco.parametros.lineas);
+}
+
+static void test_cambia_luego_de_histeresis_lecturas(void){
+    PulsadorBanco_agregaPulsador(&banco,SP_PB9,0,&receptores[0].maquina,EV_PULSADO);
+    ejecuta(20);
+    SP_Sim_Pin_setEntrada(SP_PB9,0);
+    ejecuta(HISTERESIS - 1);
+    TEST_ASSERT_EQUAL(0,receptores[0].pulsaciones);
+    ejecuta(1);
+    TEST_ASSERT_EQUAL(1,receptores[0].pulsaciones);
+}
+
+static void test_filtra_rebotes(void){
+    PulsadorBanco_agregaPulsador(&banco,SP_PB9,0,&receptores[0].maquina,EV_PULSADO);
+    ejecuta(20);
+    for (size_t i=0;i<10;++i){
+        SP_Sim_Pin_setEntrada(SP_PB9,0);
+        ejecuta(HISTERESIS - 1);
+        SP_Sim_Pin_setEntrada(SP_PB9,1);
+        ejecuta(1);
+    }
+    TEST_ASSERT_EQUAL(0,receptores[0].pulsaciones);
+    SP_Sim_Pin_setEntrada(SP_PB9,0);
+    ejecuta(50);
+    SP_Sim_Pin_setEntrada(SP_PB9,1);
+    ejecuta(2);
+    SP_Sim_Pin_setEntrada(SP_PB9,0);
+    ejecuta(2);
+    SP_Sim_Pin_setEntrada(SP_PB9,1);
+    ejecuta(50);
+    TEST_ASSERT_EQUAL(1,receptores[0].pulsaciones);
+}
+
+static void test_todas_las_lineas_a_la_vez(void){
+    for (size_t i=0;i<NUM_RECEPTORES;++i){
+        TEST_ASSERT_TRUE(PulsadorBanco_agregaPulsador(&banco,pines[i],0,&receptores[i].maquina,EV_PULSADO));
+    }
+    ejecuta(20);
+    for (size_t i=0;i<NUM_RECEPTORES;++i) SP_Sim_Pin_setEntrada(pines[i],0);
+    ejecuta(50);
+    for (size_t i=0;i<NUM_RECEPTORES;++i){
+        TEST_ASSERT_EQUAL(1,receptores[i].pulsaciones);
+    }
+}
+
+/**
+ * @brief Mide el tiempo de procesar N pulsadores en reposo, con un
+ * banco o con objetos Pulsador independientes. El reloj simulado no
+ * avanza durante la medición: cada iteración invalida t0 para forzar
+ * la lectura, como si hubiera transcurrido un milisegundo
+ *
+ * @return double Nanosegundos por lectura (tick)
+ */
+static double costoPorTick(size_t N, bool conBanco){
+    enum {TICKS = 1000000, REPETICIONES = 3};
+    static Pulsador pulsadores[NUM_RECEPTORES];
+    if (conBanco){
+        PulsadorBanco_init(&banco,SP_PUERTO_B,HISTERESIS);
+        for (size_t i=0;i<N;++i) PulsadorBanco_agregaPulsador(&banco,pines[i],0,&receptores[i].maquina,EV_PULSADO);
+    }else{
+        for (size_t i=0;i<N;++i) Pulsador_init(&pulsadores[i],&receptores[i].maquina,EV_PULSADO,pines[i],0,HISTERESIS);
+    }
+    SP_Sim_Tiempo_avanza(1);
+    uint32_t const anterior = SP_Tiempo_getMilisegundos() - 1;
+    double minimo = 1e30;
+    for (size_t r=0;r<REPETICIONES;++r){
+        struct timespec t0,t1;
+        clock_gettime(CLOCK_MONOTONIC,&t0);
+        for (uint32_t i=0;i<TICKS;++i){
+            if (conBanco){
+                banco.t0 = anterior;
+                PulsadorBanco_procesa(&banco);
+            }else{
+                for (size_t j=0;j<N;++j){
+                    pulsadores[j].t0 = anterior;
+                    Pulsador_procesa(&pulsadores[j]);
+                }
+            }
+        }
+        clock_gettime(CLOCK_MONOTONIC,&t1);
+        double const ns = (t1.tv_sec - t0.tv_sec)*1e9 + (t1.tv_nsec - t0.tv_nsec);
+        if (ns < minimo) minimo = ns;
+    }
+    return minimo / TICKS;
+}
+
+static void test_costo_banco_vs_pulsadores(void){
+    static size_t const cantidades[] = {1,4,NUM_RECEPTORES};
+    for (size_t i=0;i<3;++i){
+        double const independientes = costoPorTick(cantidades[i],false);
+        double const conBanco = costoPorTick(cantidades[i],true);
+        char mensaje[128];
+        snprintf(mensaje,sizeof(mensaje),"%2u pulsadores: %.1f ns por tick con Pulsador, %.1f ns con PulsadorBanco",
+                 (unsigned)cantidades[i],independientes,conBanco);
+        TEST_MESSAGE(mensaje);
+    }
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_cada_linea_despacha_a_su_destino);
+    RUN_TEST(test_pin_de_otro_puerto_es_rechazado);
+    RUN_TEST(test_cambia_luego_de_histeresis_lecturas);
+    RUN_TEST(test_filtra_rebotes);
+    RUN_TEST(test_todas_las_lineas_a_la_vez);
+    RUN_TEST(test_costo_banco_vs_pulsadores);
+    UNITY_END();
+    return 0;
+}
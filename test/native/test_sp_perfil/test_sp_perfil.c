@@ -0,0 +1,115 @@
+#include <soporte_placa_sim.h>
+#include <maquina_estado_impl.h>
+#include <unity.h>
+#include <stdint.h>
+
+//Pruebas del perfil de duración (contador de ciclos simulado con clock_gettime; pio test -e native_perfilado)
+
+#if !SP_PERFILADO
+#error test_sp_perfil requiere SP_PERFILADO=1 (pio test -e native_perfilado)
+#endif
+
+enum {EV_PRUEBA = EV_USUARIO};
+
+static void espera(uint32_t nanosegundos){
+    uint32_t const inicio = SP_Perfil_getCuenta();
+    while (SP_Perfil_getCuenta() - inicio < nanosegundos);
+}
+
+static void funcionMedida(void){
+}
+
+static void otraFuncion(void){
+}
+
+void setUp(void){
+    SP_Sim_reset();
+}
+void tearDown(void){
+
+}
+
+static void test_tabla_vacia_al_iniciar(void){
+    SP_Perfil const *const perfil = SP_Perfil_get();
+    TEST_ASSERT_EQUAL(0,perfil->numFunciones);
+    TEST_ASSERT_EQUAL(0,perfil->descartadas);
+    TEST_ASSERT_EQUAL(1000,perfil->cuentasPorMicrosegundo);
+    TEST_ASSERT_NULL(SP_Perfil_busca(funcionMedida));
+}
+
+static void test_acumula_minimo_maximo_y_media(void){
+    uint32_t inicio = SP_Perfil_getCuenta();
+    espera(20000);
+    SP_Perfil_registra(funcionMedida,inicio);
+    inicio = SP_Perfil_getCuenta();
+    espera(60000);
+    SP_Perfil_registra(funcionMedida,inicio);
+    SP_PerfilEstadistica const *const e = SP_Perfil_busca(funcionMedida);
+    TEST_ASSERT_NOT_NULL(e);
+    TEST_ASSERT_EQUAL(2,e->llamadas);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(20000,e->minimo);
+    TEST_ASSERT_LESS_THAN_UINT32(60000,e->minimo);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(60000,e->maximo);
+    TEST_ASSERT_EQUAL_UINT64(e->minimo + e->maximo,e->total);
+    TEST_ASSERT_EQUAL_UINT32((e->minimo + e->maximo)/2,SP_Perfil_getMedia(e));
+}
+
+static void test_histograma_por_potencias_de_dos(void){
+    uint32_t const inicio = SP_Perfil_getCuenta();
+    espera(5000);
+    SP_Perfil_registra(funcionMedida,inicio);
+    SP_PerfilEstadistica const *const e = SP_Perfil_busca(funcionMedida);
+    unsigned intervalo = 0;
+    while (intervalo < SP_PERFIL_NUM_INTERVALOS - 1 && e->minimo >> intervalo) ++intervalo;
+    for (unsigned i=0;i<SP_PERFIL_NUM_INTERVALOS;++i){
+        TEST_ASSERT_EQUAL(i == intervalo,e->histograma[i]);
+    }
+}
+
+static void test_funciones_separadas(void){
+    SP_Perfil_registra(funcionMedida,SP_Perfil_getCuenta());
+    SP_Perfil_registra(otraFuncion,SP_Perfil_getCuenta());
+    SP_Perfil_registra(funcionMedida,SP_Perfil_getCuenta());
+    TEST_ASSERT_EQUAL(2,SP_Perfil_get()->numFunciones);
+    TEST_ASSERT_EQUAL(2,SP_Perfil_busca(funcionMedida)->llamadas);
+    TEST_ASSERT_EQUAL(1,SP_Perfil_busca(otraFuncion)->llamadas);
+}
+
+static void test_tabla_llena_descarta(void){
+    for (uintptr_t i=1;i<=SP_PERFIL_MAX_FUNCIONES + 1;++i){
+        SP_Perfil_registra((SP_PerfilFuncion)i,SP_Perfil_getCuenta());
+    }
+    TEST_ASSERT_EQUAL(SP_PERFIL_MAX_FUNCIONES,SP_Perfil_get()->numFunciones);
+    TEST_ASSERT_EQUAL(1,SP_Perfil_get()->descartadas);
+    TEST_ASSERT_NULL(SP_Perfil_busca((SP_PerfilFuncion)(uintptr_t)(SP_PERFIL_MAX_FUNCIONES + 1)));
+}
+
+static Resultado estadoLento(Maquina *contexto, Evento evento){
+    (void)contexto;
+    if (evento != EV_RESET) espera(10000);
+    return Resultado_procesado();
+}
+
+static void test_maquina_procesa_mide_el_estado(void){
+    Maquina maquina;
+    Maquina_init(&maquina,estadoLento);
+    Maquina_procesa(&maquina);
+    Maquina_despacha(&maquina,EV_PRUEBA);
+    Maquina_procesa(&maquina);
+    SP_PerfilEstadistica const *const e = SP_Perfil_busca((SP_PerfilFuncion)estadoLento);
+    TEST_ASSERT_NOT_NULL(e);
+    TEST_ASSERT_EQUAL(2,e->llamadas);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(10000,e->maximo);
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_tabla_vacia_al_iniciar);
+    RUN_TEST(test_acumula_minimo_maximo_y_media);
+    RUN_TEST(test_histograma_por_potencias_de_dos);
+    RUN_TEST(test_funciones_separadas);
+    RUN_TEST(test_tabla_llena_descarta);
+    RUN_TEST(test_maquina_procesa_mide_el_estado);
+    UNITY_END();
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include <soporte_placa_sim.h>
+#include <unity.h>
+#include <time.h>
+
+//Pruebas de la escritura de varios pines a la vez
+
+static SP_HPin const pinesB[] = {SP_PB8,SP_PB9,SP_PB10,SP_PB11,SP_PB12,SP_PB13,SP_PB14,SP_PB15};
+enum {NUM_PINES_B = sizeof(pinesB)/sizeof(*pinesB)};
+
+void setUp(void){
+    SP_Sim_reset();
+    for (size_t i=0;i<NUM_PINES_B;++i) SP_Pin_setModo(pinesB[i],SP_PIN_SALIDA);
+    SP_Pin_setModo(SP_PA0,SP_PIN_SALIDA);
+    SP_Pin_setModo(SP_PC13,SP_PIN_SALIDA);
+}
+void tearDown(void){
+
+}
+
+static void test_mascara_escribe_solo_las_lineas_indicadas(void){
+    SP_Puerto_writeMascara(SP_PUERTO_B,0xF000,0x5000);
+    uint32_t const escrituras = SP_Sim_Puerto_getEscrituras(SP_PUERTO_B);
+    SP_Puerto_writeMascara(SP_PUERTO_B,0x6000,0x2000);
+    TEST_ASSERT_EQUAL(escrituras + 1,SP_Sim_Puerto_getEscrituras(SP_PUERTO_B));
+    TEST_ASSERT_EQUAL_HEX16(0x3000,SP_Puerto_read(SP_PUERTO_B) & 0xF000);
+    TEST_ASSERT_TRUE(SP_Sim_Pin_getSalida(SP_PB12));
+    TEST_ASSERT_TRUE(SP_Sim_Pin_getSalida(SP_PB13));
+    TEST_ASSERT_FALSE(SP_Sim_Pin_getSalida(SP_PB14));
+}
+
+static void test_grupo_en_varios_puertos_un_almacenamiento_por_puerto(void){
+    static SP_HPin const pines[] = {SP_PB9,SP_PA0,SP_PB12,SP_PC13};
+    SP_GrupoPines grupo;
+    TEST_ASSERT_TRUE(SP_Pines_init(&grupo,pines,4));
+    uint32_t const a = SP_Sim_Puerto_getEscrituras(SP_PUERTO_A);
+    uint32_t const b = SP_Sim_Puerto_getEscrituras(SP_PUERTO_B);
+    uint32_t const c = SP_Sim_Puerto_getEscrituras(SP_PUERTO_C);
+    SP_Pines_write(&grupo,0b1101);
+    TEST_ASSERT_EQUAL(a + 1,SP_Sim_Puerto_getEscrituras(SP_PUERTO_A));
+    TEST_ASSERT_EQUAL(b + 1,SP_Sim_Puerto_getEscrituras(SP_PUERTO_B));
+    TEST_ASSERT_EQUAL(c + 1,SP_Sim_Puerto_getEscrituras(SP_PUERTO_C));
+    TEST_ASSERT_TRUE(SP_Sim_Pin_getSalida(SP_PB9));
+    TEST_ASSERT_FALSE(SP_Sim_Pin_getSalida(SP_PA0));
+    TEST_ASSERT_TRUE(SP_Sim_Pin_getSalida(SP_PB12));
+    TEST_ASSERT_TRUE(SP_Sim_Pin_getSalida(SP_PC13));
+    SP_Pines_write(&grupo,0b0010);
+    TEST_ASSERT_FALSE(SP_Sim_Pin_getSalida(SP_PB9));
+    TEST_ASSERT_TRUE(SP_Sim_Pin_getSalida(SP_PA0));
+    TEST_ASSERT_FALSE(SP_Sim_Pin_getSalida(SP_PB12));
+    TEST_ASSERT_FALSE(SP_Sim_Pin_getSalida(SP_PC13));
+}
+
+static void test_grupo_demasiado_grande(void){
+    SP_HPin pines[SP_GRUPO_MAX_PINES + 1] = {0};
+    SP_GrupoPines grupo;
+    TEST_ASSERT_FALSE(SP_Pines_init(&grupo,pines,SP_GRUPO_MAX_PINES + 1));
+}
+
+/**
+ * @brief Nanosegundos por escritura de los 8 pines con la función dada
+ */
+static double costo(void (*escribe)(SP_GrupoPines const *grupo, uint32_t valores), SP_GrupoPines const *grupo){
+    enum {ESCRITURAS = 1000000, REPETICIONES = 3};
+    double minimo = 1e30;
+    for (size_t r=0;r<REPETICIONES;++r){
+        struct timespec t0,t1;
+        clock_gettime(CLOCK_MONOTONIC,&t0);
+        for (uint32_t i=0;i<ESCRITURAS;++i) escribe(grupo,i);
+        clock_gettime(CLOCK_MONOTONIC,&t1);
+        double const ns = (t1.tv_sec - t0.tv_sec)*1e9 + (t1.tv_nsec - t0.tv_nsec);
+        if (ns < minimo) minimo = ns;
+    }
+    return minimo / ESCRITURAS;
+}
+
+static void escribePinAPin(SP_GrupoPines const *grupo, uint32_t valores){
+    (void)grupo;
+    for (size_t i=0;i<NUM_PINES_B;++i) SP_Pin_write(pinesB[i],(valores >> i) & 1);
+}
+
+static void escribeMascara(SP_GrupoPines const *grupo, uint32_t valores){
+    (void)grupo;
+    SP_Puerto_writeMascara(SP_PUERTO_B,0xFF00,(uint16_t)(valores << 8));
+}
+
+static void test_costo_frente_a_pin_a_pin(void){
+    SP_GrupoPines grupo;
+    SP_Pines_init(&grupo,pinesB,NUM_PINES_B);
+    uint32_t const antes = SP_Sim_Puerto_getEscrituras(SP_PUERTO_B);
+    escribePinAPin(&grupo,0xA5);
+    uint32_t const almacenamientosPinAPin = SP_Sim_Puerto_getEscrituras(SP_PUERTO_B) - antes;
+    TEST_ASSERT_EQUAL(NUM_PINES_B,almacenamientosPinAPin);
+    double const pinAPin = costo(escribePinAPin,&grupo);
+    double const conGrupo = costo(SP_Pines_write,&grupo);
+    double const conMascara = costo(escribeMascara,&grupo);
+    TEST_ASSERT_EQUAL_HEX16(0xFF00 & ((1000000 - 1) << 8),SP_Puerto_read(SP_PUERTO_B) & 0xFF00);
+    char mensaje[192];
+    snprintf(mensaje,sizeof(mensaje),"8 pines (simulado): %.1f ns pin a pin (8 almacenamientos), %.1f ns con SP_Pines_write, %.1f ns con SP_Puerto_writeMascara (1 almacenamiento)",
+             pinAPin,conGrupo,conMascara);
+    TEST_MESSAGE(mensaje);
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_mascara_escribe_solo_las_lineas_indicadas);
+    RUN_TEST(test_grupo_en_varios_puertos_un_almacenamiento_por_puerto);
+    RUN_TEST(test_grupo_demasiado_grande);
+    RUN_TEST(test_costo_frente_a_pin_a_pin);
+    UNITY_END();
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include <soporte_placa_sim.h>
+#include <sp_serie_buffer.h>
+#include <unity.h>
+#include <string.h>
+#include <time.h>
+
+//Pruebas de la transmisión serie con buffer circular (USART y DMA simulados)
+
+void setUp(void){
+    SP_Sim_reset();
+    SP_Serie_init(115200);
+}
+void tearDown(void){
+
+}
+
+static void test_escribe_sin_esperar_y_transmite_con_el_tiempo(void){
+    static char const mensaje[] = "luz encendida\r\n";
+    size_t const n = sizeof(mensaje) - 1;
+    TEST_ASSERT_EQUAL(n,SP_Serie_escribe(mensaje,n));
+    TEST_ASSERT_TRUE(SP_Serie_qOcupado());
+    TEST_ASSERT_EQUAL(0,SP_Serie_getTransmitidos());
+    SP_Sim_Tiempo_avanza(1);                            // 11 bytes por milisegundo a 115200 baudios
+    TEST_ASSERT_EQUAL(11,SP_Serie_getTransmitidos());
+    SP_Sim_Tiempo_avanza(1);
+    TEST_ASSERT_FALSE(SP_Serie_qOcupado());
+    char recibido[sizeof(mensaje)] = {0};
+    TEST_ASSERT_EQUAL(n,SP_Sim_Serie_leeTransmitidos(recibido,sizeof(recibido)));
+    TEST_ASSERT_EQUAL_STRING(mensaje,recibido);
+}
+
+static void test_buffer_lleno_descarta_el_excedente(void){
+    static uint8_t datos[SP_SERIE_TAM_BUFFER + 10];
+    TEST_ASSERT_EQUAL(SP_SERIE_TAM_BUFFER,SP_Serie_escribe(datos,sizeof(datos)));
+    TEST_ASSERT_EQUAL(0,SP_Serie_getLibre());
+    TEST_ASSERT_EQUAL(10,SP_Serie_getDescartados());
+    TEST_ASSERT_EQUAL(0,SP_Serie_escribe(datos,1));
+    TEST_ASSERT_EQUAL(11,SP_Serie_getDescartados());
+}
+
+static void test_datos_que_dan_la_vuelta_al_buffer(void){
+    uint8_t datos[SP_SERIE_TAM_BUFFER*3/4];
+    for (size_t i=0;i<sizeof(datos);++i) datos[i] = (uint8_t)i;
+    SP_Serie_escribe(datos,sizeof(datos));
+    SP_Sim_Tiempo_avanza(100);
+    uint8_t recibido[sizeof(datos)];
+    SP_Sim_Serie_leeTransmitidos(recibido,sizeof(recibido));
+    SP_Serie_escribe(datos,sizeof(datos));              // Cruza el final del buffer
+    SP_Sim_Tiempo_avanza(100);
+    memset(recibido,0,sizeof(recibido));
+    TEST_ASSERT_EQUAL(sizeof(datos),SP_Sim_Serie_leeTransmitidos(recibido,sizeof(recibido)));
+    TEST_ASSERT_EQUAL(0,memcmp(datos,recibido,sizeof(datos)));
+}
+
+static void test_tramo_termina_al_final_del_buffer(void){
+    uint8_t datos[SP_SERIE_TAM_BUFFER];
+    for (size_t i=0;i<sizeof(datos);++i) datos[i] = (uint8_t)i;
+    uint32_t n;
+    SP_Serie_escribe(datos,SP_SERIE_TAM_BUFFER - 4);
+    SP_SerieBuffer_tramo(&n);
+    TEST_ASSERT_EQUAL(SP_SERIE_TAM_BUFFER - 4,n);
+    SP_SerieBuffer_libera(n);
+    TEST_ASSERT_EQUAL(10,SP_Serie_escribe(datos,10));
+    uint8_t const *tramo = SP_SerieBuffer_tramo(&n);
+    TEST_ASSERT_EQUAL(4,n);                             // Hasta el final del buffer
+    TEST_ASSERT_EQUAL(0,memcmp(datos,tramo,n));
+    SP_SerieBuffer_libera(n);
+    tramo = SP_SerieBuffer_tramo(&n);
+    TEST_ASSERT_EQUAL(6,n);                             // El resto, desde el comienzo
+    TEST_ASSERT_EQUAL(0,memcmp(datos + 4,tramo,n));
+    SP_SerieBuffer_libera(n);
+    SP_SerieBuffer_tramo(&n);
+    TEST_ASSERT_EQUAL(0,n);
+    TEST_ASSERT_FALSE(SP_Serie_qOcupado());
+    TEST_ASSERT_EQUAL(SP_SERIE_TAM_BUFFER + 6,SP_Serie_getTransmitidos());
+}
+
+/**
+ * @brief Bytes por segundo de reloj virtual manteniendo el buffer lleno
+ */
+static uint32_t caudal(uint32_t baudios){
+    static uint8_t datos[SP_SERIE_TAM_BUFFER];
+    enum {DURACION_MS = 1000};
+    SP_Sim_reset();
+    SP_Serie_init(baudios);
+    for (uint32_t t=0;t<DURACION_MS;++t){
+        uint8_t descarte[SP_SERIE_TAM_BUFFER];
+        SP_Serie_escribe(datos,SP_Serie_getLibre());
+        SP_Sim_Tiempo_avanza(1);
+        while (SP_Sim_Serie_leeTransmitidos(descarte,sizeof(descarte)));
+    }
+    return SP_Serie_getTransmitidos()*1000UL/DURACION_MS;
+}
+
+static void test_caudal_segun_baudios(void){
+    uint32_t const lento = caudal(115200);
+    uint32_t const rapido = caudal(921600);
+    TEST_ASSERT_EQUAL(11520,lento);
+    TEST_ASSERT_EQUAL(92160,rapido);
+    double minimo = 1e30;
+    enum {ESCRITURAS = 1000000, REPETICIONES = 3};
+    static char const linea[16] = "t=0001234 ev=05\n";
+    for (size_t r=0;r<REPETICIONES;++r){
+        struct timespec t0,t1;
+        clock_gettime(CLOCK_MONOTONIC,&t0);
+        for (size_t i=0;i<ESCRITURAS;++i){
+            if (SP_Serie_getLibre() < sizeof(linea)) SP_Sim_Tiempo_avanza(1);
+            SP_Serie_escribe(linea,sizeof(linea));
+        }
+        clock_gettime(CLOCK_MONOTONIC,&t1);
+        double const ns = (t1.tv_sec - t0.tv_sec)*1e9 + (t1.tv_nsec - t0.tv_nsec);
+        if (ns < minimo) minimo = ns;
+    }
+    char mensaje[160];
+    snprintf(mensaje,sizeof(mensaje),"caudal: %lu bytes/s a 115200, %lu bytes/s a 921600; escribir 16 bytes: %.1f ns (incluye el reloj virtual)",
+             (unsigned long)lento,(unsigned long)rapido,minimo/ESCRITURAS);
+    TEST_MESSAGE(mensaje);
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_escribe_sin_esperar_y_transmite_con_el_tiempo);
+    RUN_TEST(test_buffer_lleno_descarta_el_excedente);
+    RUN_TEST(test_datos_que_dan_la_vuelta_al_buffer);
+    RUN_TEST(test_tramo_termina_al_final_del_buffer);
+    RUN_TEST(test_caudal_segun_baudios);
+    UNITY_END();
+    return 0;
+}
@@ -0,0 +1,318 @@
+#include <soporte_placa_sim.h>
+#include <unity.h>
+#include <time.h>
+
+//Pruebas de los contadores de 64 bits, de la resolución del tick y de los timeouts (reloj virtual)
+
+void setUp(void){
+    SP_Sim_reset();
+}
+void tearDown(void){
+
+}
+
+static void test_microsegundos_siguen_a_los_milisegundos(void){
+    SP_Sim_Tiempo_avanza(3);
+    TEST_ASSERT_EQUAL(3,SP_Tiempo_getMilisegundos());
+    TEST_ASSERT_EQUAL_UINT64(3,SP_Tiempo_getMilisegundos64());
+    TEST_ASSERT_EQUAL_UINT64(3000,SP_Tiempo_getMicrosegundos64());
+}
+
+static void test_cada_tick_suma_su_duracion(void){
+    for (unsigned i=1;i<SP_TIEMPO_TICKS_POR_MILISEGUNDO;++i){
+        SysTick_Handler();
+        TEST_ASSERT_EQUAL_UINT64(i*SP_TIEMPO_MICROSEGUNDOS_POR_TICK,SP_Tiempo_getMicrosegundos64());
+        TEST_ASSERT_EQUAL(0,SP_Tiempo_getMilisegundos());
+    }
+    SysTick_Handler();
+    TEST_ASSERT_EQUAL(1,SP_Tiempo_getMilisegundos());
+    TEST_ASSERT_EQUAL_UINT64(1000,SP_Tiempo_getMicrosegundos64());
+}
+
+static void test_contador_de_64_bits_pasa_los_49_dias(void){
+    uint64_t const vuelta = (uint64_t)UINT32_MAX + 1;
+    SP_Sim_Tiempo_setMilisegundos(vuelta - 2);
+    SP_Sim_Tiempo_avanza(3);
+    TEST_ASSERT_EQUAL_UINT64(vuelta + 1,SP_Tiempo_getMilisegundos64());
+    TEST_ASSERT_EQUAL(1,SP_Tiempo_getMilisegundos());
+    TEST_ASSERT_EQUAL_UINT64((vuelta + 1)*1000,SP_Tiempo_getMicrosegundos64());
+}
+
+static void marca(void volatile *param){
+    *(bool volatile *)param = true;
+}
+
+static void test_timeout_al_dar_la_vuelta(void){
+    bool volatile vencido = false;
+    SP_Sim_Tiempo_setMilisegundos(UINT32_MAX - 1);
+    TEST_ASSERT_TRUE(SP_Tiempo_addTimeout(5,marca,&vencido));
+    SP_Sim_Tiempo_avanza(4);
+    TEST_ASSERT_FALSE(vencido);
+    SP_Sim_Tiempo_avanza(1);
+    TEST_ASSERT_TRUE(vencido);
+    TEST_ASSERT_EQUAL(3,SP_Tiempo_getMilisegundos());
+}
+
+static void test_cancela_timeout(void){
+    bool volatile vencido = false;
+    SP_HTimeout const h = SP_Tiempo_addTimeout(5,marca,&vencido);
+    TEST_ASSERT_NOT_EQUAL(SP_TIMEOUT_NINGUNO,h);
+    SP_Sim_Tiempo_avanza(4);
+    TEST_ASSERT_TRUE(SP_Tiempo_cancelaTimeout(h));
+    TEST_ASSERT_FALSE(SP_Tiempo_cancelaTimeout(h));
+    SP_Sim_Tiempo_avanza(10);
+    TEST_ASSERT_FALSE(vencido);
+}
+
+static void test_handle_viejo_no_cancela_otro_timeout(void){
+    bool volatile primero = false;
+    bool volatile segundo = false;
+    SP_HTimeout const viejo = SP_Tiempo_addTimeout(1,marca,&primero);
+    SP_Sim_Tiempo_avanza(1);
+    TEST_ASSERT_TRUE(primero);
+    SP_HTimeout const nuevo = SP_Tiempo_addTimeout(1,marca,&segundo);  // Reutiliza el descriptor
+    TEST_ASSERT_NOT_EQUAL(viejo,nuevo);
+    TEST_ASSERT_FALSE(SP_Tiempo_cancelaTimeout(viejo));
+    SP_Sim_Tiempo_avanza(1);
+    TEST_ASSERT_TRUE(segundo);
+}
+
+typedef struct Registro{
+    uint32_t llamados;
+    uint32_t tiempos[8];
+}Registro;
+
+static void registra(void volatile *param){
+    Registro volatile *const r = param;
+    if (r->llamados < 8) r->tiempos[r->llamados] = SP_Tiempo_getMilisegundos();
+    ++r->llamados;
+}
+
+static void test_orden_de_vencimiento(void){
+    static uint32_t const tiempos[] = {30,10,20,10,5};
+    Registro volatile r = {0};
+    for (size_t i=0;i<5;++i) TEST_ASSERT_TRUE(SP_Tiempo_addTimeout(tiempos[i],registra,&r));
+    SP_Sim_Tiempo_avanza(30);
+    TEST_ASSERT_EQUAL(5,r.llamados);
+    static uint32_t const esperados[] = {5,10,10,20,30};
+    for (size_t i=0;i<5;++i) TEST_ASSERT_EQUAL(esperados[i],r.tiempos[i]);
+}
+
+static void test_orden_tras_cancelar_el_ultimo(void){
+    Registro volatile r = {0};
+    TEST_ASSERT_TRUE(SP_Tiempo_addTimeout(10,registra,&r));
+    SP_HTimeout const ultimo = SP_Tiempo_addTimeout(40,registra,&r);
+    TEST_ASSERT_TRUE(SP_Tiempo_cancelaTimeout(ultimo));
+    SP_Sim_Tiempo_avanza(4);
+    TEST_ASSERT_TRUE(SP_Tiempo_addTimeout(20,registra,&r));          // Va al final: vence en 24
+    TEST_ASSERT_TRUE(SP_Tiempo_addTimeout(15,registra,&r));          // Entre los dos: vence en 19
+    SP_Sim_Tiempo_avanza(30);
+    TEST_ASSERT_EQUAL(3,r.llamados);
+    TEST_ASSERT_EQUAL(10,r.tiempos[0]);
+    TEST_ASSERT_EQUAL(19,r.tiempos[1]);
+    TEST_ASSERT_EQUAL(24,r.tiempos[2]);
+}
+
+static void test_periodico(void){
+    Registro volatile r = {0};
+    SP_HTimeout const h = SP_Tiempo_addTimeoutPeriodico(3,5,registra,&r);
+    SP_Sim_Tiempo_avanza(20);
+    TEST_ASSERT_EQUAL(4,r.llamados);
+    TEST_ASSERT_EQUAL(3,r.tiempos[0]);
+    TEST_ASSERT_EQUAL(8,r.tiempos[1]);
+    TEST_ASSERT_EQUAL(18,r.tiempos[3]);
+    TEST_ASSERT_TRUE(SP_Tiempo_cancelaTimeout(h));
+    SP_Sim_Tiempo_avanza(20);
+    TEST_ASSERT_EQUAL(4,r.llamados);
+}
+
+static SP_HTimeout hAutocancelado;
+
+static void cuentaYSeCancela(void volatile *param){
+    uint32_t volatile *const cuenta = param;
+    if (++*cuenta == 3) SP_Tiempo_cancelaTimeout(hAutocancelado);
+}
+
+static void test_periodico_cancelado_desde_su_handler(void){
+    uint32_t volatile cuenta = 0;
+    hAutocancelado = SP_Tiempo_addTimeoutPeriodico(1,1,cuentaYSeCancela,&cuenta);
+    SP_Sim_Tiempo_avanza(10);
+    TEST_ASSERT_EQUAL(3,cuenta);
+}
+
+static void reprograma(void volatile *param){
+    SP_Tiempo_addTimeout(2,registra,param);
+}
+
+static void test_timeout_programado_desde_un_handler(void){
+    Registro volatile r = {0};
+    SP_Tiempo_addTimeout(3,reprograma,&r);
+    SP_Sim_Tiempo_avanza(10);
+    TEST_ASSERT_EQUAL(1,r.llamados);
+    TEST_ASSERT_EQUAL(5,r.tiempos[0]);
+}
+
+static void test_sin_tiempo_o_sin_recursos_falla(void){
+    bool volatile vencido = false;
+    TEST_ASSERT_EQUAL(SP_TIMEOUT_NINGUNO,SP_Tiempo_addTimeout(0,marca,&vencido));
+    TEST_ASSERT_EQUAL(SP_TIMEOUT_NINGUNO,SP_Tiempo_addTimeoutPeriodico(1,0,marca,&vencido));
+    uint32_t programados = 0;
+    while (SP_Tiempo_addTimeout(1000,marca,&vencido)) ++programados;
+    TEST_ASSERT_GREATER_THAN(0,programados);
+    TEST_ASSERT_EQUAL(SP_TIMEOUT_NINGUNO,SP_Tiempo_addTimeout(1,marca,&vencido));
+}
+
+/**
+ * @brief Vencimientos contados por cuenta, y si alguno se atendió con
+ * las interrupciones deshabilitadas
+ */
+typedef struct Vencimientos{
+    uint32_t cantidad;
+    bool conInterrupcionesDeshabilitadas;
+}Vencimientos;
+
+static void cuenta(void volatile *param){
+    Vencimientos volatile *const v = param;
+    ++v->cantidad;
+    if (!SP_Sim_qInterrupcionesHabilitadas()) v->conInterrupcionesDeshabilitadas = true;
+}
+
+static uint32_t nanosegundosDesde(struct timespec const *inicio){
+    struct timespec fin;
+    clock_gettime(CLOCK_MONOTONIC,&fin);
+    return (uint32_t)((fin.tv_sec - inicio->tv_sec)*1000000000LL + (fin.tv_nsec - inicio->tv_nsec));
+}
+
+/**
+ * @brief Peor caso medido en la PC: el tick más largo y la sección más
+ * larga con interrupciones deshabilitadas (incluye la medición de
+ * __disable_irq/__enable_irq del simulador)
+ */
+typedef struct PeorCaso{
+    uint32_t nanosegundosTick;
+    uint32_t nanosegundosBloqueado;
+}PeorCaso;
+
+static PeorCaso minimoPeorCaso(PeorCaso a, PeorCaso b){
+    return (PeorCaso){
+        .nanosegundosTick = (b.nanosegundosTick < a.nanosegundosTick) ? b.nanosegundosTick : a.nanosegundosTick,
+        .nanosegundosBloqueado = (b.nanosegundosBloqueado < a.nanosegundosBloqueado) ? b.nanosegundosBloqueado : a.nanosegundosBloqueado
+    };
+}
+
+enum {REPETICIONES_PEOR_CASO = 5}; // El peor caso es el mismo camino en cada repetición: el mínimo descarta las interrupciones del host
+
+/**
+ * @brief Llama a SysTick_Handler durante milisegundos ms y retorna el
+ * tick más largo y la sección crítica más larga
+ */
+static PeorCaso corre(uint32_t const milisegundos){
+    PeorCaso peor = {0};
+    SP_Sim_reiniciaBloqueos();
+    for (uint32_t i=0;i<milisegundos*SP_TIEMPO_TICKS_POR_MILISEGUNDO;++i){
+        struct timespec inicio;
+        clock_gettime(CLOCK_MONOTONIC,&inicio);
+        SysTick_Handler();
+        uint32_t const ns = nanosegundosDesde(&inicio);
+        if (ns > peor.nanosegundosTick) peor.nanosegundosTick = ns;
+    }
+    peor.nanosegundosBloqueado = SP_Sim_getBloqueos().nanosegundosMaximo;
+    return peor;
+}
+
+/**
+ * @brief n periódicos con el mismo período y la misma fase: un solo
+ * tick atiende los n vencimientos y reinserta los n
+ */
+static PeorCaso peorCasoVencenJuntos(uint32_t const n){
+    PeorCaso peor = {UINT32_MAX,UINT32_MAX};
+    for (size_t r=0;r<REPETICIONES_PEOR_CASO;++r){
+        SP_Sim_reset();
+        Vencimientos volatile v = {0};
+        for (uint32_t i=0;i<n;++i){
+            TEST_ASSERT_NOT_EQUAL(SP_TIMEOUT_NINGUNO,SP_Tiempo_addTimeoutPeriodico(1,1000,cuenta,&v));
+        }
+        peor = minimoPeorCaso(peor,corre(1));
+        TEST_ASSERT_EQUAL(n,v.cantidad);
+        TEST_ASSERT_FALSE(v.conInterrupcionesDeshabilitadas);
+    }
+    return peor;
+}
+
+/**
+ * @brief n periódicos de períodos n a 2n-1 ms: con el tiempo los
+ * vencimientos se mezclan y cada reinserción cae en cualquier lugar de
+ * la lista, recorriendo hasta la mitad con interrupciones deshabilitadas
+ */
+static PeorCaso peorCasoPeriodosDistintos(uint32_t const n){
+    uint32_t const milisegundos = (n < 64) ? 64*n : 8*n;
+    PeorCaso peor = {UINT32_MAX,UINT32_MAX};
+    for (size_t r=0;r<REPETICIONES_PEOR_CASO;++r){
+        SP_Sim_reset();
+        Vencimientos volatile v = {0};
+        uint32_t esperados = 0;
+        for (uint32_t i=0;i<n;++i){
+            TEST_ASSERT_NOT_EQUAL(SP_TIMEOUT_NINGUNO,SP_Tiempo_addTimeoutPeriodico(i + 1,n + i,cuenta,&v));
+            esperados += (milisegundos - (i + 1)) / (n + i) + 1;
+        }
+        peor = minimoPeorCaso(peor,corre(milisegundos));
+        TEST_ASSERT_EQUAL(esperados,v.cantidad);
+        TEST_ASSERT_FALSE(v.conInterrupcionesDeshabilitadas);
+    }
+    return peor;
+}
+
+/**
+ * @brief Sección crítica de SP_Tiempo_addTimeout cuando el nuevo vence
+ * en el medio de n-1 activos, el recorrido más largo de la inserción
+ */
+static uint32_t peorBloqueoAlProgramar(uint32_t const n){
+    uint32_t peor = UINT32_MAX;
+    for (size_t r=0;r<REPETICIONES_PEOR_CASO;++r){
+        SP_Sim_reset();
+        Vencimientos volatile v = {0};
+        for (uint32_t i=0;i+1<n;++i){
+            TEST_ASSERT_NOT_EQUAL(SP_TIMEOUT_NINGUNO,SP_Tiempo_addTimeout(1000 + i,cuenta,&v));
+        }
+        SP_Sim_reiniciaBloqueos();
+        TEST_ASSERT_NOT_EQUAL(SP_TIMEOUT_NINGUNO,SP_Tiempo_addTimeout(1000 + n/2,cuenta,&v));
+        uint32_t const ns = SP_Sim_getBloqueos().nanosegundosMaximo;
+        if (ns < peor) peor = ns;
+    }
+    return peor;
+}
+
+static void test_peor_tick_segun_timeouts_activos(void){
+    static uint32_t const activos[] = {4,32,256};
+    char mensaje[256];
+    for (size_t i=0;i<3;++i){
+        PeorCaso const juntos = peorCasoVencenJuntos(activos[i]);
+        PeorCaso const distintos = peorCasoPeriodosDistintos(activos[i]);
+        uint32_t const alProgramar = peorBloqueoAlProgramar(activos[i]);
+        snprintf(mensaje,sizeof(mensaje),"%3lu timeouts: peor tick %lu ns con todos venciendo juntos, %lu ns con períodos distintos; "
+                 "sección crítica más larga %lu ns en el tick, %lu ns al programar en el medio",
+                 (unsigned long)activos[i],(unsigned long)juntos.nanosegundosTick,(unsigned long)distintos.nanosegundosTick,
+                 (unsigned long)((juntos.nanosegundosBloqueado > distintos.nanosegundosBloqueado) ? juntos.nanosegundosBloqueado : distintos.nanosegundosBloqueado),
+                 (unsigned long)alProgramar);
+        TEST_MESSAGE(mensaje);
+    }
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_microsegundos_siguen_a_los_milisegundos);
+    RUN_TEST(test_cada_tick_suma_su_duracion);
+    RUN_TEST(test_contador_de_64_bits_pasa_los_49_dias);
+    RUN_TEST(test_timeout_al_dar_la_vuelta);
+    RUN_TEST(test_cancela_timeout);
+    RUN_TEST(test_handle_viejo_no_cancela_otro_timeout);
+    RUN_TEST(test_orden_de_vencimiento);
+    RUN_TEST(test_orden_tras_cancelar_el_ultimo);
+    RUN_TEST(test_periodico);
+    RUN_TEST(test_periodico_cancelado_desde_su_handler);
+    RUN_TEST(test_timeout_programado_desde_un_handler);
+    RUN_TEST(test_sin_tiempo_o_sin_recursos_falla);
+    RUN_TEST(test_peor_tick_segun_timeouts_activos);
+    UNITY_END();
+    return 0;
+}
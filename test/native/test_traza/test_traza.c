@@ -0,0 +1,131 @@
+#include <traza.h>
+#include <maquina_estado_impl.h>
+#include <soporte_placa_sim.h>
+#include <unity.h>
+#include <time.h>
+
+//Pruebas de la traza de eventos (pio test -e native_traza)
+
+#if !MAQUINA_TRAZA
+#error test_traza requiere MAQUINA_TRAZA=1 (pio test -e native_traza)
+#endif
+
+enum {EV_CAMBIA = EV_USUARIO, EV_QUEDA};
+
+static Maquina maquina;
+
+static Resultado estadoB(Maquina *contexto, Evento evento);
+
+static Resultado estadoA(Maquina *contexto, Evento evento){
+    (void)contexto;
+    Resultado r = Resultado_procesado();
+    if (evento == EV_CAMBIA){
+        r = Resultado_transicion(estadoB);
+    }
+    return r;
+}
+
+static Resultado estadoB(Maquina *contexto, Evento evento){
+    (void)contexto;
+    (void)evento;
+    return Resultado_procesado();
+}
+
+void setUp(void){
+    SP_Sim_reset();
+    Maquina_init(&maquina,estadoA);
+    while (Maquina_procesa(&maquina));
+    Traza_reinicia();
+}
+void tearDown(void){
+
+}
+
+static RegistroTraza const *registro(uint32_t i){
+    return Traza_get()->registros + i % TRAZA_CAPACIDAD;
+}
+
+static uint16_t identificador(void const *direccion){
+    return (uint16_t)(uintptr_t)direccion;
+}
+
+static uint16_t identificadorEstado(Estado estado){
+    return (uint16_t)(uintptr_t)estado;
+}
+
+static void test_despacho_y_proceso_con_transicion(void){
+    SP_Sim_Tiempo_avanza(7);
+    Maquina_despacha(&maquina,EV_CAMBIA);
+    Maquina_procesa(&maquina);
+    TEST_ASSERT_EQUAL(2,Traza_get()->escrituras);
+    TEST_ASSERT_EQUAL_UINT32(TRAZA_FIRMA,Traza_get()->firma);
+    TEST_ASSERT_EQUAL(TRAZA_DESPACHO,registro(0)->tipo);
+    TEST_ASSERT_EQUAL(EV_CAMBIA,registro(0)->evento);
+    TEST_ASSERT_EQUAL(identificador(&maquina),registro(0)->maquina);
+    TEST_ASSERT_EQUAL(7,registro(0)->tiempo);
+    TEST_ASSERT_EQUAL(TRAZA_PROCESO,registro(1)->tipo);
+    TEST_ASSERT_EQUAL(identificadorEstado(estadoA),registro(1)->estadoAnterior);
+    TEST_ASSERT_EQUAL(identificadorEstado(estadoB),registro(1)->estadoNuevo);
+}
+
+static void test_cola_llena_registra_descarte(void){
+    for (unsigned i=0;i<MAX_EV_COLA;++i){
+        TEST_ASSERT_TRUE(Maquina_despacha(&maquina,EV_QUEDA));
+    }
+    TEST_ASSERT_FALSE(Maquina_despacha(&maquina,EV_QUEDA));
+    TEST_ASSERT_EQUAL(MAX_EV_COLA + 1,Traza_get()->escrituras);
+    TEST_ASSERT_EQUAL(TRAZA_DESPACHO,registro(MAX_EV_COLA - 1)->tipo);
+    TEST_ASSERT_EQUAL(TRAZA_DESCARTE,registro(MAX_EV_COLA)->tipo);
+}
+
+static void test_anillo_sobrescribe_los_mas_antiguos(void){
+    for (unsigned i=0;i<TRAZA_CAPACIDAD + 5;++i){
+        Maquina_despacha(&maquina,EV_QUEDA);
+        Maquina_procesa(&maquina);
+    }
+    uint32_t const escrituras = Traza_get()->escrituras;
+    TEST_ASSERT_EQUAL(2*(TRAZA_CAPACIDAD + 5),escrituras);
+    TEST_ASSERT_EQUAL(TRAZA_PROCESO,registro(escrituras - 1)->tipo);
+    TEST_ASSERT_EQUAL(TRAZA_DESPACHO,registro(escrituras - 2)->tipo);
+}
+
+static void despachaDesdeTimeout(void volatile *param){
+    Maquina_despacha((Maquina*)param,EV_CAMBIA);
+}
+
+static void test_despacho_desde_interrupcion(void){
+    SP_Tiempo_addTimeout(3,despachaDesdeTimeout,&maquina);
+    SP_Sim_Tiempo_avanza(3);
+    TEST_ASSERT_EQUAL(1,Traza_get()->escrituras);
+    TEST_ASSERT_EQUAL(3,registro(0)->tiempo);
+    TEST_ASSERT_EQUAL(TRAZA_DESPACHO,registro(0)->tipo);
+}
+
+static void test_costo_por_registro(void){
+    enum {REGISTROS = 1000000, REPETICIONES = 3};
+    double minimo = 1e30;
+    for (size_t r=0;r<REPETICIONES;++r){
+        struct timespec t0,t1;
+        clock_gettime(CLOCK_MONOTONIC,&t0);
+        for (size_t i=0;i<REGISTROS;++i){
+            Traza_registra(&maquina,EV_QUEDA,TRAZA_PROCESO,estadoA,estadoB);
+        }
+        clock_gettime(CLOCK_MONOTONIC,&t1);
+        double const ns = (t1.tv_sec - t0.tv_sec)*1e9 + (t1.tv_nsec - t0.tv_nsec);
+        if (ns < minimo) minimo = ns;
+    }
+    char mensaje[80];
+    snprintf(mensaje,sizeof(mensaje),"traza: %.1f ns por registro",minimo/REGISTROS);
+    TEST_MESSAGE(mensaje);
+}
+
+int main(void){
+    UNITY_BEGIN();
+    RUN_TEST(test_despacho_y_proceso_con_transicion);
+    RUN_TEST(test_cola_llena_registra_descarte);
+    RUN_TEST(test_anillo_sobrescribe_los_mas_antiguos);
+    RUN_TEST(test_despacho_desde_interrupcion);
+    RUN_TEST(test_costo_por_registro);
+    UNITY_END();
+    return 0;
+}